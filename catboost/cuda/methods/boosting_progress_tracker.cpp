@@ -240,6 +240,8 @@ namespace NCatboostCuda {
 
     void TBoostingProgressTracker::MaybeSaveSnapshot(std::function<void(IOutputStream*)> saver) {
         if (IsTimeToSaveSnapshot()) {
+            // logs must be on disk before the snapshot they describe
+            Logger.Sync(/*durable*/ true);
             const auto snapshotBackup = OutputFiles.SnapshotFile + ".bak";
             TProgressHelper(GpuProgressLabel()).Write(snapshotBackup, [&](IOutputStream* out) {
                 NJson::TJsonArray processors;
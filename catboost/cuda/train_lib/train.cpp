@@ -480,7 +480,8 @@ namespace NCatboostCuda {
                     modelPtr)
                 .WithObjectsDataFrom(trainingData.Learn->ObjectsData)
                 .WithFeatureEstimators(trainingData.FeatureEstimators)
-                .WithMetrics(*metricsAndTimeHistory);
+                .WithMetrics(*metricsAndTimeHistory)
+                .WithCompactCtrTables(outputOptions.CompactCtrTables());
 
             if (dstModel) {
                 coreModelToFullModelConverter.Do(true, dstModel, localExecutor, &targetClassifiers);
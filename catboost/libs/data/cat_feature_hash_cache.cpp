@@ -0,0 +1,48 @@
+#include "cat_feature_hash_cache.h"
+
+#include <util/system/yassert.h>
+
+
+namespace NCB {
+
+    TCatFeatureHashCache::TCatFeatureHashCache(ui32 capacityLog2)
+        : Slots(size_t(1) << capacityLog2)
+        , SlotMask((size_t(1) << capacityLog2) - 1)
+        , MaxSize((size_t(1) << capacityLog2) / 2) // keep load factor low to make probe sequences short
+    {
+        Y_ASSERT(capacityLog2 > 0 && capacityLog2 < 32);
+        KeysData.reserve(MaxSize * 16);
+    }
+
+    void TCatFeatureHashCache::Insert(TStringBuf value, ui32 hashedValue) {
+        if (!Enabled || (Size == MaxSize) || (value.size() > MAX_CACHED_VALUE_SIZE)) {
+            return;
+        }
+        const ui64 keyHash = CalcKeyHash(value);
+        for (size_t slotIdx = keyHash & SlotMask, probe = 0;
+             probe < MAX_PROBE_COUNT;
+             ++probe, slotIdx = (slotIdx + 1) & SlotMask)
+        {
+            TSlot& slot = Slots[slotIdx];
+            if (slot.Size == EMPTY_SLOT_SIZE) {
+                slot.KeyHash = keyHash;
+                slot.Offset = KeysData.size();
+                slot.Size = value.size();
+                slot.HashedValue = hashedValue;
+                KeysData.insert(KeysData.end(), value.begin(), value.end());
+                ++Size;
+                return;
+            }
+        }
+        // probe sequence is too long - just don't cache this value
+    }
+
+    void TCatFeatureHashCache::CheckHitRate() {
+        if (Stats.GetHitRate() < MIN_HIT_RATE) {
+            Enabled = false;
+            TVector<TSlot>().swap(Slots);
+            TVector<char>().swap(KeysData);
+        }
+    }
+
+}
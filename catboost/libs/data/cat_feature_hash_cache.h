@@ -0,0 +1,140 @@
+#pragma once
+
+#include <catboost/libs/helpers/cache_stats.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
+#include <util/system/compiler.h>
+#include <util/system/types.h>
+
+#include <cstring>
+
+
+namespace NCB {
+
+    /* Small open-addressing cache of (string value -> CalcCatFeatureHash(value)) for one categorical
+     * feature column.
+     * It is intended for low-cardinality columns where the same values are repeated many times:
+     * a hit skips both hashing of the value and the lookup in the hash-to-string map (values are put
+     * into the cache only after they have been registered there).
+     * Columns with a low hit rate (high-cardinality ones) disable the cache after a few thousand lookups.
+     *
+     * Not thread-safe, use a separate instance per thread.
+     */
+    class TCatFeatureHashCache {
+    public:
+        static constexpr ui32 DEFAULT_CAPACITY_LOG2 = 10;
+        static constexpr size_t MAX_CACHED_VALUE_SIZE = 64;
+
+        // check hit rate after this number of lookups and disable the cache if it is too low
+        static constexpr ui64 LOOKUPS_BEFORE_HIT_RATE_CHECK = 4096;
+        static constexpr double MIN_HIT_RATE = 0.5;
+
+    public:
+        explicit TCatFeatureHashCache(ui32 capacityLog2 = DEFAULT_CAPACITY_LOG2);
+
+        // returns false if value is not in cache
+        bool TryGet(TStringBuf value, ui32* hashedValue) {
+            if (!Enabled) {
+                return false;
+            }
+            if (value.size() > MAX_CACHED_VALUE_SIZE) {
+                // never inserted
+                ++Stats.MissCount;
+                RegisterLookup();
+                return false;
+            }
+            const ui64 keyHash = CalcKeyHash(value);
+            for (size_t slotIdx = keyHash & SlotMask, probe = 0;
+                 probe < MAX_PROBE_COUNT;
+                 ++probe, slotIdx = (slotIdx + 1) & SlotMask)
+            {
+                const TSlot& slot = Slots[slotIdx];
+                if (slot.Size == EMPTY_SLOT_SIZE) {
+                    break;
+                }
+                if ((slot.KeyHash == keyHash) && (slot.Size == value.size())
+                    && (memcmp(KeysData.data() + slot.Offset, value.data(), value.size()) == 0))
+                {
+                    ++Stats.HitCount;
+                    *hashedValue = slot.HashedValue;
+                    RegisterLookup();
+                    return true;
+                }
+            }
+            ++Stats.MissCount;
+            RegisterLookup();
+            return false;
+        }
+
+        // insertion is silently skipped if the cache is disabled, full or value is too long
+        void Insert(TStringBuf value, ui32 hashedValue);
+
+        bool IsEnabled() const {
+            return Enabled;
+        }
+
+        const TCacheStats& GetStats() const {
+            return Stats;
+        }
+
+    private:
+        static constexpr ui32 EMPTY_SLOT_SIZE = Max<ui32>();
+        static constexpr size_t MAX_PROBE_COUNT = 8;
+
+        struct TSlot {
+            ui64 KeyHash = 0;
+            ui32 Offset = 0;
+            ui32 Size = EMPTY_SLOT_SIZE;
+            ui32 HashedValue = 0;
+        };
+
+    private:
+        /* Cheaper than CalcCatFeatureHash, used only to select slot and to reject mismatches quickly.
+         * Hashes the whole value (at most MAX_CACHED_VALUE_SIZE bytes) word by word, so values that
+         * differ only in the middle do not share a probe sequence.
+         */
+        static ui64 CalcKeyHash(TStringBuf value) {
+            const size_t size = value.size();
+            const char* data = value.data();
+            ui64 result = size;
+            if (size >= sizeof(ui64)) {
+                ui64 word;
+                for (size_t offset = 0; offset + sizeof(ui64) < size; offset += sizeof(ui64)) {
+                    memcpy(&word, data + offset, sizeof(ui64));
+                    result = (result ^ word) * 0xC2B2AE3D27D4EB4FULL;
+                    result ^= result >> 32; // multiplication alone does not move high bits down to the slot bits
+                }
+                // last word, may overlap the previous one
+                memcpy(&word, data + size - sizeof(ui64), sizeof(ui64));
+                result ^= (word << 29) | (word >> 35);
+            } else {
+                for (size_t i = 0; i < size; ++i) {
+                    result = (result << 8) | (ui8)data[i];
+                }
+            }
+            result *= 0x9E3779B97F4A7C15ULL;
+            return result ^ (result >> 32);
+        }
+
+        // hit rate is checked exactly once, when the lookup count reaches LOOKUPS_BEFORE_HIT_RATE_CHECK
+        void RegisterLookup() {
+            if (Y_UNLIKELY(Stats.HitCount + Stats.MissCount == LOOKUPS_BEFORE_HIT_RATE_CHECK)) {
+                CheckHitRate();
+            }
+        }
+
+        void CheckHitRate();
+
+    private:
+        TVector<TSlot> Slots;
+        size_t SlotMask;
+        size_t MaxSize;
+        size_t Size = 0;
+        TVector<char> KeysData;
+        bool Enabled = true;
+        TCacheStats Stats;
+    };
+
+}
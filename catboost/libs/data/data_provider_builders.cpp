@@ -1,5 +1,6 @@
 #include "data_provider_builders.h"
 
+#include "cat_feature_hash_cache.h"
 #include "cat_feature_perfect_hash.h"
 #include "columns.h"
 #include "data_provider.h"
@@ -36,6 +37,7 @@
 #include <util/system/yassert.h>
 
 #include <algorithm>
+#include <array>
 
 
 namespace NCB {
@@ -245,17 +247,27 @@ namespace NCB {
 
         ui32 GetCatFeatureValue(ui32 flatFeatureIdx, TStringBuf feature) override {
             auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
-            ui32 hashVal = CalcCatFeatureHash(feature);
             size_t hashPartIdx = (size_t)LocalExecutor->GetWorkerThreadId();
             CheckThreadId(hashPartIdx, HashMapParts.size());
-            auto& catFeatureHashes = HashMapParts[hashPartIdx].CatFeatureHashes;
-            catFeatureHashes.resize(CatFeatureCount);
-            auto& catFeatureHash = catFeatureHashes[*catFeatureIdx];
+            auto& hashPart = HashMapParts[hashPartIdx];
+            hashPart.CatFeatureHashes.resize(CatFeatureCount);
+            hashPart.CatFeatureHashCaches.resize(CatFeatureCount);
+
+            // repeated values of low-cardinality features are already registered in catFeatureHash
+            auto& hashCache = hashPart.CatFeatureHashCaches[*catFeatureIdx];
+            ui32 hashVal;
+            if (hashCache.TryGet(feature, &hashVal)) {
+                return hashVal;
+            }
+
+            hashVal = CalcCatFeatureHash(feature);
+            auto& catFeatureHash = hashPart.CatFeatureHashes[*catFeatureIdx];
 
             THashMap<ui32, TString>::insert_ctx insertCtx;
             if (!catFeatureHash.contains(hashVal, insertCtx)) {
                 catFeatureHash.emplace_direct(insertCtx, hashVal, feature);
             }
+            hashCache.Insert(feature, hashVal);
             return hashVal;
         }
         void AddCatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
@@ -498,6 +510,7 @@ namespace NCB {
             if (CatFeatureCount) {
                 auto& catFeaturesHashToString = *Data.CommonObjectsData.CatFeaturesHashToString;
                 catFeaturesHashToString.resize(CatFeatureCount);
+                TCacheStats hashCacheStats;
                 for (const auto& part : HashMapParts) {
                     if (part.CatFeatureHashes.empty()) {
                         continue;
@@ -507,8 +520,12 @@ namespace NCB {
                             part.CatFeatureHashes[catFeatureIdx].begin(),
                             part.CatFeatureHashes[catFeatureIdx].end()
                         );
+                        hashCacheStats += part.CatFeatureHashCaches[catFeatureIdx].GetStats();
                     }
                 }
+                CATBOOST_DEBUG_LOG << "Categorical features hash cache: hits " << hashCacheStats.HitCount
+                    << ", misses " << hashCacheStats.MissCount
+                    << ", hit rate " << hashCacheStats.GetHitRate() << Endl;
             }
 
             getFeaturesResult(TextFeaturesStorage, &Data.ObjectsData.TextFeatures);
@@ -637,6 +654,7 @@ namespace NCB {
     private:
         struct THashPart {
             TVector<THashMap<ui32, TString>> CatFeatureHashes;
+            TVector<TCatFeatureHashCache> CatFeatureHashCaches;
         };
 
         template <EFeatureType FeatureType, class T>
@@ -1509,9 +1527,15 @@ namespace NCB {
                     TIndexRange<ui32> subRange = indexRanges.GetRange((ui32)subRangeIdx);
                     auto blockIterator = stringValues.GetBlockIterator(subRange);
                     ui32 objectIdx = subRange.Begin;
+                    TCatFeatureHashCache hashCache;
                     while (auto block = blockIterator->Next()) {
                         for (auto stringValue : block) {
-                            hashedCatValuesRef[objectIdx++] = CalcCatFeatureHash(stringValue);
+                            ui32 hashedValue;
+                            if (!hashCache.TryGet(stringValue, &hashedValue)) {
+                                hashedValue = CalcCatFeatureHash(stringValue);
+                                hashCache.Insert(stringValue, hashedValue);
+                            }
+                            hashedCatValuesRef[objectIdx++] = hashedValue;
                         }
                     }
                 },
@@ -1522,14 +1546,28 @@ namespace NCB {
 
             auto& catFeatureHash = (*Data.CommonObjectsData.CatFeaturesHashToString)[*catFeatureIdx];
 
+            /* direct-mapped filter of already registered hashed values to skip catFeatureHash lookups
+             * for repeated values.
+             * Slot i is initialized with (i ^ 1) that can never be stored in it so there're no false hits.
+             */
+            constexpr ui32 REGISTERED_FILTER_SIZE = 1024;
+            std::array<ui32, REGISTERED_FILTER_SIZE> registeredFilter;
+            for (auto i : xrange(REGISTERED_FILTER_SIZE)) {
+                registeredFilter[i] = i ^ 1;
+            }
+
             auto blockIterator = stringValues.GetBlockIterator();
             ui32 objectIdx = 0;
             while (auto block = blockIterator->Next()) {
                 for (auto stringValue : block) {
                     const ui32 hashedValue = hashedCatValues[objectIdx];
-                    THashMap<ui32, TString>::insert_ctx insertCtx;
-                    if (!catFeatureHash.contains(hashedValue, insertCtx)) {
-                        catFeatureHash.emplace_direct(insertCtx, hashedValue, stringValue);
+                    ui32& filterSlot = registeredFilter[hashedValue & (REGISTERED_FILTER_SIZE - 1)];
+                    if (filterSlot != hashedValue) {
+                        THashMap<ui32, TString>::insert_ctx insertCtx;
+                        if (!catFeatureHash.contains(hashedValue, insertCtx)) {
+                            catFeatureHash.emplace_direct(insertCtx, hashedValue, stringValue);
+                        }
+                        filterSlot = hashedValue;
                     }
                     ++objectIdx;
                 }
@@ -720,10 +720,6 @@ static void GetSubsetWithScheduling(
             {
                 srcDataPtr->EstimateMemoryForCloning(cloningParams),
                 [srcDataPtr, dstHolderPtr, localExecutor, cloningParams] () {
-                    auto clonedColumn = srcDataPtr->CloneWithNewSubsetIndexing(
-                        cloningParams,
-                        localExecutor
-                    );
                     *dstHolderPtr = DynamicHolderCast<TColumn>(
                         srcDataPtr->CloneWithNewSubsetIndexing(
                             cloningParams,
@@ -0,0 +1,99 @@
+#include <catboost/libs/data/cat_feature_hash_cache.h>
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TCatFeatureHashCache) {
+    Y_UNIT_TEST(LowCardinality) {
+        TVector<TString> values = {"", "a", "ru", "country_1", "country_2", "some long device name"};
+
+        TCatFeatureHashCache cache;
+        for (auto iteration : xrange(100)) {
+            for (const auto& value : values) {
+                ui32 hashedValue = 0;
+                if (cache.TryGet(value, &hashedValue)) {
+                    UNIT_ASSERT(iteration > 0);
+                } else {
+                    UNIT_ASSERT_VALUES_EQUAL(iteration, 0);
+                    hashedValue = CalcCatFeatureHash(value);
+                    cache.Insert(value, hashedValue);
+                }
+                UNIT_ASSERT_VALUES_EQUAL(hashedValue, CalcCatFeatureHash(value));
+            }
+        }
+        UNIT_ASSERT(cache.IsEnabled());
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetStats().MissCount, values.size());
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetStats().HitCount, 99 * values.size());
+    }
+
+    Y_UNIT_TEST(DistinguishSimilarValues) {
+        // same size, same first and last 8 bytes, differ only in the middle
+        TVector<TString> values;
+        for (auto i : xrange(100)) {
+            values.push_back("long_prefix_" + ToString(1000 + i) + "_long_suffix");
+        }
+
+        TCatFeatureHashCache cache;
+        for (const auto& value : values) {
+            ui32 hashedValue = 0;
+            UNIT_ASSERT(!cache.TryGet(value, &hashedValue));
+            cache.Insert(value, CalcCatFeatureHash(value));
+        }
+        // all values are cached, not just the first probe sequence of them
+        for (const auto& value : values) {
+            ui32 hashedValue = 0;
+            UNIT_ASSERT(cache.TryGet(value, &hashedValue));
+            UNIT_ASSERT_VALUES_EQUAL(hashedValue, CalcCatFeatureHash(value));
+        }
+    }
+
+    Y_UNIT_TEST(LongValuesAreNotCached) {
+        const TString value(TCatFeatureHashCache::MAX_CACHED_VALUE_SIZE + 1, 'a');
+
+        TCatFeatureHashCache cache;
+        cache.Insert(value, CalcCatFeatureHash(value));
+        ui32 hashedValue = 0;
+        UNIT_ASSERT(!cache.TryGet(value, &hashedValue));
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetStats().MissCount, 1);
+    }
+
+    Y_UNIT_TEST(HighCardinalityDisablesCache) {
+        TCatFeatureHashCache cache(/*capacityLog2*/ 4);
+        for (auto i : xrange(2 * TCatFeatureHashCache::LOOKUPS_BEFORE_HIT_RATE_CHECK)) {
+            const TString value = ToString(i);
+            ui32 hashedValue = 0;
+            if (!cache.TryGet(value, &hashedValue)) {
+                cache.Insert(value, CalcCatFeatureHash(value));
+            }
+        }
+        UNIT_ASSERT(!cache.IsEnabled());
+        UNIT_ASSERT_VALUES_EQUAL(cache.GetStats().HitCount, 0);
+    }
+
+    Y_UNIT_TEST(HitRateIsCheckedWhenCheckLookupIsHit) {
+        TCatFeatureHashCache cache(/*capacityLog2*/ 4);
+        const TString cachedValue = "cached";
+        cache.Insert(cachedValue, CalcCatFeatureHash(cachedValue));
+        ui32 hashedValue = 0;
+        for (auto i : xrange(TCatFeatureHashCache::LOOKUPS_BEFORE_HIT_RATE_CHECK - 1)) {
+            UNIT_ASSERT(!cache.TryGet(ToString(i), &hashedValue));
+        }
+        UNIT_ASSERT(cache.IsEnabled());
+
+        // the lookup that triggers the check is a hit
+        UNIT_ASSERT(cache.TryGet(cachedValue, &hashedValue));
+        UNIT_ASSERT_VALUES_EQUAL(hashedValue, CalcCatFeatureHash(cachedValue));
+        UNIT_ASSERT(!cache.IsEnabled());
+        UNIT_ASSERT(!cache.TryGet(cachedValue, &hashedValue));
+    }
+}
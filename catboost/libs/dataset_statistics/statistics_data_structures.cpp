@@ -3,7 +3,12 @@
 #include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/helpers/json_helpers.h>
 
+#include <util/digest/numeric.h>
+#include <util/generic/bitops.h>
+#include <util/generic/xrange.h>
+
 #include <algorithm>
+#include <cmath>
 
 using namespace NCB;
 
@@ -329,6 +334,10 @@ NJson::TJsonValue TTextFeatureStatistics::ToJson() const {
 }
 
 void TTextFeatureStatistics::Update(const TTextFeatureStatistics& update) {
+    // parts that have not seen any objects carry no values
+    if (!update.Example.Defined()) {
+        return;
+    }
     with_lock(Mutex) {
         if (!Example.Defined()) {
             Example = update.Example;
@@ -341,9 +350,37 @@ void TTextFeatureStatistics::Update(const TTextFeatureStatistics& update) {
     }
 }
 
+void TCatFeatureStatistics::SwitchToSketch() {
+    HllRegisters.assign(size_t(1) << HLL_PRECISION, 0);
+    for (ui32 value : ImperfectHashSet) {
+        AddToSketch(value);
+    }
+    ImperfectHashSet.clear();
+}
+
+void TCatFeatureStatistics::AddToSketch(ui32 value) {
+    // values are hashes already, but their low bits are not uniform enough for HyperLogLog
+    const ui64 hash = IntHash<ui64>(value);
+    const size_t registerIdx = hash >> (64 - HLL_PRECISION);
+    const ui64 rest = (hash << HLL_PRECISION) | (ui64(1) << (HLL_PRECISION - 1));
+    const ui8 rank = 64 - GetValueBitCount(rest) + 1;
+    HllRegisters[registerIdx] = Max(HllRegisters[registerIdx], rank);
+}
+
+void TCatFeatureStatistics::UpdateUnlocked(ui32 value) {
+    if (!IsExact()) {
+        AddToSketch(value);
+        return;
+    }
+    ImperfectHashSet.insert(value);
+    if (ImperfectHashSet.size() > MAX_EXACT_VALUE_COUNT) {
+        SwitchToSketch();
+    }
+}
+
 void TCatFeatureStatistics::Update(ui32 value) {
     with_lock(Mutex) {
-        ImperfectHashSet.insert(value);
+        UpdateUnlocked(value);
     }
 }
 
@@ -351,14 +388,50 @@ void TCatFeatureStatistics::Update(TStringBuf value) {
     Update(CalcCatFeatureHash(value));
 }
 
+ui64 TCatFeatureStatistics::GetValueCount() const {
+    if (IsExact()) {
+        return ImperfectHashSet.size();
+    }
+    const double registerCount = HllRegisters.size();
+    double inverseSum = 0;
+    size_t zeroRegisterCount = 0;
+    for (ui8 rank : HllRegisters) {
+        inverseSum += std::ldexp(1.0, -int(rank));
+        zeroRegisterCount += (rank == 0);
+    }
+    const double alpha = 0.7213 / (1 + 1.079 / registerCount);
+    double estimate = alpha * registerCount * registerCount / inverseSum;
+    if (estimate <= 2.5 * registerCount && zeroRegisterCount > 0) {
+        // linear counting for small cardinalities
+        estimate = registerCount * std::log(registerCount / zeroRegisterCount);
+    }
+    return static_cast<ui64>(std::llround(estimate));
+}
+
 NJson::TJsonValue TCatFeatureStatistics::ToJson() const {
     NJson::TJsonValue result;
-    result.InsertValue("CatFeatureCount", ImperfectHashSet.size());
+    result.InsertValue("CatFeatureCount", GetValueCount());
+    if (!IsExact()) {
+        result.InsertValue("IsCatFeatureCountApproximate", true);
+    }
     return result;
 }
 
 void TCatFeatureStatistics::Update(const TCatFeatureStatistics& update) {
-    ImperfectHashSet.insert(update.ImperfectHashSet.begin(), update.ImperfectHashSet.end());
+    with_lock(Mutex) {
+        if (!update.IsExact()) {
+            if (IsExact()) {
+                SwitchToSketch();
+            }
+            for (auto registerIdx : xrange(HllRegisters.size())) {
+                HllRegisters[registerIdx] = Max(HllRegisters[registerIdx], update.HllRegisters[registerIdx]);
+            }
+            return;
+        }
+        for (ui32 value : update.ImperfectHashSet) {
+            UpdateUnlocked(value);
+        }
+    }
 }
 
 void TFeatureStatistics::Init(
@@ -157,17 +157,26 @@ private:
 };
 
 
+/* Count of distinct values of categorical feature.
+ * Values are counted exactly until there are more than MAX_EXACT_VALUE_COUNT of them,
+ * then the statistics switches to HyperLogLog sketch of cardinality, so memory is bounded
+ * and statistics collected in different threads or hosts can be merged.
+ */
 struct TCatFeatureStatistics: public IStatistics {
+    static constexpr size_t MAX_EXACT_VALUE_COUNT = 1 << 10;
+    static constexpr ui32 HLL_PRECISION = 14; // 2^14 registers, standard error is about 0.8%
+
     TCatFeatureStatistics(TCatFeatureStatistics&&) noexcept = default;
 
     TCatFeatureStatistics() = default;
 
     TCatFeatureStatistics(const TCatFeatureStatistics& a)
         : ImperfectHashSet(a.ImperfectHashSet)
+        , HllRegisters(a.HllRegisters)
     {}
 
     bool operator==(const TCatFeatureStatistics& rhs) const {
-        return ImperfectHashSet == rhs.ImperfectHashSet;
+        return std::tie(ImperfectHashSet, HllRegisters) == std::tie(rhs.ImperfectHashSet, rhs.HllRegisters);
     }
 
     void Update(TStringBuf value);
@@ -177,12 +186,25 @@ struct TCatFeatureStatistics: public IStatistics {
 
     void Update(const TCatFeatureStatistics& update);
 
-    Y_SAVELOAD_DEFINE(ImperfectHashSet);
+    bool IsExact() const {
+        return HllRegisters.empty();
+    }
+
+    // exact if IsExact(), HyperLogLog estimate otherwise
+    ui64 GetValueCount() const;
 
-    SAVELOAD(ImperfectHashSet);
+    Y_SAVELOAD_DEFINE(ImperfectHashSet, HllRegisters);
+
+    SAVELOAD(ImperfectHashSet, HllRegisters);
+
+private:
+    void UpdateUnlocked(ui32 value);
+    void SwitchToSketch();
+    void AddToSketch(ui32 value);
 
 public:
     TSet<ui32> ImperfectHashSet;
+    TVector<ui8> HllRegisters; // [1 << HLL_PRECISION] if values are not counted exactly
 
 private:
     TMutex Mutex;
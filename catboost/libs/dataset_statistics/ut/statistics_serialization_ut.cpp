@@ -60,4 +60,60 @@ Y_UNIT_TEST_SUITE(TStatisticsSerialization) {
         }
         DoSerializeDeserialize(item);
     }
+
+    Y_UNIT_TEST(TestCatFeatureStatistics) {
+        const ui32 exactCount = TCatFeatureStatistics::MAX_EXACT_VALUE_COUNT;
+        TCatFeatureStatistics first;
+        TCatFeatureStatistics second;
+        for (ui32 value = 0; value < exactCount; ++value) {
+            first.Update(value);
+            second.Update(value + exactCount / 2);
+        }
+        UNIT_ASSERT(first.IsExact());
+        UNIT_ASSERT_VALUES_EQUAL(first.GetValueCount(), exactCount);
+        DoSerializeDeserialize(first);
+
+        // exact set overflows during merge
+        first.Update(second);
+        UNIT_ASSERT(!first.IsExact());
+        const double mergedCount = exactCount * 3 / 2;
+        UNIT_ASSERT_DOUBLES_EQUAL(first.GetValueCount(), mergedCount, mergedCount * 0.05);
+        DoSerializeDeserialize(first);
+
+        TCatFeatureStatistics large;
+        const ui32 largeCount = 100000;
+        for (ui32 value = 0; value < largeCount; ++value) {
+            large.Update(value * 7919);
+        }
+        UNIT_ASSERT(!large.IsExact());
+        UNIT_ASSERT_DOUBLES_EQUAL(large.GetValueCount(), largeCount, largeCount * 0.05);
+
+        // merging of sketches is idempotent
+        TCatFeatureStatistics largeCopy(large);
+        large.Update(largeCopy);
+        UNIT_ASSERT_EQUAL(large, largeCopy);
+        DoSerializeDeserialize(large);
+    }
+
+    Y_UNIT_TEST(TestTextFeatureStatisticsMerge) {
+        // thread parts that have seen no objects are merged as well
+        TTextFeatureStatistics empty;
+        TTextFeatureStatistics filled;
+        filled.Update(TStringBuf("a"));
+        TTextFeatureStatistics filledCopy(filled);
+
+        filled.Update(empty);
+        UNIT_ASSERT_EQUAL(filled, filledCopy);
+
+        empty.Update(filled);
+        UNIT_ASSERT_EQUAL(empty, filledCopy);
+
+        TTextFeatureStatistics other;
+        other.Update(TStringBuf("b"));
+        filled.Update(other);
+        UNIT_ASSERT(!filled.IsConst);
+        filled.Update(TTextFeatureStatistics());
+        UNIT_ASSERT(!filled.IsConst);
+        DoSerializeDeserialize(filled);
+    }
 }
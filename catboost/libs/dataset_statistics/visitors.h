@@ -10,7 +10,9 @@
 #include <library/cpp/json/writer/json_value.h>
 
 #include <util/digest/numeric.h>
+#include <util/generic/ptr.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/stream/fwd.h>
 
 
@@ -21,7 +23,7 @@ public:
     TDatasetStatisticsFullVisitor(
         const TDataProviderBuilderOptions& options,
         bool isLocal,
-        NPar::ILocalExecutor* /*localExecutor*/
+        NPar::ILocalExecutor* localExecutor
     )
         : InBlock(false)
         , ObjectCount(0)
@@ -30,6 +32,7 @@ public:
         , InProcess(false)
         , ResultTaken(false)
         , IsLocal(isLocal)
+        , LocalExecutor(localExecutor)
     {}
 
     void SetCustomBorders(
@@ -77,6 +80,16 @@ public:
         DatasetStatistics.Init(MetaInfo, CustomBorders, TargetCustomBorders);
 //        MetaInfo.TargetType = ERawTargetType::String;
         FloatTarget.resize(metaInfo.TargetCount);
+
+        const int threadCount = LocalExecutor ? LocalExecutor->GetThreadCount() + 1 : 0;
+        ThreadParts.clear();
+        for (auto threadId : xrange(threadCount)) {
+            Y_UNUSED(threadId);
+            ThreadParts.push_back(MakeHolder<TThreadPart>());
+            ThreadParts.back()->Statistics.FeatureStatistics.Init(MetaInfo, CustomBorders);
+            ThreadParts.back()->Statistics.TargetsStatistics.Init(MetaInfo, TargetCustomBorders);
+            ThreadParts.back()->FloatTarget.resize(metaInfo.TargetCount);
+        }
     }
 
     void StartNextBlock(ui32 blockSize) override {
@@ -104,21 +117,21 @@ public:
         Y_UNUSED(localObjectIdx, value);
     }
     void AddSampleId(ui32 localObjectIdx, const TString& value) override {
-        DatasetStatistics.SampleIdStatistics.Update(value);
+        GetThreadStatistics().SampleIdStatistics.Update(value);
         Y_UNUSED(localObjectIdx);
     }
 
     // TRawObjectsData
     void AddFloatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, float feature) override {
         Y_ASSERT(false);
-        DatasetStatistics.FeatureStatistics
+        GetThreadStatistics().FeatureStatistics
             .FloatFeatureStatistics[GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx)]
             .Update(feature);
         Y_UNUSED(localObjectIdx);
     }
     void AddAllFloatFeatures(ui32 localObjectIdx, TConstArrayRef<float> features) override {
         for (auto perTypeFeatureIdx : xrange(features.size())) {
-            DatasetStatistics.FeatureStatistics
+            GetThreadStatistics().FeatureStatistics
                 .FloatFeatureStatistics[TFloatFeatureIdx(perTypeFeatureIdx).Idx]
                 .Update(features[perTypeFeatureIdx]);
         }
@@ -146,7 +159,7 @@ public:
 
     void AddCatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
         // ToDo Implement CatFeatureStatistics MLTOOLS-6678
-         DatasetStatistics.FeatureStatistics
+         GetThreadStatistics().FeatureStatistics
              .CatFeatureStatistics[GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx)]
              .Update(feature);
         Y_UNUSED(localObjectIdx);
@@ -154,7 +167,7 @@ public:
     void AddAllCatFeatures(ui32 localObjectIdx, TConstArrayRef<ui32> features) override {
         // ToDo Implement CatFeatureStatistics MLTOOLS-6678
         for (auto perTypeFeatureIdx : xrange(features.size())) {
-            DatasetStatistics.FeatureStatistics
+            GetThreadStatistics().FeatureStatistics
                 .CatFeatureStatistics[TCatFeatureIdx(perTypeFeatureIdx).Idx]
                 .Update(features[perTypeFeatureIdx]);
         }
@@ -176,13 +189,13 @@ public:
     }
 
     void AddTextFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
-        DatasetStatistics.FeatureStatistics.TextFeatureStatistics[
+        GetThreadStatistics().FeatureStatistics.TextFeatureStatistics[
             GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx)
         ].Update(feature);
         Y_UNUSED(localObjectIdx);
     }
     void AddTextFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, const TString& feature) override {
-        DatasetStatistics.FeatureStatistics.TextFeatureStatistics[
+        GetThreadStatistics().FeatureStatistics.TextFeatureStatistics[
             GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx)
         ].Update(feature);
         Y_UNUSED(localObjectIdx);
@@ -210,47 +223,39 @@ public:
 
     void AddTarget(ui32 localObjectIdx, const TString& value) override {
         if (!ConvertStringTargets) {
-            DatasetStatistics.TargetsStatistics.Update(/* flatTargetIdx */ 0, value);
+            GetThreadStatistics().TargetsStatistics.Update(/* flatTargetIdx */ 0, value);
         } else {
             float fValue = FromString<float>(value);
-            DatasetStatistics.TargetsStatistics.Update(/* flatTargetIdx */ 0, fValue);
-            with_lock(TargetLock) {
-                FloatTarget[0].push_back(fValue);
-            }
+            GetThreadStatistics().TargetsStatistics.Update(/* flatTargetIdx */ 0, fValue);
+            AddFloatTarget(0, fValue);
         }
         Y_UNUSED(localObjectIdx);
     }
     void AddTarget(ui32 localObjectIdx, float value) override {
         if (MetaInfo.TargetType == ERawTargetType::Float) {
-            DatasetStatistics.TargetsStatistics.Update(/* flatTargetIdx */ 0, value);
-            with_lock(TargetLock) {
-                FloatTarget[0].push_back(value);
-            }
+            GetThreadStatistics().TargetsStatistics.Update(/* flatTargetIdx */ 0, value);
+            AddFloatTarget(0, value);
         } else {
-            DatasetStatistics.TargetsStatistics.Update(/* flatTargetIdx */ 0, ui32(value));
+            GetThreadStatistics().TargetsStatistics.Update(/* flatTargetIdx */ 0, ui32(value));
         }
         Y_UNUSED(localObjectIdx);
     }
     void AddTarget(ui32 flatTargetIdx, ui32 localObjectIdx, const TString& value) override {
         if (!ConvertStringTargets) {
-            DatasetStatistics.TargetsStatistics.Update(flatTargetIdx, value);
+            GetThreadStatistics().TargetsStatistics.Update(flatTargetIdx, value);
         } else {
             float fValue = FromString<float>(value);
-            DatasetStatistics.TargetsStatistics.Update(flatTargetIdx, fValue);
-            with_lock(TargetLock) {
-                FloatTarget[0].push_back(fValue);
-            }
+            GetThreadStatistics().TargetsStatistics.Update(flatTargetIdx, fValue);
+            AddFloatTarget(0, fValue);
         }
         Y_UNUSED(localObjectIdx);
     }
     void AddTarget(ui32 flatTargetIdx, ui32 localObjectIdx, float value) override {
         if (MetaInfo.TargetType == ERawTargetType::Float) {
-            DatasetStatistics.TargetsStatistics.Update(flatTargetIdx, value);
-            with_lock(TargetLock) {
-                FloatTarget[flatTargetIdx].push_back(value);
-            }
+            GetThreadStatistics().TargetsStatistics.Update(flatTargetIdx, value);
+            AddFloatTarget(flatTargetIdx, value);
         } else {
-            DatasetStatistics.TargetsStatistics.Update(flatTargetIdx, ui32(value));
+            GetThreadStatistics().TargetsStatistics.Update(flatTargetIdx, ui32(value));
         }
         Y_UNUSED(localObjectIdx);
     }
@@ -270,6 +275,17 @@ public:
             !IsLocal || NextCursor >= ObjectCount,
             "processed object count is less than than specified in metadata: " << NextCursor << "<"
             << ObjectCount);
+        for (const auto& threadPart : ThreadParts) {
+            DatasetStatistics.FeatureStatistics.Update(threadPart->Statistics.FeatureStatistics);
+            DatasetStatistics.TargetsStatistics.Update(threadPart->Statistics.TargetsStatistics);
+            DatasetStatistics.SampleIdStatistics.Update(threadPart->Statistics.SampleIdStatistics);
+            for (auto targetIdx : xrange(threadPart->FloatTarget.size())) {
+                const auto& threadFloatTarget = threadPart->FloatTarget[targetIdx];
+                FloatTarget[targetIdx].insert(FloatTarget[targetIdx].end(), threadFloatTarget.begin(), threadFloatTarget.end());
+            }
+        }
+        ThreadParts.clear();
+
         if (IsLocal) {
             DatasetStatistics.ObjectsCount = ObjectCount;
         } else {
@@ -326,12 +342,47 @@ public:
         return FloatTarget;
     }
 
+private:
+    // Statistics collected by one thread of LocalExecutor, merged into DatasetStatistics in Finish.
+    // Statistics are still updated under their own locks, so threads of another executor are safe.
+    struct TThreadPart {
+        TDatasetStatistics Statistics;
+        TVector<TVector<float>> FloatTarget;
+        TMutex FloatTargetLock;
+    };
+
 private:
     template <EFeatureType FeatureType>
     ui32 GetInternalFeatureIdx(ui32 flatFeatureIdx) const {
         return MetaInfo.FeaturesLayout->GetExpandingInternalFeatureIdx<FeatureType>(flatFeatureIdx).Idx;
     }
 
+    TThreadPart* GetThreadPart() {
+        if (ThreadParts.empty()) {
+            return nullptr;
+        }
+        const int threadId = LocalExecutor->GetWorkerThreadId();
+        return (threadId >= 0 && (size_t)threadId < ThreadParts.size()) ? ThreadParts[threadId].Get() : nullptr;
+    }
+
+    TDatasetStatistics& GetThreadStatistics() {
+        TThreadPart* threadPart = GetThreadPart();
+        return threadPart ? threadPart->Statistics : DatasetStatistics;
+    }
+
+    void AddFloatTarget(ui32 flatTargetIdx, float value) {
+        TThreadPart* threadPart = GetThreadPart();
+        if (threadPart) {
+            with_lock(threadPart->FloatTargetLock) {
+                threadPart->FloatTarget[flatTargetIdx].push_back(value);
+            }
+        } else {
+            with_lock(TargetLock) {
+                FloatTarget[flatTargetIdx].push_back(value);
+            }
+        }
+    }
+
 private:
     bool InBlock;
     ui32 ObjectCount;
@@ -353,6 +404,9 @@ private:
     TFeatureCustomBorders CustomBorders;
     TFeatureCustomBorders TargetCustomBorders;
     bool ConvertStringTargets;
+
+    NPar::ILocalExecutor* LocalExecutor;
+    TVector<THolder<TThreadPart>> ThreadParts; // [threadId]
 };
 
 class TDatasetStatisticsOnlyGroupVisitor final : public IRawObjectsOrderDataVisitor {
@@ -6,10 +6,78 @@
 #include <catboost/private/libs/options/loss_description.h>
 #include <util/generic/utility.h>
 #include <util/string/builder.h>
+#include <util/string/cast.h>
+
+#include <variant>
 
 
 namespace NCB {
 
+    EBinaryEvalColumnType GetBinaryEvalColumnType(std::type_index outputType) {
+        if (outputType == typeid(float)) {
+            return EBinaryEvalColumnType::Float32;
+        } else if (outputType == typeid(double)) {
+            return EBinaryEvalColumnType::Float64;
+        } else if (outputType == typeid(i64)) {
+            return EBinaryEvalColumnType::Int64;
+        } else if (outputType == typeid(ui64)) {
+            return EBinaryEvalColumnType::UInt64;
+        }
+        CB_ENSURE_INTERNAL(outputType == typeid(TString), "Unsupported column type for binary output: " << outputType.name());
+        return EBinaryEvalColumnType::String;
+    }
+
+    template <typename TDst>
+    static void OutputBinaryValue(const TColumnPrinterOuputType& value, IOutputStream* outStream) {
+        const TDst dstValue = std::visit(
+            [] (const auto& srcValue) -> TDst {
+                if constexpr (std::is_same_v<std::decay_t<decltype(srcValue)>, TString>) {
+                    return FromString<TDst>(srcValue);
+                } else {
+                    return static_cast<TDst>(srcValue);
+                }
+            },
+            value
+        );
+        outStream->Write(&dstValue, sizeof(TDst));
+    }
+
+    void IColumnPrinter::OutputBinaryValues(IOutputStream* outStream, size_t docCount) {
+        const EBinaryEvalColumnType columnType = GetBinaryEvalColumnType(GetOutputType());
+        TColumnPrinterOuputType value;
+        if (columnType == EBinaryEvalColumnType::String) {
+            TVector<ui32> sizes;
+            sizes.reserve(docCount);
+            TString data;
+            for (size_t docIndex = 0; docIndex < docCount; ++docIndex) {
+                GetValue(docIndex, &value);
+                const TString& stringValue = std::get<TString>(value);
+                sizes.push_back(stringValue.size());
+                data += stringValue;
+            }
+            outStream->Write(sizes.data(), sizes.size() * sizeof(ui32));
+            outStream->Write(data.data(), data.size());
+            return;
+        }
+        for (size_t docIndex = 0; docIndex < docCount; ++docIndex) {
+            GetValue(docIndex, &value);
+            switch (columnType) {
+                case EBinaryEvalColumnType::Float32:
+                    OutputBinaryValue<float>(value, outStream);
+                    break;
+                case EBinaryEvalColumnType::Float64:
+                    OutputBinaryValue<double>(value, outStream);
+                    break;
+                case EBinaryEvalColumnType::Int64:
+                    OutputBinaryValue<i64>(value, outStream);
+                    break;
+                default:
+                    Y_ASSERT(columnType == EBinaryEvalColumnType::UInt64);
+                    OutputBinaryValue<ui64>(value, outStream);
+            }
+        }
+    }
+
     void PushBackEvalPrinters(
         const TVector<TVector<TVector<double>>>& rawValues,
         const EPredictionType predictionType,
@@ -56,7 +124,7 @@ namespace NCB {
             } else {
                 for (int i = 0; i < approxes.ysize(); ++i) {
                     result->push_back(
-                        MakeHolder<TEvalPrinter>(predictionType, headers[i], approxes[i], visibleLabelsHelper)
+                        MakeHolder<TEvalPrinter>(predictionType, headers[i], std::move(approxes[i]), visibleLabelsHelper)
                     );
                 }
             }
@@ -22,11 +22,28 @@
 #include <util/system/compiler.h>
 #include <util/system/types.h>
 
+#include <numeric>
 #include <utility>
+#include <type_traits>
 #include <typeindex>
 
 namespace NCB {
 
+    // Types of columns in binary eval output, see OutputBinaryEvalResultBlock
+    enum class EBinaryEvalColumnType : ui8 {
+        Float32 = 0,
+        Float64 = 1,
+        Int64 = 2,
+        UInt64 = 3,
+        String = 4
+    };
+
+    EBinaryEvalColumnType GetBinaryEvalColumnType(std::type_index outputType);
+
+    template <typename T>
+    constexpr bool IsBinaryEvalNumericType = std::is_same_v<T, float> || std::is_same_v<T, double>
+        || std::is_same_v<T, i64> || std::is_same_v<T, ui64>;
+
     class IColumnPrinter {
     public:
         virtual ~IColumnPrinter() = default;
@@ -37,6 +54,10 @@ namespace NCB {
             return "\t";
         }
         virtual std::type_index GetOutputType() = 0;
+
+        // Writes values of docs [0, docCount) as one column of binary eval output.
+        // Default implementation gets values one by one, printers of arrays write them as is.
+        virtual void OutputBinaryValues(IOutputStream* outStream, size_t docCount);
     };
 
 
@@ -77,6 +98,15 @@ namespace NCB {
             return typeid(T);
         }
 
+        void OutputBinaryValues(IOutputStream* outStream, size_t docCount) override {
+            if constexpr (IsBinaryEvalNumericType<T>) {
+                Y_ASSERT(docCount <= (*Array).size());
+                outStream->Write((*Array).data(), docCount * sizeof(T));
+            } else {
+                IColumnPrinter::OutputBinaryValues(outStream, docCount);
+            }
+        }
+
     private:
         const NCB::TMaybeOwningConstArrayHolder<T> Array;
         const TString Header;
@@ -106,6 +136,15 @@ namespace NCB {
             *outStream << Header;
         }
 
+        void OutputBinaryValues(IOutputStream* outStream, size_t docCount) override {
+            if (Weights.IsTrivial()) {
+                const TVector<float> trivialWeights(docCount, 1.0f);
+                outStream->Write(trivialWeights.data(), docCount * sizeof(float));
+            } else {
+                outStream->Write(Weights.GetNonTrivialData().data(), docCount * sizeof(float));
+            }
+        }
+
     private:
         const TWeights<float>& Weights;
         const TString Header;
@@ -236,12 +275,12 @@ namespace NCB {
         TEvalPrinter(
             const EPredictionType predictionType,
             const TString& header,
-            const TVector<double>& approx,
+            TVector<double> approx,
             const TExternalLabelsHelper& visibleLabelsHelper
         )
             : PredictionType(predictionType)
             , Header(header)
-            , Approx(approx)
+            , Approx(std::move(approx))
             , VisibleLabelsHelper(visibleLabelsHelper)
         {}
 
@@ -274,6 +313,14 @@ namespace NCB {
             }
         }
 
+        void OutputBinaryValues(IOutputStream* outStream, size_t docCount) override {
+            if (PredictionType == EPredictionType::Class) {
+                IColumnPrinter::OutputBinaryValues(outStream, docCount);
+            } else {
+                outStream->Write(Approx.data(), docCount * sizeof(double));
+            }
+        }
+
     private:
         EPredictionType PredictionType;
         TString Header;
@@ -390,6 +437,16 @@ namespace NCB {
             return NeedToGenerate ? typeid(ui64) : typeid(TString);
         }
 
+        void OutputBinaryValues(IOutputStream* outStream, size_t docCount) override {
+            if (NeedToGenerate) {
+                TVector<ui64> docIds(docCount);
+                std::iota(docIds.begin(), docIds.end(), DocIdOffset);
+                outStream->Write(docIds.data(), docCount * sizeof(ui64));
+            } else {
+                IColumnPrinter::OutputBinaryValues(outStream, docCount);
+            }
+        }
+
         bool NeedPrinterPtr() {
             return !NeedToGenerate;
         }
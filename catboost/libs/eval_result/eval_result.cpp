@@ -9,6 +9,7 @@
 
 #include <util/generic/hash_set.h>
 #include <util/stream/fwd.h>
+#include <util/stream/str.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
 
@@ -50,6 +51,35 @@ static TFeatureIdToDesc GetFeatureIdToDesc(const TDataProvider& pool) {
 
 namespace NCB {
 
+    const TStringBuf BinaryEvalOutputMagic = "CBEVAL01";
+
+    void OutputBinaryEvalResultHeader(TConstArrayRef<THolder<IColumnPrinter>> columnPrinters, IOutputStream* outputStream) {
+        outputStream->Write(BinaryEvalOutputMagic.data(), BinaryEvalOutputMagic.size());
+        const ui32 columnCount = columnPrinters.size();
+        outputStream->Write(&columnCount, sizeof(columnCount));
+        for (const auto& printer : columnPrinters) {
+            const ui8 columnType = static_cast<ui8>(GetBinaryEvalColumnType(printer->GetOutputType()));
+            outputStream->Write(&columnType, sizeof(columnType));
+            TStringStream name;
+            printer->OutputHeader(&name);
+            const ui32 nameSize = name.Str().size();
+            outputStream->Write(&nameSize, sizeof(nameSize));
+            outputStream->Write(name.Str().data(), nameSize);
+        }
+    }
+
+    void OutputBinaryEvalResultBlock(
+        TConstArrayRef<THolder<IColumnPrinter>> columnPrinters,
+        size_t docCount,
+        IOutputStream* outputStream
+    ) {
+        const ui64 blockDocCount = docCount;
+        outputStream->Write(&blockDocCount, sizeof(blockDocCount));
+        for (const auto& printer : columnPrinters) {
+            printer->OutputBinaryValues(outputStream, docCount);
+        }
+    }
+
     TVector<TVector<TVector<double>>>& TEvalResult::GetRawValuesRef() {
         return RawValues;
     }
@@ -411,7 +441,8 @@ namespace NCB {
         bool writeHeader,
         ui64 docIdOffset,
         TMaybe<std::pair<size_t, size_t>> evalParameters, // evalPeriod, iterationsLimit
-        double binClassLogitThreshold) {
+        double binClassLogitThreshold,
+        EEvalOutputFormat outputFormat) {
 
         bool needPoolColumnsPrinter;
         TVector<THolder<IColumnPrinter>> columnPrinter = InitializeColumnWriter(
@@ -427,6 +458,13 @@ namespace NCB {
             binClassLogitThreshold
         );
 
+        if (outputFormat == EEvalOutputFormat::Binary) {
+            if (writeHeader) {
+                OutputBinaryEvalResultHeader(columnPrinter, outputStream);
+            }
+            OutputBinaryEvalResultBlock(columnPrinter, pool.ObjectsGrouping->GetObjectCount(), outputStream);
+            return;
+        }
         if (writeHeader) {
             TString delimiter = "";
             for (auto& printer : columnPrinter) {
@@ -7,11 +7,14 @@
 #include <catboost/private/libs/data_util/line_data_reader.h>
 #include <catboost/private/libs/data_util/path_with_scheme.h>
 #include <catboost/private/libs/labels/external_label_helper.h>
+#include <catboost/private/libs/options/enums.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
 #include <util/generic/string.h>
+#include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 #include <util/stream/output.h>
 #include <util/system/types.h>
@@ -70,6 +73,22 @@ namespace NCB {
         TMaybe<std::pair<size_t, size_t>> evalParameters = TMaybe<std::pair<size_t, size_t>>(),
         double binClassLogitThreshold = DEFAULT_BINCLASS_LOGIT_THRESHOLD);
 
+    /* Binary columnar eval output (EEvalOutputFormat::Binary).
+     * Header: magic "CBEVAL01", ui32 column count, then for every column
+     * ui8 EBinaryEvalColumnType, ui32 name size and the name.
+     * Header is followed by blocks up to the end of file: ui64 doc count, then data of every column for the block.
+     * Numeric columns are arrays of values in native (little-endian) byte order,
+     * string columns are ui32 sizes of all values followed by concatenated values.
+     */
+    extern const TStringBuf BinaryEvalOutputMagic;
+
+    void OutputBinaryEvalResultHeader(TConstArrayRef<THolder<IColumnPrinter>> columnPrinters, IOutputStream* outputStream);
+
+    void OutputBinaryEvalResultBlock(
+        TConstArrayRef<THolder<IColumnPrinter>> columnPrinters,
+        size_t docCount,
+        IOutputStream* outputStream);
+
     // evaluate multiple models
     void OutputEvalResultToFile(
         const TEvalColumnsInfo& evalColumnsInfo,
@@ -82,7 +101,8 @@ namespace NCB {
         bool writeHeader = true,
         ui64 docIdOffset = 0,
         TMaybe<std::pair<size_t, size_t>> evalParameters = TMaybe<std::pair<size_t, size_t>>(), // evalPeriod, iterationsLimit
-        double binClassLogitThreshold = DEFAULT_BINCLASS_LOGIT_THRESHOLD);
+        double binClassLogitThreshold = DEFAULT_BINCLASS_LOGIT_THRESHOLD,
+        EEvalOutputFormat outputFormat = EEvalOutputFormat::Tsv);
 
     // evaluate single model
     void OutputEvalResultToFile(
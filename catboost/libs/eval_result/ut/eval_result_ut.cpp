@@ -0,0 +1,232 @@
+#include <catboost/libs/eval_result/eval_result.h>
+#include <catboost/libs/eval_result/pool_printer.h>
+
+#include <catboost/libs/data/data_provider_builders.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/mem.h>
+#include <util/stream/str.h>
+
+#include <variant>
+
+
+using namespace NCB;
+
+
+namespace {
+    using TBinaryColumnValues = std::variant<TVector<float>, TVector<double>, TVector<i64>, TVector<ui64>, TVector<TString>>;
+
+    struct TBinaryColumn {
+        EBinaryEvalColumnType Type;
+        TString Name;
+        TBinaryColumnValues Values; // all blocks concatenated
+    };
+
+    // features are taken from the data provider, the source file has no other columns
+    class TNoSourceColumnsPrinter : public IPoolColumnsPrinter {
+    public:
+        void OutputColumnByType(IOutputStream*, ui64, EColumn) override {
+            Y_UNREACHABLE();
+        }
+        void OutputFeatureColumnByIndex(IOutputStream*, ui64, ui32) override {
+            Y_UNREACHABLE();
+        }
+        void OutputAuxiliaryColumn(IOutputStream*, ui64, ui32, const TString&) override {
+            Y_UNREACHABLE();
+        }
+        bool ValidAuxiliaryColumn(const TString&) override {
+            return false;
+        }
+        ui32 GetAuxiliaryColumnId(const TString&) override {
+            Y_UNREACHABLE();
+        }
+        std::type_index GetOutputFeatureType(ui32) override {
+            Y_UNREACHABLE();
+        }
+    };
+}
+
+template <typename T>
+static void ReadExactly(IInputStream* input, T* dst, size_t count = 1) {
+    const size_t size = count * sizeof(T);
+    UNIT_ASSERT_VALUES_EQUAL(input->Load(dst, size), size);
+}
+
+template <typename T>
+static void ReadNumericBlock(IInputStream* input, ui64 docCount, TBinaryColumnValues* values) {
+    auto& dst = std::get<TVector<T>>(*values);
+    const size_t oldSize = dst.size();
+    dst.resize(oldSize + docCount);
+    ReadExactly(input, dst.data() + oldSize, docCount);
+}
+
+static TVector<TBinaryColumn> ReadBinaryEvalResult(TStringBuf data) {
+    TMemoryInput input(data);
+
+    TString magic(BinaryEvalOutputMagic.size(), '\0');
+    ReadExactly(&input, magic.begin(), magic.size());
+    UNIT_ASSERT_VALUES_EQUAL(magic, BinaryEvalOutputMagic);
+
+    ui32 columnCount = 0;
+    ReadExactly(&input, &columnCount);
+    TVector<TBinaryColumn> columns(columnCount);
+    for (auto& column : columns) {
+        ui8 type = 0;
+        ReadExactly(&input, &type);
+        column.Type = static_cast<EBinaryEvalColumnType>(type);
+        ui32 nameSize = 0;
+        ReadExactly(&input, &nameSize);
+        column.Name.resize(nameSize);
+        ReadExactly(&input, column.Name.begin(), nameSize);
+        switch (column.Type) {
+            case EBinaryEvalColumnType::Float32:
+                column.Values = TVector<float>();
+                break;
+            case EBinaryEvalColumnType::Float64:
+                column.Values = TVector<double>();
+                break;
+            case EBinaryEvalColumnType::Int64:
+                column.Values = TVector<i64>();
+                break;
+            case EBinaryEvalColumnType::UInt64:
+                column.Values = TVector<ui64>();
+                break;
+            case EBinaryEvalColumnType::String:
+                column.Values = TVector<TString>();
+                break;
+            default:
+                UNIT_FAIL("Unknown column type " << (int)type);
+        }
+    }
+
+    while (!input.Exhausted()) {
+        ui64 docCount = 0;
+        ReadExactly(&input, &docCount);
+        for (auto& column : columns) {
+            switch (column.Type) {
+                case EBinaryEvalColumnType::Float32:
+                    ReadNumericBlock<float>(&input, docCount, &column.Values);
+                    break;
+                case EBinaryEvalColumnType::Float64:
+                    ReadNumericBlock<double>(&input, docCount, &column.Values);
+                    break;
+                case EBinaryEvalColumnType::Int64:
+                    ReadNumericBlock<i64>(&input, docCount, &column.Values);
+                    break;
+                case EBinaryEvalColumnType::UInt64:
+                    ReadNumericBlock<ui64>(&input, docCount, &column.Values);
+                    break;
+                case EBinaryEvalColumnType::String: {
+                    TVector<ui32> sizes(docCount);
+                    ReadExactly(&input, sizes.data(), docCount);
+                    auto& values = std::get<TVector<TString>>(column.Values);
+                    for (auto size : sizes) {
+                        values.emplace_back(size, '\0');
+                        ReadExactly(&input, values.back().begin(), size);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    return columns;
+}
+
+static TDataProviderPtr CreatePool(
+    TConstArrayRef<float> featureValues,
+    TConstArrayRef<TString> labels,
+    TConstArrayRef<float> weights
+) {
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.TargetType = ERawTargetType::String;
+            metaInfo.TargetCount = 1;
+            metaInfo.HasWeights = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                (ui32)1,
+                TVector<ui32>{},
+                TVector<TString>{"num"}
+            );
+
+            visitor->Start(metaInfo, featureValues.size(), EObjectsOrder::Undefined, {});
+
+            visitor->AddFloatFeature(
+                0,
+                MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(featureValues.begin(), featureValues.end()))
+            );
+            visitor->AddTarget(labels);
+            visitor->AddWeights(weights);
+
+            visitor->Finish();
+        }
+    );
+}
+
+Y_UNIT_TEST_SUITE(TBinaryEvalResultTest) {
+    Y_UNIT_TEST(RoundTrip) {
+        // two blocks, as written by calc mode for a pool read in parts
+        const TVector<TVector<float>> featureValues = {{0.5f, -1.25f, 3.0f}, {7.5f, 0.0f}};
+        const TVector<TVector<TString>> labels = {{"a", "", "long label"}, {"b", "c"}};
+        const TVector<TVector<float>> weights = {{1.0f, 2.0f, 0.5f}, {3.0f, 0.25f}};
+        const TVector<TVector<double>> approxes = {{0.1, -0.2, 1e-300}, {12345.678, -0.0}};
+
+        NPar::TLocalExecutor localExecutor;
+        const TVector<TString> outputColumns = {"SampleId", "RawFormulaVal", "Label", "Weight", "num"};
+
+        const auto poolColumnsPrinter = MakeIntrusive<TNoSourceColumnsPrinter>();
+        TStringStream output;
+        ui64 docIdOffset = 0;
+        for (auto blockIdx : xrange(featureValues.size())) {
+            const auto pool = CreatePool(featureValues[blockIdx], labels[blockIdx], weights[blockIdx]);
+
+            TEvalResult evalResult;
+            TVector<TVector<double>> rawValues = {approxes[blockIdx]};
+            evalResult.SetRawValuesByMove(rawValues);
+            const TEvalColumnsInfo evalColumnsInfo{{evalResult}, {TExternalLabelsHelper()}, {"RMSE"}};
+
+            OutputEvalResultToFile(
+                evalColumnsInfo,
+                &localExecutor,
+                {outputColumns},
+                *pool,
+                &output,
+                poolColumnsPrinter,
+                /*testFileWhichOf*/ {0, 1},
+                /*writeHeader*/ blockIdx == 0,
+                docIdOffset,
+                /*evalParameters*/ Nothing(),
+                DEFAULT_BINCLASS_LOGIT_THRESHOLD,
+                EEvalOutputFormat::Binary
+            );
+            docIdOffset += featureValues[blockIdx].size();
+        }
+
+        const auto columns = ReadBinaryEvalResult(output.Str());
+        UNIT_ASSERT_VALUES_EQUAL(columns.size(), outputColumns.size());
+        for (auto columnIdx : xrange(columns.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(columns[columnIdx].Name, outputColumns[columnIdx]);
+        }
+
+        UNIT_ASSERT_EQUAL(columns[0].Type, EBinaryEvalColumnType::UInt64);
+        UNIT_ASSERT_EQUAL(std::get<TVector<ui64>>(columns[0].Values), (TVector<ui64>{0, 1, 2, 3, 4}));
+
+        UNIT_ASSERT_EQUAL(columns[1].Type, EBinaryEvalColumnType::Float64);
+        UNIT_ASSERT_EQUAL(std::get<TVector<double>>(columns[1].Values), (TVector<double>{0.1, -0.2, 1e-300, 12345.678, -0.0}));
+
+        UNIT_ASSERT_EQUAL(columns[2].Type, EBinaryEvalColumnType::String);
+        UNIT_ASSERT_EQUAL(
+            std::get<TVector<TString>>(columns[2].Values),
+            (TVector<TString>{"a", "", "long label", "b", "c"})
+        );
+
+        UNIT_ASSERT_EQUAL(columns[3].Type, EBinaryEvalColumnType::Float32);
+        UNIT_ASSERT_EQUAL(std::get<TVector<float>>(columns[3].Values), (TVector<float>{1.0f, 2.0f, 0.5f, 3.0f, 0.25f}));
+
+        UNIT_ASSERT_EQUAL(columns[4].Type, EBinaryEvalColumnType::Float32);
+        UNIT_ASSERT_EQUAL(std::get<TVector<float>>(columns[4].Values), (TVector<float>{0.5f, -1.25f, 3.0f, 7.5f, 0.0f}));
+    }
+}
@@ -366,7 +366,7 @@ namespace NCB {
                     "Feature",
                     /*getLossValueChange*/ [&] (ui32 featureIdx) -> double {
                         substractShapValuesFromApprox(featureIdx);
-                        double result = calcLoss(approx, model) - selectSet->CurrentLossValue;
+                        double result = calcLoss(approx) - selectSet->CurrentLossValue;
                         addShapValuesToApprox(featureIdx);
                         return result;
                     },
@@ -409,7 +409,7 @@ namespace NCB {
                             blockParams,
                             NPar::TLocalExecutor::WAIT_COMPLETE
                         );
-                        double result = calcLoss(approx, model) - selectSet->CurrentLossValue;
+                        double result = calcLoss(approx) - selectSet->CurrentLossValue;
                         executor->ExecRange(
                             [&](ui32 docIdx) {
                                 for (size_t dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
@@ -436,7 +436,7 @@ namespace NCB {
                 for (auto featureIdx : featureIndices) {
                     summary->EliminatedFeatures.push_back(featureIdx);
                     substractShapValuesFromApprox(featureIdx);
-                    selectSet->CurrentLossValue = calcLoss(approx, model);
+                    selectSet->CurrentLossValue = calcLoss(approx);
                     lossGraphBuilders->ForFeatures.AddEstimatedPoint(
                         summary->EliminatedFeatures.size(),
                         selectSet->CurrentLossValue
@@ -697,6 +697,10 @@ namespace NCB {
             ? trainingData.Learn->TargetData
             : trainingData.Test[0]->TargetData;
 
+        /* Quantized columns are shared between steps, but online ctrs and online estimated features are
+         * computed again by each training: they are owned by the folds of the learn context created inside
+         * IModelTrainer::TrainModel, and the trainer interface can only take precomputed ctrs for a single fold.
+         */
         const auto trainModel = [&] (bool isFinal) {
             TVector<TEvalResult> tempEvalResults(trainingData.Test.size());
             return TrainModel(
@@ -712,9 +716,10 @@ namespace NCB {
             );
         };
 
-        const auto calcLoss = [&] (const auto& approx, const TFullModel& model) {
+        // fstrPool target is processed once per trained model, loss is calculated many times for each model
+        const auto makeFstrTarget = [&] (const TFullModel& model) {
             TRestorableFastRng64 rand(0);
-            const auto fstrTarget = CreateModelCompatibleProcessedDataProvider(
+            return CreateModelCompatibleProcessedDataProvider(
                 *fstrPool,
                 { catBoostOptions.MetricOptions->ObjectiveMetric.Get() },
                 model,
@@ -722,7 +727,9 @@ namespace NCB {
                 &rand,
                 executor
             ).TargetData;
+        };
 
+        const auto calcLoss = [&] (const auto& approx, const TTargetDataProviderPtr& fstrTarget) {
             return CalcMetric(
                 *loss.Get(),
                 fstrTarget,
@@ -760,7 +767,8 @@ namespace NCB {
             outputFileOptions.SetTrainDir(initialOutputFileOptions.GetTrainDir() + "/model-" + ToString(step));
             const TFullModel model = trainModel(/*isFinal*/ false);
             TVector<TVector<double>> approx = applyModel(model);
-            selectSet.CurrentLossValue = calcLoss(approx, model);
+            const TTargetDataProviderPtr fstrTarget = makeFstrTarget(model);
+            selectSet.CurrentLossValue = calcLoss(approx, fstrTarget);
 
             lossGraphBuilders.ForFeatures.AddPrecisePoint(
                 summary.EliminatedFeatures.size(),
@@ -781,7 +789,7 @@ namespace NCB {
                         fstrPool,
                         numEntitiesToEliminateBySteps[step],
                         featuresSelectOptions.ShapCalcType,
-                        calcLoss,
+                        /*calcLoss*/ [&] (const auto& approx) { return calcLoss(approx, fstrTarget); },
                         lossBestValueType,
                         lossBestValue,
                         tagsMap,
@@ -828,7 +836,7 @@ namespace NCB {
             CATBOOST_NOTICE_LOG << "Train final model" << Endl;
             outputFileOptions.SetTrainDir(initialOutputFileOptions.GetTrainDir() + "/model-final");
             TFullModel finalModel = trainModel(/*isFinal*/ featuresSelectOptions.TrainFinalModel.Get());
-            const double lossValue = calcLoss(applyModel(finalModel), finalModel);
+            const double lossValue = calcLoss(applyModel(finalModel), makeFstrTarget(finalModel));
 
             lossGraphBuilders.ForFeatures.AddPrecisePoint(summary.EliminatedFeatures.size(), lossValue);
             if (featuresSelectOptions.Grouping == EFeaturesSelectionGrouping::ByTags) {
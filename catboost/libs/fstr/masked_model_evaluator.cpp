@@ -0,0 +1,216 @@
+#include "masked_model_evaluator.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/xrange.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace NCB;
+
+
+bool TMaskedModelEvaluator::IsSupported(const TFullModel& model) {
+    const TModelTrees& forest = *model.ModelTrees;
+    if (!forest.IsOblivious()) {
+        return false;
+    }
+    for (const auto& binFeature : forest.GetBinFeatures()) {
+        if (binFeature.Type != ESplitType::FloatFeature && binFeature.Type != ESplitType::OneHotFeature) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TMaskedModelEvaluator::TMaskedModelEvaluator(const TFullModel& model, NPar::ILocalExecutor* localExecutor)
+    : Model(model)
+    , LocalExecutor(localExecutor)
+    , ApproxDimension(model.GetDimensionsCount())
+{
+    CB_ENSURE_INTERNAL(IsSupported(model), "Masked evaluation supports only oblivious trees with float and one-hot splits");
+
+    const TModelTrees& forest = *model.ModelTrees;
+    THashMap<int, const TFloatFeature*> floatFeatures;
+    for (const auto& floatFeature : forest.GetFloatFeatures()) {
+        floatFeatures[floatFeature.Position.Index] = &floatFeature;
+    }
+    THashMap<int, int> catFeatureFlatIndices;
+    for (const auto& catFeature : forest.GetCatFeatures()) {
+        catFeatureFlatIndices[catFeature.Position.Index] = catFeature.Position.FlatIndex;
+    }
+
+    const auto getFeatureSlot = [&] (ui32 flatFeatureIdx, bool isCategorical) {
+        const auto [it, inserted] = FlatFeatureIdxToSlot.emplace(flatFeatureIdx, FeatureSlots.size());
+        if (inserted) {
+            FeatureSlots.emplace_back();
+            FeatureSlots.back().FlatFeatureIdx = flatFeatureIdx;
+            FeatureSlots.back().IsCategorical = isCategorical;
+        }
+        return it->second;
+    };
+
+    const auto binFeatures = forest.GetBinFeatures();
+    const auto treeSplits = forest.GetModelTreeData()->GetTreeSplits();
+    const auto treeSizes = forest.GetModelTreeData()->GetTreeSizes();
+    const auto treeStartOffsets = forest.GetModelTreeData()->GetTreeStartOffsets();
+    const size_t treeCount = forest.GetTreeCount();
+    TreeSplits.resize(treeCount);
+    TreeLeafValues.resize(treeCount);
+    for (auto treeIdx : xrange(treeCount)) {
+        TreeLeafValues[treeIdx] = forest.GetFirstLeafPtrForTree(treeIdx);
+        for (auto depth : xrange(treeSizes[treeIdx])) {
+            const TModelSplit& split = binFeatures[treeSplits[treeStartOffsets[treeIdx] + depth]];
+            TTreeSplit treeSplit;
+            if (split.Type == ESplitType::FloatFeature) {
+                const TFloatFeature& floatFeature = *floatFeatures.at(split.FloatFeature.FloatFeature);
+                treeSplit.FeatureSlot = getFeatureSlot(floatFeature.Position.FlatIndex, /*isCategorical*/ false);
+                if (floatFeature.HasNans) {
+                    FeatureSlots[treeSplit.FeatureSlot].NanValueTreatment = floatFeature.NanValueTreatment;
+                }
+                treeSplit.Border = split.FloatFeature.Split;
+            } else {
+                const int flatFeatureIdx = catFeatureFlatIndices.at(split.OneHotFeature.CatFeatureIdx);
+                treeSplit.FeatureSlot = getFeatureSlot(flatFeatureIdx, /*isCategorical*/ true);
+                treeSplit.Value = split.OneHotFeature.Value;
+            }
+            auto& slotTrees = FeatureSlots[treeSplit.FeatureSlot].Trees;
+            if (slotTrees.empty() || slotTrees.back() != treeIdx) {
+                slotTrees.push_back(treeIdx);
+            }
+            TreeSplits[treeIdx].push_back(treeSplit);
+        }
+    }
+}
+
+void TMaskedModelEvaluator::SetFloatValues(TFeatureSlot* slot, TVector<float>&& values) {
+    // same substitution as in model binarization
+    if (slot->NanValueTreatment != TFloatFeature::ENanValueTreatment::AsIs) {
+        const float nanSubstitution = slot->NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue
+            ? std::numeric_limits<float>::infinity()
+            : -std::numeric_limits<float>::infinity();
+        for (auto& value : values) {
+            if (std::isnan(value)) {
+                value = nanSubstitution;
+            }
+        }
+    }
+    slot->FloatValues = std::move(values);
+}
+
+ui32 TMaskedModelEvaluator::CalcLeafIndex(ui32 treeIdx, ui32 objectIdx) const {
+    ui32 leafIdx = 0;
+    const auto& splits = TreeSplits[treeIdx];
+    for (auto depth : xrange(splits.size())) {
+        const auto& split = splits[depth];
+        const auto& slot = FeatureSlots[split.FeatureSlot];
+        const bool isTrueSplit = slot.IsCategorical
+            ? (int)slot.HashedCatValues[objectIdx] == split.Value
+            : slot.FloatValues[objectIdx] > split.Border;
+        leafIdx |= ui32(isTrueSplit) << depth;
+    }
+    return leafIdx;
+}
+
+void TMaskedModelEvaluator::SetObjects(
+    const TRawObjectsDataProvider& objectsData,
+    TMaybeData<TConstArrayRef<TConstArrayRef<float>>> baseline)
+{
+    ObjectCount = objectsData.GetObjectCount();
+    const auto& featuresLayout = *objectsData.GetFeaturesLayout();
+    for (auto& slot : FeatureSlots) {
+        const ui32 internalFeatureIdx = featuresLayout.GetInternalFeatureIdx(slot.FlatFeatureIdx);
+        if (slot.IsCategorical) {
+            const auto column = objectsData.GetCatFeature(internalFeatureIdx);
+            CB_ENSURE(column, "Categorical feature #" << slot.FlatFeatureIdx << " is used in model but absent in data");
+            const auto values = (*column)->ExtractValues(LocalExecutor);
+            slot.HashedCatValues.assign(values.begin(), values.end());
+        } else {
+            const auto column = objectsData.GetFloatFeature(internalFeatureIdx);
+            CB_ENSURE(column, "Float feature #" << slot.FlatFeatureIdx << " is used in model but absent in data");
+            const auto values = (*column)->ExtractValues(LocalExecutor);
+            SetFloatValues(&slot, TVector<float>(values.begin(), values.end()));
+        }
+    }
+
+    const auto& scaleAndBias = Model.GetScaleAndBias();
+    Approx.assign(ApproxDimension, TVector<double>(ObjectCount));
+    for (auto dim : xrange(ApproxDimension)) {
+        const double bias = scaleAndBias.GetBiasRef().empty() ? 0.0 : scaleAndBias.GetBiasRef()[dim];
+        for (auto objectIdx : xrange(ObjectCount)) {
+            Approx[dim][objectIdx] = bias + (baseline ? (*baseline)[dim][objectIdx] : 0.0);
+        }
+    }
+
+    LeafIndices.resize(TreeSplits.size());
+    NPar::ILocalExecutor::TExecRangeParams blockParams(0, ObjectCount);
+    blockParams.SetBlockCount(LocalExecutor->GetThreadCount() + 1);
+    for (auto treeIdx : xrange(TreeSplits.size())) {
+        LeafIndices[treeIdx].yresize(ObjectCount);
+    }
+    LocalExecutor->ExecRange(
+        [&] (int blockIdx) {
+            const ui32 blockBegin = blockParams.FirstId + blockIdx * blockParams.GetBlockSize();
+            const ui32 blockEnd = Min<ui32>(blockBegin + blockParams.GetBlockSize(), blockParams.LastId);
+            for (auto treeIdx : xrange(TreeSplits.size())) {
+                for (auto objectIdx : xrange(blockBegin, blockEnd)) {
+                    const ui32 leafIdx = CalcLeafIndex(treeIdx, objectIdx);
+                    LeafIndices[treeIdx][objectIdx] = leafIdx;
+                    const double* leafValues = TreeLeafValues[treeIdx] + leafIdx * ApproxDimension;
+                    for (auto dim : xrange(ApproxDimension)) {
+                        Approx[dim][objectIdx] += scaleAndBias.Scale * leafValues[dim];
+                    }
+                }
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
+
+void TMaskedModelEvaluator::UpdateTrees(const TFeatureSlot& slot) {
+    const double scale = Model.GetScaleAndBias().Scale;
+    NPar::ILocalExecutor::TExecRangeParams blockParams(0, ObjectCount);
+    blockParams.SetBlockCount(LocalExecutor->GetThreadCount() + 1);
+    LocalExecutor->ExecRange(
+        [&] (int blockIdx) {
+            const ui32 blockBegin = blockParams.FirstId + blockIdx * blockParams.GetBlockSize();
+            const ui32 blockEnd = Min<ui32>(blockBegin + blockParams.GetBlockSize(), blockParams.LastId);
+            for (ui32 treeIdx : slot.Trees) {
+                for (auto objectIdx : xrange(blockBegin, blockEnd)) {
+                    const ui32 leafIdx = CalcLeafIndex(treeIdx, objectIdx);
+                    ui32& oldLeafIdx = LeafIndices[treeIdx][objectIdx];
+                    if (leafIdx == oldLeafIdx) {
+                        continue;
+                    }
+                    const double* leafValues = TreeLeafValues[treeIdx] + leafIdx * ApproxDimension;
+                    const double* oldLeafValues = TreeLeafValues[treeIdx] + oldLeafIdx * ApproxDimension;
+                    for (auto dim : xrange(ApproxDimension)) {
+                        Approx[dim][objectIdx] += scale * (leafValues[dim] - oldLeafValues[dim]);
+                    }
+                    oldLeafIdx = leafIdx;
+                }
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
+
+void TMaskedModelEvaluator::UpdateFloatFeature(ui32 flatFeatureIdx, TVector<float>&& values) {
+    auto& slot = FeatureSlots[FlatFeatureIdxToSlot.at(flatFeatureIdx)];
+    CB_ENSURE_INTERNAL(!slot.IsCategorical, "Feature #" << flatFeatureIdx << " is not a float feature");
+    CB_ENSURE_INTERNAL(values.size() == ObjectCount, "Wrong size of feature values");
+    SetFloatValues(&slot, std::move(values));
+    UpdateTrees(slot);
+}
+
+void TMaskedModelEvaluator::UpdateCatFeature(ui32 flatFeatureIdx, TVector<ui32>&& hashedValues) {
+    auto& slot = FeatureSlots[FlatFeatureIdxToSlot.at(flatFeatureIdx)];
+    CB_ENSURE_INTERNAL(slot.IsCategorical, "Feature #" << flatFeatureIdx << " is not a categorical feature");
+    CB_ENSURE_INTERNAL(hashedValues.size() == ObjectCount, "Wrong size of feature values");
+    slot.HashedCatValues = std::move(hashedValues);
+    UpdateTrees(slot);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <catboost/libs/data/objects.h>
+#include <catboost/libs/helpers/maybe.h>
+#include <catboost/libs/model/model.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+/*
+ * Evaluates raw formula values of an oblivious model on a fixed set of objects and keeps
+ * leaf indices of every tree for them. When values of one feature are replaced
+ * (imputed or permuted) only the trees with splits on this feature are re-evaluated
+ * and approxes are updated by the differences of leaf values.
+ *
+ * Only models with float and one-hot splits are supported (see IsSupported), values of
+ * ctrs and estimated features depend on several source features.
+ */
+class TMaskedModelEvaluator {
+public:
+    TMaskedModelEvaluator(const TFullModel& model, NPar::ILocalExecutor* localExecutor);
+
+    static bool IsSupported(const TFullModel& model);
+
+    bool IsFeatureUsed(ui32 flatFeatureIdx) const {
+        return FlatFeatureIdxToSlot.contains(flatFeatureIdx);
+    }
+
+    // calculates leaf indices and approxes for all trees, baseline is [approxIdx][objectIdx]
+    void SetObjects(
+        const NCB::TRawObjectsDataProvider& objectsData,
+        NCB::TMaybeData<TConstArrayRef<TConstArrayRef<float>>> baseline = Nothing());
+
+    // features must be used in model, values size must be equal to objects count
+    void UpdateFloatFeature(ui32 flatFeatureIdx, TVector<float>&& values);
+    void UpdateCatFeature(ui32 flatFeatureIdx, TVector<ui32>&& hashedValues);
+
+    // [approxIdx][objectIdx]
+    const TVector<TVector<double>>& GetApprox() const {
+        return Approx;
+    }
+
+    ui32 GetObjectCount() const {
+        return ObjectCount;
+    }
+
+private:
+    struct TFeatureSlot {
+        ui32 FlatFeatureIdx = 0;
+        bool IsCategorical = false;
+        TFloatFeature::ENanValueTreatment NanValueTreatment = TFloatFeature::ENanValueTreatment::AsIs;
+        TVector<float> FloatValues; // with nans substituted according to NanValueTreatment
+        TVector<ui32> HashedCatValues;
+        TVector<ui32> Trees; // trees with splits on this feature
+    };
+
+    struct TTreeSplit {
+        ui32 FeatureSlot = 0;
+        float Border = 0.0f; // for float features
+        int Value = 0; // for one-hot features
+    };
+
+private:
+    void SetFloatValues(TFeatureSlot* slot, TVector<float>&& values);
+    ui32 CalcLeafIndex(ui32 treeIdx, ui32 objectIdx) const;
+    void UpdateTrees(const TFeatureSlot& slot);
+
+private:
+    const TFullModel& Model;
+    NPar::ILocalExecutor* LocalExecutor;
+    int ApproxDimension = 1;
+    TVector<TFeatureSlot> FeatureSlots;
+    THashMap<ui32, ui32> FlatFeatureIdxToSlot;
+    TVector<TVector<TTreeSplit>> TreeSplits; // [treeIdx][depth]
+    TVector<const double*> TreeLeafValues; // [treeIdx] -> [leafIdx * ApproxDimension + dim]
+
+    ui32 ObjectCount = 0;
+    TVector<TVector<ui32>> LeafIndices; // [treeIdx][objectIdx]
+    TVector<TVector<double>> Approx;
+};
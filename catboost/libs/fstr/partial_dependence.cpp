@@ -5,183 +5,177 @@
 #include <catboost/libs/model/model.h>
 #include <catboost/private/libs/algo/apply.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 
 
 using namespace NCB;
 
 namespace {
-    struct TFloatFeatureBucketRange {
-        int FeatureIdx = -1;
-        int Start = 0;
-        int End = -1;
-        int NumOfBuckets = 0;
-
-        TFloatFeatureBucketRange() = default;
-
-        TFloatFeatureBucketRange(int featureIdx, int numOfBorders)
-                : FeatureIdx(featureIdx)
-                , Start(0)
-                , End(numOfBorders + 1)
-                , NumOfBuckets(numOfBorders + 1)
-        {
-        }
+    struct TPartialDependenceFeature {
+        bool IsOneHot = false;
+        int FeatureIdx = -1; // Position.Index of float or categorical feature
+        ui32 BucketCount = 0;
+        TConstArrayRef<float> Borders;
+        TConstArrayRef<int> OneHotValues;
+    };
 
-        void Update(int borderIdx, bool isGreater) {
-            if (isGreater && borderIdx >= Start) {
-                Start = borderIdx + 1;
-            } else if (!isGreater && borderIdx < End) {
-                End = borderIdx + 1;
-            }
+    // split on one of partial dependence features
+    struct TFeatureSplit {
+        int Feature = -1; // index in partial dependence features, -1 for other splits
+        ui32 BucketIdx = 0; // border index for float features, value index for one-hot features
+        bool IsOneHot = false;
+
+        bool IsTrue(ui32 bucket) const {
+            return IsOneHot ? bucket == BucketIdx : bucket > BucketIdx;
         }
     };
+
+    // contribution of a tree depends only on the decisions of its splits on partial dependence features
+    struct TTreePartialDependence {
+        TVector<TFeatureSplit> Splits;
+        TVector<double> Values; // [decisions mask], leaf values averaged over the other splits
+    };
 } //anonymous
 
-TVector<TFloatFeatureBucketRange> PrepareFeatureRanges(
-        const TFullModel& model,
-        const TVector<int>& featuresIdx
+static TVector<TPartialDependenceFeature> GetPartialDependenceFeatures(
+    const TFullModel& model,
+    const TVector<int>& features
 ) {
-    TVector<TFloatFeatureBucketRange> featureRanges(0);
-    if (featuresIdx.size() < 2) {
-        featureRanges.push_back(TFloatFeatureBucketRange(-1, 0));
-    }
-    for (int idx : featuresIdx) {
-        const auto& feature = model.ModelTrees->GetFloatFeatures()[idx];
-        const auto& range = TFloatFeatureBucketRange(feature.Position.Index, feature.Borders.size());
-        featureRanges.push_back(range);
+    CB_ENSURE(!features.empty(), "No features for partial dependence");
+    CB_ENSURE(
+        THashSet<int>(features.begin(), features.end()).size() == features.size(),
+        "Partial dependence features must be unique"
+    );
+    const auto& trees = *model.ModelTrees;
+    TVector<TPartialDependenceFeature> result;
+    for (int flatFeatureIdx : features) {
+        TPartialDependenceFeature feature;
+        const auto floatFeature = FindIf(trees.GetFloatFeatures(), [=] (const auto& floatFeature) {
+            return floatFeature.Position.FlatIndex == flatFeatureIdx;
+        });
+        const auto catFeature = FindIf(trees.GetCatFeatures(), [=] (const auto& catFeature) {
+            return catFeature.Position.FlatIndex == flatFeatureIdx;
+        });
+        if (floatFeature != trees.GetFloatFeatures().end()) {
+            feature.FeatureIdx = floatFeature->Position.Index;
+            feature.BucketCount = floatFeature->Borders.size() + 1;
+            feature.Borders = floatFeature->Borders;
+        } else {
+            CB_ENSURE(catFeature != trees.GetCatFeatures().end(), "Feature " << flatFeatureIdx << " is not used in model");
+            const auto oneHotFeature = FindIf(trees.GetOneHotFeatures(), [&] (const auto& oneHotFeature) {
+                return oneHotFeature.CatFeatureIndex == catFeature->Position.Index;
+            });
+            CB_ENSURE(
+                oneHotFeature != trees.GetOneHotFeatures().end(),
+                "Categorical feature " << flatFeatureIdx << " is not used in one-hot splits"
+            );
+            feature.IsOneHot = true;
+            feature.FeatureIdx = catFeature->Position.Index;
+            feature.BucketCount = oneHotFeature->Values.size() + 1;
+            feature.OneHotValues = oneHotFeature->Values;
+        }
+        for (const auto& ctrFeature : trees.GetCtrFeatures()) {
+            const auto& projection = ctrFeature.Ctr.Base.Projection;
+            const bool isUsedInCtr = feature.IsOneHot
+                ? (IsIn(projection.CatFeatures, feature.FeatureIdx)
+                    || AnyOf(projection.OneHotFeatures, [&] (const auto& split) { return split.CatFeatureIdx == feature.FeatureIdx; }))
+                : AnyOf(projection.BinFeatures, [&] (const auto& split) { return split.FloatFeature == feature.FeatureIdx; });
+            CB_ENSURE(!isUsedInCtr, "Features used in ctrs are not supported, feature " << flatFeatureIdx << " is used in ctr");
+        }
+        result.push_back(feature);
     }
-    return featureRanges;
+    return result;
 }
 
-TVector<TVector<TFloatFeatureBucketRange>> CalculateBucketRangesAndWeightsOblivious(
-        const TFullModel& model,
-        const TVector<int>& features,
-        const TVector<ui32>& borderIdxForSplit,
-        const TVector<double>& leafWeights,
-        TVector<double>* leafWeightsNew,
-        NPar::ILocalExecutor* localExecutor
+static TVector<TFeatureSplit> GetFeatureSplits(
+    const TFullModel& model,
+    TConstArrayRef<TPartialDependenceFeature> features
 ) {
-    CB_ENSURE_INTERNAL(model.IsOblivious(), "Partial dependence is supported only for symmetric trees");
-
-    const auto& binSplits = model.ModelTrees->GetBinFeatures();
-    const auto& treeSplitOffsets = model.ModelTrees->GetModelTreeData()->GetTreeStartOffsets();
-    auto applyData = model.ModelTrees->GetApplyData();
-    const auto& leafOffsets = applyData->TreeFirstLeafOffsets;
-    const auto& treeSizes = model.ModelTrees->GetModelTreeData()->GetTreeSizes();
-    const auto& treeSplits = model.ModelTrees->GetModelTreeData()->GetTreeSplits();
-    size_t leafNum = model.ModelTrees->GetModelTreeData()->GetLeafValues().size();
-
-    const TVector<TFloatFeatureBucketRange> defaultRanges = PrepareFeatureRanges(model, features);
-    TVector<TVector<TFloatFeatureBucketRange>> leafBucketRanges(leafNum, defaultRanges);
-
-    int treeCount = model.ModelTrees->GetTreeCount();
-    NPar::ILocalExecutor::TExecRangeParams blockParams(0, treeCount);
-    localExecutor->ExecRange([&] (size_t treeId) {
-        size_t offset = leafOffsets[treeId];
-        size_t treeDepth = treeSizes[treeId];
-        TVector<int> depthsToExplore;
-        TVector<int> splitsToExplore;
-        for (size_t depthIdx = 0; depthIdx < treeDepth; ++depthIdx) {
-            int splitIdx = treeSplits[treeSplitOffsets[treeId] + depthIdx];
-            const auto& split = binSplits[splitIdx];
-            if (std::find(features.begin(), features.end(), split.FloatFeature.FloatFeature) != features.end()) {
-                depthsToExplore.push_back(depthIdx);
-                splitsToExplore.push_back(splitIdx);
+    const auto binFeatures = model.ModelTrees->GetBinFeatures();
+    TVector<TFeatureSplit> result(binFeatures.size());
+    for (auto binFeatureIdx : xrange(binFeatures.size())) {
+        const auto& split = binFeatures[binFeatureIdx];
+        auto& featureSplit = result[binFeatureIdx];
+        for (auto featureIdx : xrange(features.size())) {
+            const auto& feature = features[featureIdx];
+            if (split.Type == ESplitType::FloatFeature && !feature.IsOneHot
+                && split.FloatFeature.FloatFeature == feature.FeatureIdx)
+            {
+                const auto border = LowerBound(feature.Borders.begin(), feature.Borders.end(), split.FloatFeature.Split);
+                CB_ENSURE_INTERNAL(
+                    border != feature.Borders.end() && *border == split.FloatFeature.Split,
+                    "Split border is not in feature borders"
+                );
+                featureSplit.Feature = featureIdx;
+                featureSplit.BucketIdx = border - feature.Borders.begin();
+            } else if (split.Type == ESplitType::OneHotFeature && feature.IsOneHot
+                && split.OneHotFeature.CatFeatureIdx == feature.FeatureIdx)
+            {
+                const auto value = Find(feature.OneHotValues, split.OneHotFeature.Value);
+                CB_ENSURE_INTERNAL(value != feature.OneHotValues.end(), "Split value is not in one-hot feature values");
+                featureSplit.Feature = featureIdx;
+                featureSplit.BucketIdx = value - feature.OneHotValues.begin();
+                featureSplit.IsOneHot = true;
             }
         }
-
-        for (size_t leafIdx = 0; leafIdx < 1 << treeDepth; ++leafIdx) {
-            for (int mask = 0; mask < 1 << depthsToExplore.size(); ++mask) {
-                TVector<TFloatFeatureBucketRange> featureRanges = defaultRanges;
-
-                int newLeafIdx = leafIdx;
-                for (size_t splitIdx = 0; splitIdx < splitsToExplore.size(); ++splitIdx) {
-                    int depth = depthsToExplore[splitIdx];
-                    int decision = (mask >> splitIdx) & 1;
-                    newLeafIdx = (newLeafIdx & ~(1UL << depth)) | (decision << depth);
-                    const auto& split = binSplits[splitsToExplore[splitIdx]];
-                    for (auto& range: featureRanges) {
-                        if (range.FeatureIdx == split.FloatFeature.FloatFeature) {
-                            int borderIdx = borderIdxForSplit[splitsToExplore[splitIdx]];
-                            range.Update(borderIdx, decision);
-                        }
-                    }
-                }
-                leafBucketRanges[offset + newLeafIdx] = featureRanges;
-                (*leafWeightsNew)[offset + leafIdx] += leafWeights[offset + newLeafIdx];
-            }
-        }
-    }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-
-    return leafBucketRanges;
+    }
+    return result;
 }
 
-TVector<double> MergeBucketRanges(
-        const TFullModel& model,
-        const TVector<int>& features,
-        const TDataProvider& dataProvider,
-        const TVector<TVector<TFloatFeatureBucketRange>>& leafBucketRanges,
-        const TVector<double> leafWeights
+static TTreePartialDependence CalcTreePartialDependence(
+    const TFullModel& model,
+    TConstArrayRef<TFeatureSplit> featureSplits,
+    TConstArrayRef<double> leafWeights,
+    size_t treeIdx
 ) {
-    const auto& leafValues = model.ModelTrees->GetModelTreeData()->GetLeafValues();
-    TVector<TFloatFeatureBucketRange> defaultRanges = PrepareFeatureRanges(model, features);
-    CB_ENSURE(defaultRanges.size() == 2, "Number of features must be 2");
-
-    int columnNum = defaultRanges[1].NumOfBuckets;
-    int rowNum = defaultRanges[0].NumOfBuckets;
-    int numOfBucketsTotal = rowNum * columnNum;
-    TVector<double> edges(numOfBucketsTotal);
-
-    for (size_t leafIdx = 0; leafIdx < leafValues.size(); ++leafIdx) {
-        const auto& ranges = leafBucketRanges[leafIdx];
-        double leafValue = leafValues[leafIdx];
-        for (int rowIdx = ranges[0].Start; rowIdx < ranges[0].End; ++rowIdx) {
-            if (ranges[1].Start < ranges[1].End) {
-                edges[rowIdx * columnNum + ranges[1].Start] += leafValue * leafWeights[leafIdx];
-                if (ranges[1].End != columnNum) {
-                    edges[rowIdx * columnNum + ranges[1].End] -= leafValue * leafWeights[leafIdx];
-                } else if (rowIdx < rowNum - 1) {
-                    edges[(rowIdx + 1) * columnNum] -= leafValue * leafWeights[leafIdx];
-                }
-            }
+    const auto& trees = *model.ModelTrees;
+    const auto treeSplits = trees.GetModelTreeData()->GetTreeSplits();
+    const size_t treeSplitsOffset = trees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx];
+    const size_t leafOffset = trees.GetApplyData()->TreeFirstLeafOffsets[treeIdx];
+    const int depth = trees.GetModelTreeData()->GetTreeSizes()[treeIdx];
+    const auto leafValues = trees.GetModelTreeData()->GetLeafValues().subspan(leafOffset, size_t(1) << depth);
+    const auto treeLeafWeights = leafWeights.subspan(leafOffset, size_t(1) << depth);
+
+    TTreePartialDependence result;
+    TVector<ui32> featureDepths;
+    ui32 featureDepthsMask = 0;
+    for (auto depthIdx : xrange(depth)) {
+        const auto& featureSplit = featureSplits[treeSplits[treeSplitsOffset + depthIdx]];
+        if (featureSplit.Feature >= 0) {
+            result.Splits.push_back(featureSplit);
+            featureDepths.push_back(depthIdx);
+            featureDepthsMask |= 1u << depthIdx;
         }
     }
 
-    TVector<double> predictionsByBuckets(numOfBucketsTotal);
-    double acc = 0;
-    for (int idx = 0; idx < numOfBucketsTotal; ++idx) {
-        acc += edges[idx];
-        predictionsByBuckets[idx] = acc;
+    // weight of objects with the same decisions of the other splits as the leaf
+    TVector<double> otherSplitsWeights(size_t(1) << depth, 0.0);
+    for (auto leafIdx : xrange(treeLeafWeights.size())) {
+        otherSplitsWeights[leafIdx & ~featureDepthsMask] += treeLeafWeights[leafIdx];
     }
-
-    size_t numOfDocuments = dataProvider.GetObjectCount();
-    for (size_t idx = 0; idx < predictionsByBuckets.size(); ++idx) {
-        predictionsByBuckets[idx] /= numOfDocuments;
+    result.Values.assign(size_t(1) << featureDepths.size(), 0.0);
+    for (auto leafIdx : xrange(leafValues.size())) {
+        ui32 decisions = 0;
+        for (auto splitIdx : xrange(featureDepths.size())) {
+            decisions |= ((leafIdx >> featureDepths[splitIdx]) & 1) << splitIdx;
+        }
+        result.Values[decisions] += leafValues[leafIdx] * otherSplitsWeights[leafIdx & ~featureDepthsMask];
     }
-    return predictionsByBuckets;
+    return result;
 }
 
-TVector<double> CalculatePartialDependence(
+TVector<ui32> GetPartialDependenceGridShape(
         const TFullModel& model,
-        const TVector<int>& features,
-        const TDataProvider& dataProvider,
-        const TVector<ui32>& borderIdxForSplit,
-        const TVector<double> leafWeights,
-        NPar::ILocalExecutor* localExecutor
+        const TVector<int>& features
 ) {
-    TVector<double> leafWeightsNew(leafWeights.size(), 0.0);
-    const auto& leafBucketRanges = CalculateBucketRangesAndWeightsOblivious(
-            model,
-            features,
-            borderIdxForSplit,
-            leafWeights,
-            &leafWeightsNew,
-            localExecutor
-    );
-
-    TVector<double> predictionsByBuckets = MergeBucketRanges(model, features, dataProvider, leafBucketRanges, leafWeightsNew);
-
-    return predictionsByBuckets;
+    TVector<ui32> shape;
+    for (const auto& feature : GetPartialDependenceFeatures(model, features)) {
+        shape.push_back(feature.BucketCount);
+    }
+    return shape;
 }
 
 TVector<double> GetPartialDependence(
@@ -191,43 +185,74 @@ TVector<double> GetPartialDependence(
         int threadCount
 ) {
     CB_ENSURE(model.ModelTrees->GetDimensionsCount() == 1,  "Is not supported for multiclass");
-    CB_ENSURE(model.GetNumCatFeatures() == 0, "Models with categorical features are not supported");
-    CB_ENSURE(features.size() > 0 && features.size() <= 2, "Number of features should be equal to one or two");
     //TODO(eermishkina): support non symmetric trees
     CB_ENSURE(model.IsOblivious(), "Partial dependence is supported only for symmetric trees");
 
+    const auto pdFeatures = GetPartialDependenceFeatures(model, features);
+    ui64 gridSize = 1;
+    for (const auto& feature : pdFeatures) {
+        gridSize *= feature.BucketCount;
+        CB_ENSURE(gridSize <= Max<ui32>(), "Partial dependence grid is too large");
+    }
+
     NPar::TLocalExecutor localExecutor;
     localExecutor.RunAdditionalThreads(threadCount - 1);
 
-    TVector<double> leafWeights = CollectLeavesStatistics(*dataProvider, model, &localExecutor);
+    const TVector<double> leafWeights = CollectLeavesStatistics(*dataProvider, model, &localExecutor);
+    const auto featureSplits = GetFeatureSplits(model, pdFeatures);
 
-    const auto& binSplits = model.ModelTrees->GetBinFeatures();
+    const size_t treeCount = model.GetTreeCount();
+    TVector<TTreePartialDependence> treeDependencies(treeCount);
+    localExecutor.ExecRangeWithThrow(
+        [&] (int treeIdx) {
+            treeDependencies[treeIdx] = CalcTreePartialDependence(model, featureSplits, leafWeights, treeIdx);
+        },
+        0,
+        SafeIntegerCast<int>(treeCount),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
 
-    TVector<ui32> borderIdxForSplit(binSplits.size(), std::numeric_limits<ui32>::infinity());
-    ui32 splitIdx = 0;
-    for (const auto& feature : model.ModelTrees->GetFloatFeatures()) {
-        if (splitIdx == binSplits.size() ||
-            binSplits[splitIdx].Type != ESplitType::FloatFeature ||
-            binSplits[splitIdx].FloatFeature.FloatFeature > feature.Position.Index
-                ) {
-            continue;
-        }
-        CB_ENSURE_INTERNAL(binSplits[splitIdx].FloatFeature.FloatFeature >= feature.Position.Index, "Only float features are supported");
-        for (ui32 idx = 0; idx < feature.Borders.size() && binSplits[splitIdx].FloatFeature.FloatFeature == feature.Position.Index; ++idx) {
-            if (abs(binSplits[splitIdx].FloatFeature.Split - feature.Borders[idx]) < 1e-15) {
-                borderIdxForSplit[splitIdx] = idx;
-                ++splitIdx;
-            }
+    // trees without splits on the features add the same value to all grid points
+    double constantPart = 0;
+    TVector<const TTreePartialDependence*> featureTrees;
+    for (const auto& treeDependence : treeDependencies) {
+        if (treeDependence.Splits.empty()) {
+            constantPart += treeDependence.Values[0];
+        } else {
+            featureTrees.push_back(&treeDependence);
         }
     }
 
-    TVector<double> predictionsByBuckets = CalculatePartialDependence(
-            model,
-            features,
-            *dataProvider,
-            borderIdxForSplit,
-            leafWeights,
-            &localExecutor
+    const size_t objectCount = dataProvider->GetObjectCount();
+    TVector<double> predictionsByBuckets(gridSize);
+    NPar::ILocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(gridSize));
+    blockParams.SetBlockCount(localExecutor.GetThreadCount() + 1);
+    localExecutor.ExecRangeWithThrow(
+        [&] (int blockIdx) {
+            const int blockBegin = blockParams.FirstId + blockIdx * blockParams.GetBlockSize();
+            const int blockEnd = Min(blockBegin + blockParams.GetBlockSize(), blockParams.LastId);
+            TVector<ui32> buckets(pdFeatures.size());
+            for (auto pointIdx : xrange(blockBegin, blockEnd)) {
+                // grid is in row-major order
+                for (ui32 rest = pointIdx, featureIdx = pdFeatures.size(); featureIdx > 0; --featureIdx) {
+                    buckets[featureIdx - 1] = rest % pdFeatures[featureIdx - 1].BucketCount;
+                    rest /= pdFeatures[featureIdx - 1].BucketCount;
+                }
+                double prediction = constantPart;
+                for (const auto* treeDependence : featureTrees) {
+                    ui32 decisions = 0;
+                    for (auto splitIdx : xrange(treeDependence->Splits.size())) {
+                        const auto& split = treeDependence->Splits[splitIdx];
+                        decisions |= ui32(split.IsTrue(buckets[split.Feature])) << splitIdx;
+                    }
+                    prediction += treeDependence->Values[decisions];
+                }
+                predictionsByBuckets[pointIdx] = prediction / objectCount;
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
     );
     return predictionsByBuckets;
 }
@@ -12,9 +12,22 @@
 #include <util/system/types.h>
 
 
+/*
+ * Average raw predictions of the model on the dataset with the features (flat indices of float features
+ * or categorical features with one-hot splits) set to every point of the grid of their buckets.
+ * Bucket j of a float feature is (border[j - 1], border[j]], bucket j of a one-hot feature is its
+ * j-th one-hot value and the last bucket is for all other values.
+ * The grid is flattened in row-major order, see GetPartialDependenceGridShape.
+ */
 TVector<double> GetPartialDependence(
         const TFullModel& model,
         const TVector<int>& features,
         const NCB::TDataProviderPtr dataProvider,
         int thread_count
 );
+
+// bucket counts of the features in the grid of GetPartialDependence
+TVector<ui32> GetPartialDependenceGridShape(
+        const TFullModel& model,
+        const TVector<int>& features
+);
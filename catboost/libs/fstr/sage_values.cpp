@@ -1,6 +1,7 @@
 #include "sage_values.h"
 
 #include "loss_change_fstr.h"
+#include "masked_model_evaluator.h"
 #include "util.h"
 
 #include <catboost/libs/data/features_layout.h>
@@ -123,10 +124,7 @@ public:
         for (auto [featureIndex, featureType] : features) {
             switch (featureType) {
                 case EFeatureType::Float: {
-                    TVector<float> values(objectsCount);
-                    for (auto& value: values) {
-                        value = ReferenceSamplesFloat[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
-                    }
+                    TVector<float> values = SampleFloatValues(featureIndex, objectsCount);
                     ui32 featureId = (*rawObjectsDataProviderPtr->GetFloatFeature(featureIndex))->GetId();
                     TFloatArrayValuesHolder floatValuesHolder(
                         featureId,
@@ -139,10 +137,7 @@ public:
                 }
 
                 case EFeatureType::Categorical: {
-                    TVector<ui32> values(objectsCount);
-                    for (auto& value: values) {
-                        value = ReferenceSamplesCategorical[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
-                    }
+                    TVector<ui32> values = SampleCatValues(featureIndex, objectsCount);
                     ui32 featureId = (*rawObjectsDataProviderPtr->GetCatFeature(featureIndex))->GetId();
                     THashedCatArrayValuesHolder catValuesHolder(
                         featureId,
@@ -192,6 +187,22 @@ public:
         }
     }
 
+    TVector<float> SampleFloatValues(ui32 featureIndex, ui32 objectsCount) {
+        TVector<float> values(objectsCount);
+        for (auto& value: values) {
+            value = ReferenceSamplesFloat[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
+        }
+        return values;
+    }
+
+    TVector<ui32> SampleCatValues(ui32 featureIndex, ui32 objectsCount) {
+        TVector<ui32> values(objectsCount);
+        for (auto& value: values) {
+            value = ReferenceSamplesCategorical[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
+        }
+        return values;
+    }
+
 private:
     TVector<TMaybeOwningArrayHolder<float>> ReferenceSamplesFloat;
     TVector<TMaybeOwningArrayHolder<ui32>> ReferenceSamplesCategorical;
@@ -307,6 +318,64 @@ double CalculateModelLoss(
     return estimator.GetMetricsScore()[0][0];
 }
 
+// equivalent to CalculateModelLoss after each imputation, but re-evaluates only trees with splits on imputed feature
+void CalcSageValueDeltasForBatch(
+    const TFullModel& model,
+    const TDataProvider& datasetBatch,
+    const TVector<std::pair<ui32, EFeatureType>>& featuresPermutation,
+    const NCatboostOptions::TLossDescription& metricDescription,
+    const IMetric& metric,
+    MarginalImputer* imputer,
+    TMaskedModelEvaluator* evaluator,
+    TRestorableFastRng64* randPtr,
+    NPar::ILocalExecutor* localExecutor,
+    TVector<TVector<double>>* sageValues)
+{
+    auto targetData = CreateModelCompatibleProcessedDataProvider(
+        datasetBatch,
+        { metricDescription },
+        model,
+        GetMonopolisticFreeCpuRam(),
+        randPtr,
+        localExecutor
+    ).TargetData;
+    const auto target = targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>());
+    const auto weights = GetWeights(*targetData);
+    const auto queriesInfo = targetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>());
+    const int blockCount = queriesInfo.empty() ? datasetBatch.GetObjectCount() : queriesInfo.size();
+    const auto& singleTargetEval = dynamic_cast<const ISingleTargetEval&>(metric);
+    const auto calcLoss = [&] () {
+        return metric.GetFinalError(
+            singleTargetEval.Eval(evaluator->GetApprox(), target, weights, queriesInfo, 0, blockCount, *localExecutor)
+        );
+    };
+
+    auto objectsPtr = dynamic_cast<const TRawObjectsDataProvider*>(datasetBatch.ObjectsData.Get());
+    CB_ENSURE_INTERNAL(objectsPtr, "Zero pointer to raw objects");
+    evaluator->SetObjects(*objectsPtr, targetData->GetBaseline());
+
+    const auto& featuresLayout = *datasetBatch.MetaInfo.FeaturesLayout;
+    const ui32 objectsCount = datasetBatch.GetObjectCount();
+    double previousLoss = calcLoss();
+    for (auto [featureIndex, featureType] : featuresPermutation) {
+        const ui32 externalFeatureIndex = featuresLayout.GetExternalFeatureIdx(featureIndex, featureType);
+        if (!evaluator->IsFeatureUsed(externalFeatureIndex)) {
+            // imputation does not change predictions
+            (*sageValues)[externalFeatureIndex].push_back(0.0);
+            continue;
+        }
+        if (featureType == EFeatureType::Float) {
+            evaluator->UpdateFloatFeature(externalFeatureIndex, imputer->SampleFloatValues(featureIndex, objectsCount));
+        } else {
+            CB_ENSURE_INTERNAL(featureType == EFeatureType::Categorical, "Unexpected feature type used in model");
+            evaluator->UpdateCatFeature(externalFeatureIndex, imputer->SampleCatValues(featureIndex, objectsCount));
+        }
+        const double currentLoss = calcLoss();
+        (*sageValues)[externalFeatureIndex].push_back(currentLoss - previousLoss);
+        previousLoss = currentLoss;
+    }
+}
+
 namespace Statistics {
 
 double Mean(const TVector<double>& values) {
@@ -377,6 +446,15 @@ TVector<TVector<double>> CalcSageValues(
 
     CB_ENSURE_INTERNAL(metric->IsAdditiveMetric(), "Loss function must be additive");
 
+    // models with only float and one-hot splits are re-evaluated incrementally
+    TMaybe<TMaskedModelEvaluator> maskedEvaluator;
+    if (TMaskedModelEvaluator::IsSupported(model)
+        && !needYetiRankPairs
+        && dynamic_cast<const ISingleTargetEval*>(metric.Get()))
+    {
+        maskedEvaluator.ConstructInPlace(model, localExecutor);
+    }
+
     TVector<THolder<IMetric>> metrics;
     metrics.push_back(std::move(metric));
 
@@ -395,17 +473,32 @@ TVector<TVector<double>> CalcSageValues(
         auto featuresPermutation = GenerateFeaturesPermutation(featuresLayout, &rand);
 
         // running approximation algorithm
-        double previousLoss = CalculateModelLoss(model, datasetBatch, metrics, &rand, localExecutor);
-        for (size_t j = 0; j < featuresCount; ++j) {
-            // preparing dataset, sampling disabled features
-            imputer.ImputeInplace({featuresPermutation[j]}, fullSubsetIndexingPtrWrapper, &datasetBatch);
-
-            // calculting loss and updating sage value
-            double currentLoss = CalculateModelLoss(model, datasetBatch, metrics, &rand, localExecutor);
-            ui32 externalFeatureIndex = featuresLayout->GetExternalFeatureIdx(featuresPermutation[j].first,
-                                                                              featuresPermutation[j].second);
-            sageValues[externalFeatureIndex].push_back(currentLoss - previousLoss);
-            previousLoss = currentLoss;
+        if (maskedEvaluator) {
+            CalcSageValueDeltasForBatch(
+                model,
+                datasetBatch,
+                featuresPermutation,
+                metricDescription,
+                *metrics[0],
+                &imputer,
+                maskedEvaluator.Get(),
+                &rand,
+                localExecutor,
+                &sageValues
+            );
+        } else {
+            double previousLoss = CalculateModelLoss(model, datasetBatch, metrics, &rand, localExecutor);
+            for (size_t j = 0; j < featuresCount; ++j) {
+                // preparing dataset, sampling disabled features
+                imputer.ImputeInplace({featuresPermutation[j]}, fullSubsetIndexingPtrWrapper, &datasetBatch);
+
+                // calculting loss and updating sage value
+                double currentLoss = CalculateModelLoss(model, datasetBatch, metrics, &rand, localExecutor);
+                ui32 externalFeatureIndex = featuresLayout->GetExternalFeatureIdx(featuresPermutation[j].first,
+                                                                                  featuresPermutation[j].second);
+                sageValues[externalFeatureIndex].push_back(currentLoss - previousLoss);
+                previousLoss = currentLoss;
+            }
         }
 
         // checking for convergence if needed
@@ -41,67 +41,96 @@ void ValidateFeatureInteractionParams(
     );
 }
 
-using TInteractionValuesSubset = THashMap<std::pair<size_t, size_t>, TVector<TVector<double>>>;
 using TInteractionValuesFull = TVector<TVector<TVector<TVector<double>>>>;
 
-template <typename TStorageType>
-TVector<TVector<double>>& GetDocumentsByClasses(TStorageType* rank4storage, size_t idx1, size_t idx2);
-
-template <typename TStorageType>
-const TVector<TVector<double>>& GetDocumentsByClasses(const TStorageType& rank4storage, size_t idx1, size_t idx2);
+// values for a pair of combination classes are stored in one buffer as [dim][documentIdx]
+static TVector<double> AllocatePairValues(size_t approxDimension, size_t documentCount, NPar::ILocalExecutor* localExecutor) {
+    TVector<double> values;
+    values.yresize(approxDimension * documentCount);
+    ParallelFill(0.0, /*blockSize*/ Nothing(), localExecutor, MakeArrayRef(values));
+    return values;
+}
 
-template <typename TStorageType>
-void AllocateStorage(
-    const TVector<size_t>& firstIndices,
-    const TVector<size_t>& secondIndices,
-    const size_t dim1,
-    const size_t dim2,
-    NPar::ILocalExecutor* localExecutor,
-    TStorageType* shapInteractionValuesInternal
-);
+/* Values for all pairs of combination classes.
+ * Interaction values are symmetric, so only pairs with classIdx1 <= classIdx2 are stored
+ * (packed upper triangle), values for (classIdx2, classIdx1) are the same buffer.
+ */
+class TInteractionValuesPacked {
+public:
+    TInteractionValuesPacked(
+        const TVector<size_t>& firstIndices,
+        const TVector<size_t>& secondIndices,
+        size_t approxDimension,
+        size_t documentCount,
+        NPar::ILocalExecutor* localExecutor
+    )
+        : ClassCount(firstIndices.size())
+    {
+        CB_ENSURE_INTERNAL(firstIndices.size() == secondIndices.size(), "Packed storage is only for all pairs of classes");
+        PairValues.resize(ClassCount * (ClassCount + 1) / 2);
+        for (auto& values : PairValues) {
+            values = AllocatePairValues(approxDimension, documentCount, localExecutor);
+        }
+    }
 
-template <>
-TVector<TVector<double>>& GetDocumentsByClasses(TInteractionValuesSubset* rank4storage, size_t idx1, size_t idx2) {
-    return rank4storage->at(std::make_pair(idx1, idx2));
-}
+    // the other half of pairs is filled by symmetry
+    bool NeedsValues(size_t classIdx1, size_t classIdx2) const {
+        return classIdx1 <= classIdx2;
+    }
 
-template <>
-TVector<TVector<double>>& GetDocumentsByClasses(TInteractionValuesFull* rank4storage, size_t idx1, size_t idx2) {
-    return rank4storage->at(idx1)[idx2];
-}
+    TArrayRef<double> GetValues(size_t classIdx1, size_t classIdx2) {
+        return PairValues[GetPairIdx(classIdx1, classIdx2)];
+    }
 
-template <>
-const TVector<TVector<double>>& GetDocumentsByClasses(const TInteractionValuesSubset& rank4storage, size_t idx1, size_t idx2) {
-    return rank4storage.at(std::make_pair(idx1, idx2));
-}
+    TConstArrayRef<double> GetValues(size_t classIdx1, size_t classIdx2) const {
+        return PairValues[GetPairIdx(classIdx1, classIdx2)];
+    }
 
-template <>
-const TVector<TVector<double>>& GetDocumentsByClasses(const TInteractionValuesFull& rank4storage, size_t idx1, size_t idx2) {
-    return rank4storage[idx1][idx2];
-}
+private:
+    size_t GetPairIdx(size_t classIdx1, size_t classIdx2) const {
+        if (classIdx1 > classIdx2) {
+            std::swap(classIdx1, classIdx2);
+        }
+        return classIdx1 * (2 * ClassCount - classIdx1 + 1) / 2 + (classIdx2 - classIdx1);
+    }
 
-template <>
-void AllocateStorage(
-    const TVector<size_t>& firstIndices,
-    const TVector<size_t>& secondIndices,
-    const size_t dim1,
-    const size_t dim2,
-    NPar::ILocalExecutor* localExecutor,
-    TInteractionValuesSubset* map
-) {
-    for (auto idx1 : firstIndices) {
-        for (auto idx2 : secondIndices) {
-            auto& value = (*map)[std::make_pair(idx1, idx2)];
-            value.resize(dim1);
-            ParallelFill(
-                TVector<double>(dim2, 0.0),
-                /*blockSize*/ Nothing(),
-                localExecutor,
-                MakeArrayRef(value)
-            );
+private:
+    size_t ClassCount;
+    TVector<TVector<double>> PairValues;
+};
+
+// values only for pairs of classes from firstIndices x secondIndices
+class TInteractionValuesSubset {
+public:
+    TInteractionValuesSubset(
+        const TVector<size_t>& firstIndices,
+        const TVector<size_t>& secondIndices,
+        size_t approxDimension,
+        size_t documentCount,
+        NPar::ILocalExecutor* localExecutor
+    ) {
+        for (auto idx1 : firstIndices) {
+            for (auto idx2 : secondIndices) {
+                PairValues[std::make_pair(idx1, idx2)] = AllocatePairValues(approxDimension, documentCount, localExecutor);
+            }
         }
     }
-}
+
+    bool NeedsValues(size_t classIdx1, size_t classIdx2) const {
+        return PairValues.contains(std::make_pair(classIdx1, classIdx2));
+    }
+
+    TArrayRef<double> GetValues(size_t classIdx1, size_t classIdx2) {
+        return PairValues.at(std::make_pair(classIdx1, classIdx2));
+    }
+
+    TConstArrayRef<double> GetValues(size_t classIdx1, size_t classIdx2) const {
+        return PairValues.at(std::make_pair(classIdx1, classIdx2));
+    }
+
+private:
+    THashMap<std::pair<size_t, size_t>, TVector<double>> PairValues;
+};
 
 static inline void Allocate4DimensionalVector(
     const size_t dim1,
@@ -126,30 +155,18 @@ static inline void Allocate4DimensionalVector(
     }
 }
 
-template <>
-void AllocateStorage(
-    const TVector<size_t>& firstIndices,
-    const TVector<size_t>& secondIndices,
-    const size_t dim1,
-    const size_t dim2,
-    NPar::ILocalExecutor* localExecutor,
-    TInteractionValuesFull* vector
-) {
-    Allocate4DimensionalVector(firstIndices.size(), secondIndices.size(), dim1, dim2, localExecutor, vector);
-}
-
+// pairValues are [dim][documentIdx]
 static inline void AddValuesAllDocuments(
-    const TVector<TVector<double>>& valuesBetweenClasses,
+    TConstArrayRef<double> pairValues,
     double coefficient,
     TVector<TVector<double>>* valuesBetweenFeatures
 ) {
-    const size_t documentCount = valuesBetweenClasses[0].size();
-    for (int dimension : xrange(valuesBetweenClasses.size())) {
-        TConstArrayRef<double> valuesBetweenClassesRef = MakeConstArrayRef(valuesBetweenClasses.at(dimension));
+    const size_t documentCount = (*valuesBetweenFeatures)[0].size();
+    for (size_t dimension : xrange(valuesBetweenFeatures->size())) {
+        TConstArrayRef<double> pairValuesRef = pairValues.subspan(dimension * documentCount, documentCount);
         TArrayRef<double> valueBetweenFeaturesRef = MakeArrayRef((*valuesBetweenFeatures)[dimension]);
         for (size_t documentIdx : xrange(documentCount)) {
-            double effect = valuesBetweenClassesRef[documentIdx] * coefficient;
-            valueBetweenFeaturesRef[documentIdx] += effect;
+            valueBetweenFeaturesRef[documentIdx] += pairValuesRef[documentIdx] * coefficient;
         }
     }
 }
@@ -165,7 +182,7 @@ static void UnpackInternalShapInteractionValues(
 ) {
     for (size_t classIdx1 : classIndicesFirst) {
         for (size_t classIdx2 : classIndicesSecond) {
-            const auto& documentsByClasses = GetDocumentsByClasses(shapInteractionValuesInternal, classIdx1, classIdx2);
+            const auto documentsByClasses = shapInteractionValuesInternal.GetValues(classIdx1, classIdx2);
             if (classIdx1 == classIdx2) {
                 // unpack main effect
                 double coefficientForMainEffect = 1.0 / rescaleCoefficients[classIdx1];
@@ -250,31 +267,40 @@ static inline double GetInteractionEffect(double contribOn, double contribOff) {
     return (contribOn - contribOff) / 2.0;
 }
 
-static inline void AddInteractionEffectAllDocumentsForPairClasses(
+// Φ(i,j) for documents [begin, end), values are [dim][documentIdx]
+static inline void SetInteractionEffect(
     const TVector<TVector<double>>& contribsOnByClass,
     const TVector<TVector<double>>& contribsOffByClass,
-    bool isSameClasses,
-    bool isSecondFeature,
-    bool isCalcMainEffect,
-    TVector<TVector<double>>* valuesBetweenDifferentClasses,
-    TVector<TVector<double>>* valuesBetweenSameClasses
+    size_t begin,
+    size_t end,
+    TArrayRef<double> valuesBetweenDifferentClasses
 ) {
-    if (isSameClasses) {
-        return;
+    const size_t documentCount = contribsOnByClass[0].size();
+    for (size_t dimension : xrange(contribsOnByClass.size())) {
+        TConstArrayRef<double> contribsOnByClassRef = contribsOnByClass[dimension];
+        TConstArrayRef<double> contribsOffByClassRef = contribsOffByClass[dimension];
+        double* valuesRef = valuesBetweenDifferentClasses.data() + dimension * documentCount;
+        for (size_t documentIdx : xrange(begin, end)) {
+            valuesRef[documentIdx] = GetInteractionEffect(contribsOnByClassRef[documentIdx], contribsOffByClassRef[documentIdx]);
+        }
     }
+}
+
+// Φ(i,i) -= Φ(i,j) for documents [begin, end), values are [dim][documentIdx]
+static inline void SubtractInteractionEffect(
+    const TVector<TVector<double>>& contribsOnByClass,
+    const TVector<TVector<double>>& contribsOffByClass,
+    size_t begin,
+    size_t end,
+    TArrayRef<double> valuesBetweenSameClasses
+) {
+    const size_t documentCount = contribsOnByClass[0].size();
     for (size_t dimension : xrange(contribsOnByClass.size())) {
-        TConstArrayRef<double> contribsOnByClassRef = MakeConstArrayRef(contribsOnByClass.at(dimension));
-        TConstArrayRef<double> contribsOffByClassRef = MakeConstArrayRef(contribsOffByClass.at(dimension));
-        TArrayRef<double> valuesBetweenDifferentClassesRef = MakeArrayRef((*valuesBetweenDifferentClasses)[dimension]);
-        TArrayRef<double> valuesBetweenSameClassesRef = MakeArrayRef((*valuesBetweenSameClasses)[dimension]);
-        for (size_t documentIdx : xrange(contribsOnByClass[dimension].size())) {
-            double interactionEffect = GetInteractionEffect(contribsOnByClassRef[documentIdx], contribsOffByClassRef[documentIdx]);
-            if (isSecondFeature) {
-                valuesBetweenDifferentClassesRef[documentIdx] = interactionEffect;
-            }
-            if (isCalcMainEffect) {
-                valuesBetweenSameClassesRef[documentIdx] -= interactionEffect;
-            }
+        TConstArrayRef<double> contribsOnByClassRef = contribsOnByClass[dimension];
+        TConstArrayRef<double> contribsOffByClassRef = contribsOffByClass[dimension];
+        double* valuesRef = valuesBetweenSameClasses.data() + dimension * documentCount;
+        for (size_t documentIdx : xrange(begin, end)) {
+            valuesRef[documentIdx] -= GetInteractionEffect(contribsOnByClassRef[documentIdx], contribsOffByClassRef[documentIdx]);
         }
     }
 }
@@ -299,11 +325,9 @@ static void CalcInternalShapInteractionValuesMulti(
     const auto& combinationClassFeatures = preparedTrees->CombinationClassFeatures;
     const size_t classCount = combinationClassFeatures.size();
     const auto& sameClassIndices = IntersectClasses(classIndicesFirst, classIndicesSecond);
-    // contruct vector of indices with same class and second feature indices
+    // contruct vector of indices with same class
     TVector<bool> isSameClassIdx(classCount, false);
-    TVector<bool> isSecondFeatureIdx(classCount, false);
     FillIndices(sameClassIndices, &isSameClassIdx);
-    FillIndices(classIndicesSecond, &isSecondFeatureIdx);
     // calc shap values
     const auto& shapValuesInternal = CalcShapValueWithQuantizedData(
         model,
@@ -316,19 +340,20 @@ static void CalcInternalShapInteractionValuesMulti(
         localExecutor,
         calcType
     );
-    const int approxDimension = model.GetDimensionsCount();
-    TVector<TVector<double>> emptyVector(approxDimension);
     // Φ(i,i) = ϕ(i) − sum(Φ(i,j)) i.e reducing path of sum
     // because in the first to add ф(i)
     for (size_t classIdx : xrange(sameClassIndices.size())) {
         const auto sameClassIdx = sameClassIndices[classIdx];
-        auto& valuesBetweenClasses = GetDocumentsByClasses(shapInteractionValuesInternal, sameClassIdx, sameClassIdx);
-        AddValuesAllDocuments(
-            shapValuesInternal[sameClassIdx],
-            /*coefficient*/ 1.0,
-            &valuesBetweenClasses
-        );
+        auto valuesBetweenClasses = shapInteractionValuesInternal->GetValues(sameClassIdx, sameClassIdx);
+        for (size_t dimension : xrange(shapValuesInternal[sameClassIdx].size())) {
+            const auto& shapValuesForDimension = shapValuesInternal[sameClassIdx][dimension];
+            for (size_t documentIdx : xrange(documentCount)) {
+                valuesBetweenClasses[dimension * documentCount + documentIdx] += shapValuesForDimension[documentIdx];
+            }
+        }
     }
+    NPar::ILocalExecutor::TExecRangeParams documentBlockParams(0, SafeIntegerCast<int>(documentCount));
+    documentBlockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
     // calculate shap interaction values
     // Katsushige Fujimoto, Ivan Kojadinovic, and Jean-Luc Marichal. 2006. Axiomatic
     // characterizations of probabilistic and cardinal-probabilistic interaction indices.
@@ -356,33 +381,55 @@ static void CalcInternalShapInteractionValuesMulti(
             localExecutor,
             calcType
         );
+        // pairs that need values, others are either not requested or filled by symmetry
+        TVector<size_t> pairClassIndices;
+        for (size_t classIdx2 : classIndicesSecond) {
+            if (classIdx2 != classIdx1 && shapInteractionValuesInternal->NeedsValues(classIdx1, classIdx2)) {
+                pairClassIndices.push_back(classIdx2);
+            }
+        }
         // if needed calculate Ф(i, i) then to calculate all Ф(i, j) where i != j
         // Φ(i,i) = ϕ(i) − sum(Φ(i,j)) i.e reducing path of sum
+        TArrayRef<double> valuesBetweenSameClasses;
         if (isSameClassIdx[classIdx1]) {
-            for (size_t classIdx2 : xrange(classCount)) {
-                AddInteractionEffectAllDocumentsForPairClasses(
-                    contribsOn[classIdx2],
-                    contribsOff[classIdx2],
-                    /*isSameClasses*/ (classIdx2 == classIdx1),
-                    isSecondFeatureIdx[classIdx2],
-                    /*isCalcMainEffect*/ true,
-                    isSecondFeatureIdx[classIdx2] ? &GetDocumentsByClasses(shapInteractionValuesInternal, classIdx1, classIdx2) : &emptyVector,
-                    &GetDocumentsByClasses(shapInteractionValuesInternal, classIdx1, classIdx1)
-                );
-            }
-        } else {
-            for (size_t classIdx2 : classIndicesSecond) {
-                AddInteractionEffectAllDocumentsForPairClasses(
-                    contribsOn[classIdx2],
-                    contribsOff[classIdx2],
-                    /*isSameClasses*/ (classIdx2 == classIdx1),
-                    /*isSecondFeature*/ true,
-                    /*isCalcMainEffect*/ false,
-                    &GetDocumentsByClasses(shapInteractionValuesInternal, classIdx1, classIdx2),
-                    /*valuesBetweenSameClasses*/ &emptyVector
-                );
-            }
+            valuesBetweenSameClasses = shapInteractionValuesInternal->GetValues(classIdx1, classIdx1);
+        }
+        TVector<TArrayRef<double>> valuesBetweenDifferentClasses;
+        for (size_t classIdx2 : pairClassIndices) {
+            valuesBetweenDifferentClasses.push_back(shapInteractionValuesInternal->GetValues(classIdx1, classIdx2));
         }
+        localExecutor->ExecRange(
+            [&] (int blockIdx) {
+                const size_t begin = documentBlockParams.FirstId + blockIdx * documentBlockParams.GetBlockSize();
+                const size_t end = Min<size_t>(begin + documentBlockParams.GetBlockSize(), documentBlockParams.LastId);
+                for (auto pairIdx : xrange(pairClassIndices.size())) {
+                    const size_t classIdx2 = pairClassIndices[pairIdx];
+                    SetInteractionEffect(
+                        contribsOn[classIdx2],
+                        contribsOff[classIdx2],
+                        begin,
+                        end,
+                        valuesBetweenDifferentClasses[pairIdx]
+                    );
+                }
+                if (isSameClassIdx[classIdx1]) {
+                    for (size_t classIdx2 : xrange(classCount)) {
+                        if (classIdx2 != classIdx1) {
+                            SubtractInteractionEffect(
+                                contribsOn[classIdx2],
+                                contribsOff[classIdx2],
+                                begin,
+                                end,
+                                valuesBetweenSameClasses
+                            );
+                        }
+                    }
+                }
+            },
+            0,
+            documentBlockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
     }
 }
 
@@ -486,14 +533,12 @@ static void CalcShapInteraction(
     );
     const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
     const size_t approxDimension = model.GetDimensionsCount();
-    TStorageType shapInteractionValuesInternal;
-    AllocateStorage(
+    TStorageType shapInteractionValuesInternal(
         classIndicesFirst,
         classIndicesSecond,
         approxDimension,
         documentCount,
-        localExecutor,
-        &shapInteractionValuesInternal
+        localExecutor
     );
     CalcInternalShapInteractionValuesMulti(
         model,
@@ -579,7 +624,7 @@ TInteractionValuesFull CalcShapInteractionValuesWithPreparedTrees(
             SetSymmetricValues(&shapInteractionValues);
         }
     } else {
-        CalcShapInteraction<TInteractionValuesFull>(
+        CalcShapInteraction<TInteractionValuesPacked>(
             model,
             dataset,
             pairOfFeatures,
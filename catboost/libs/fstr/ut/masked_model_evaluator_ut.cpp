@@ -0,0 +1,185 @@
+#include <catboost/libs/fstr/masked_model_evaluator.h>
+
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/train_lib/train_model.h>
+#include <catboost/private/libs/algo/apply.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/random/shuffle.h>
+#include <util/string/cast.h>
+
+#include <limits>
+
+
+using namespace NCB;
+
+
+namespace {
+    struct TSrcFeatures {
+        TVector<TVector<float>> FloatFeatures; // flat indices 0 and 1
+        TVector<TString> CatFeature; // flat index 2
+        TVector<float> Target;
+    };
+}
+
+static TSrcFeatures GenerateFeatures(ui32 objectCount, ui64 seed) {
+    TFastRng<ui64> prng(seed);
+    TSrcFeatures features;
+    features.FloatFeatures.assign(2, TVector<float>(objectCount));
+    features.CatFeature.resize(objectCount);
+    features.Target.resize(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        for (auto& floatFeature : features.FloatFeatures) {
+            floatFeature[objectIdx] = prng.GenRandReal1();
+        }
+        const ui32 catValue = prng.Uniform(4);
+        features.CatFeature[objectIdx] = ToString(catValue);
+        features.Target[objectIdx] = features.FloatFeatures[0][objectIdx]
+            - 2 * features.FloatFeatures[1][objectIdx]
+            + (catValue == 1 ? 1.0f : 0.0f)
+            + 0.1 * prng.GenRandReal1();
+        // so that the model has nan treatment for this feature
+        if (objectIdx % 7 == 0) {
+            features.FloatFeatures[1][objectIdx] = std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    return features;
+}
+
+static TDataProviderPtr CreatePool(const TSrcFeatures& features) {
+    const ui32 objectCount = features.Target.size();
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.TargetType = ERawTargetType::Float;
+            metaInfo.TargetCount = 1;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                (ui32)3,
+                TVector<ui32>{2},
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto featureIdx : xrange(2)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features.FloatFeatures[featureIdx]))
+                );
+            }
+            visitor->AddCatFeature(2, TConstArrayRef<TString>(features.CatFeature));
+            visitor->AddTarget(MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features.Target)));
+
+            visitor->Finish();
+        }
+    );
+}
+
+static TFullModel TrainSmallModel(const TSrcFeatures& features, int oneHotMaxSize) {
+    TTempDir trainDir;
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = CreatePool(features);
+    dataProviders.Test.push_back(dataProviders.Learn);
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 20);
+    params.InsertValue("depth", 4);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", trainDir.Name());
+    params.InsertValue("one_hot_max_size", oneHotMaxSize);
+    TrainModel(
+        params,
+        nullptr,
+        {},
+        {},
+        Nothing(),
+        std::move(dataProviders),
+        /*initModel*/ Nothing(),
+        /*initLearnProgress*/ nullptr,
+        "",
+        &model,
+        {&evalResult}
+    );
+    return model;
+}
+
+static const TRawObjectsDataProvider& GetRawObjects(const TDataProviderPtr& pool) {
+    const auto* rawObjects = dynamic_cast<const TRawObjectsDataProvider*>(pool->ObjectsData.Get());
+    UNIT_ASSERT(rawObjects);
+    return *rawObjects;
+}
+
+static void AssertEqualApprox(
+    const TVector<TVector<double>>& approx,
+    const TFullModel& model,
+    const TDataProviderPtr& pool,
+    NPar::ILocalExecutor* localExecutor
+) {
+    const auto expectedApprox = ApplyModelMulti(
+        model,
+        *pool->ObjectsData,
+        EPredictionType::RawFormulaVal,
+        0,
+        0,
+        localExecutor
+    );
+    UNIT_ASSERT_VALUES_EQUAL(approx.size(), expectedApprox.size());
+    for (auto dim : xrange(approx.size())) {
+        UNIT_ASSERT_VALUES_EQUAL(approx[dim].size(), expectedApprox[dim].size());
+        for (auto objectIdx : xrange(approx[dim].size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(approx[dim][objectIdx], expectedApprox[dim][objectIdx], 1e-9);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TMaskedModelEvaluatorTest) {
+    Y_UNIT_TEST(CtrModelIsNotSupported) {
+        const auto features = GenerateFeatures(300, 20240601);
+        const auto model = TrainSmallModel(features, /*oneHotMaxSize*/ 1);
+        UNIT_ASSERT(!model.ModelTrees->GetApplyData()->UsedModelCtrs.empty());
+        UNIT_ASSERT(!TMaskedModelEvaluator::IsSupported(model));
+    }
+
+    Y_UNIT_TEST(UpdatesMatchFullApply) {
+        auto features = GenerateFeatures(300, 20240601);
+        const auto model = TrainSmallModel(features, /*oneHotMaxSize*/ 10);
+        UNIT_ASSERT(TMaskedModelEvaluator::IsSupported(model));
+        UNIT_ASSERT(model.ModelTrees->GetApplyData()->UsedModelCtrs.empty());
+        UNIT_ASSERT(model.GetNumCatFeatures() > 0);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TMaskedModelEvaluator evaluator(model, &localExecutor);
+        UNIT_ASSERT(evaluator.IsFeatureUsed(0));
+        UNIT_ASSERT(evaluator.IsFeatureUsed(1));
+        UNIT_ASSERT(evaluator.IsFeatureUsed(2));
+
+        evaluator.SetObjects(GetRawObjects(CreatePool(features)));
+        AssertEqualApprox(evaluator.GetApprox(), model, CreatePool(features), &localExecutor);
+
+        // updates are cumulative: only trees with splits on the updated feature are re-evaluated
+        TFastRng<ui64> prng(42);
+        Shuffle(features.FloatFeatures[0].begin(), features.FloatFeatures[0].end(), prng);
+        evaluator.UpdateFloatFeature(0, TVector<float>(features.FloatFeatures[0]));
+        AssertEqualApprox(evaluator.GetApprox(), model, CreatePool(features), &localExecutor);
+
+        Shuffle(features.CatFeature.begin(), features.CatFeature.end(), prng);
+        const auto pool = CreatePool(features);
+        const auto hashedCatValues = (*GetRawObjects(pool).GetCatFeature(0))->ExtractValues(&localExecutor);
+        evaluator.UpdateCatFeature(2, TVector<ui32>(hashedCatValues.begin(), hashedCatValues.end()));
+        AssertEqualApprox(evaluator.GetApprox(), model, pool, &localExecutor);
+
+        // nans are substituted in the same way as in model binarization
+        Shuffle(features.FloatFeatures[1].begin(), features.FloatFeatures[1].end(), prng);
+        evaluator.UpdateFloatFeature(1, TVector<float>(features.FloatFeatures[1]));
+        AssertEqualApprox(evaluator.GetApprox(), model, CreatePool(features), &localExecutor);
+    }
+}
@@ -0,0 +1,208 @@
+#include <catboost/libs/fstr/partial_dependence.h>
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/train_lib/train_model.h>
+#include <catboost/private/libs/algo/apply.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/string/cast.h>
+
+
+using namespace NCB;
+
+
+static const ui32 FloatFeatureCount = 3;
+static const ui32 CatFeatureFlatIdx = 3;
+
+namespace {
+    struct TSrcFeatures {
+        TVector<TVector<float>> FloatFeatures; // flat indices 0, 1, 2
+        TVector<TString> CatFeature; // flat index 3
+        TVector<float> Target;
+    };
+}
+
+static TSrcFeatures GenerateFeatures(ui32 objectCount, ui64 seed) {
+    TFastRng<ui64> prng(seed);
+    TSrcFeatures features;
+    features.FloatFeatures.assign(FloatFeatureCount, TVector<float>(objectCount));
+    features.CatFeature.resize(objectCount);
+    features.Target.resize(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        for (auto& floatFeature : features.FloatFeatures) {
+            floatFeature[objectIdx] = prng.GenRandReal1();
+        }
+        const ui32 catValue = prng.Uniform(4);
+        features.CatFeature[objectIdx] = ToString(catValue);
+        const auto& floatFeatures = features.FloatFeatures;
+        features.Target[objectIdx] = floatFeatures[0][objectIdx] * (1 + floatFeatures[1][objectIdx])
+            - floatFeatures[2][objectIdx]
+            + (catValue == 1 ? 1.0f : 0.0f)
+            + 0.1 * prng.GenRandReal1();
+    }
+    return features;
+}
+
+static TDataProviderPtr CreatePool(const TSrcFeatures& features) {
+    const ui32 objectCount = features.Target.size();
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.TargetType = ERawTargetType::Float;
+            metaInfo.TargetCount = 1;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                FloatFeatureCount + 1,
+                TVector<ui32>{CatFeatureFlatIdx},
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto featureIdx : xrange(FloatFeatureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features.FloatFeatures[featureIdx]))
+                );
+            }
+            visitor->AddCatFeature(CatFeatureFlatIdx, TConstArrayRef<TString>(features.CatFeature));
+            visitor->AddTarget(MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features.Target)));
+
+            visitor->Finish();
+        }
+    );
+}
+
+static TFullModel TrainSmallModel(const TSrcFeatures& features) {
+    TTempDir trainDir;
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = CreatePool(features);
+    dataProviders.Test.push_back(dataProviders.Learn);
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 30);
+    params.InsertValue("depth", 4);
+    params.InsertValue("border_count", 4);
+    params.InsertValue("one_hot_max_size", 10);
+    // partial dependence is an average of tree sums without the bias
+    params.InsertValue("boost_from_average", false);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", trainDir.Name());
+    TrainModel(
+        params,
+        nullptr,
+        {},
+        {},
+        Nothing(),
+        std::move(dataProviders),
+        /*initModel*/ Nothing(),
+        /*initLearnProgress*/ nullptr,
+        "",
+        &model,
+        {&evalResult}
+    );
+    return model;
+}
+
+// feature values that fall into each of the buckets of the partial dependence grid
+static TVector<float> GetFloatBucketValues(const TFullModel& model, int flatFeatureIdx) {
+    const auto floatFeature = FindIf(model.ModelTrees->GetFloatFeatures(), [=] (const auto& feature) {
+        return feature.Position.FlatIndex == flatFeatureIdx;
+    });
+    UNIT_ASSERT(floatFeature != model.ModelTrees->GetFloatFeatures().end());
+    const auto& borders = floatFeature->Borders;
+    UNIT_ASSERT(!borders.empty());
+    // bucket j is (border[j - 1], border[j]]
+    TVector<float> values(borders.begin(), borders.end());
+    values.push_back(borders.back() + 1);
+    return values;
+}
+
+static TVector<TString> GetOneHotBucketValues(const TFullModel& model, const TSrcFeatures& features) {
+    UNIT_ASSERT_VALUES_EQUAL(model.ModelTrees->GetOneHotFeatures().size(), 1);
+    const auto& oneHotFeature = model.ModelTrees->GetOneHotFeatures()[0];
+    TVector<TString> values;
+    for (int hash : oneHotFeature.Values) {
+        const auto value = FindIf(features.CatFeature, [=] (const TString& value) {
+            return CalcCatFeatureHashInt(value) == hash;
+        });
+        UNIT_ASSERT(value != features.CatFeature.end());
+        values.push_back(*value);
+    }
+    // the last bucket is for all other values
+    values.push_back("unseen");
+    return values;
+}
+
+static void CheckPartialDependence(const TFullModel& model, const TSrcFeatures& features, const TVector<int>& pdFeatures) {
+    const auto pool = CreatePool(features);
+    const auto partialDependence = GetPartialDependence(model, pdFeatures, pool, /*threadCount*/ 4);
+    const auto gridShape = GetPartialDependenceGridShape(model, pdFeatures);
+    UNIT_ASSERT_VALUES_EQUAL(gridShape.size(), pdFeatures.size());
+
+    TVector<TVector<float>> floatBucketValues(pdFeatures.size());
+    TVector<TString> oneHotBucketValues;
+    size_t gridSize = 1;
+    for (auto i : xrange(pdFeatures.size())) {
+        if ((ui32)pdFeatures[i] == CatFeatureFlatIdx) {
+            oneHotBucketValues = GetOneHotBucketValues(model, features);
+            UNIT_ASSERT_VALUES_EQUAL(gridShape[i], oneHotBucketValues.size());
+        } else {
+            floatBucketValues[i] = GetFloatBucketValues(model, pdFeatures[i]);
+            UNIT_ASSERT_VALUES_EQUAL(gridShape[i], floatBucketValues[i].size());
+        }
+        gridSize *= gridShape[i];
+    }
+    UNIT_ASSERT_VALUES_EQUAL(partialDependence.size(), gridSize);
+
+    NPar::TLocalExecutor localExecutor;
+    const ui32 objectCount = features.Target.size();
+    for (auto pointIdx : xrange(gridSize)) {
+        // grid is in row-major order
+        auto pointFeatures = features;
+        for (size_t rest = pointIdx, i = pdFeatures.size(); i > 0; --i) {
+            const ui32 bucket = rest % gridShape[i - 1];
+            rest /= gridShape[i - 1];
+            if ((ui32)pdFeatures[i - 1] == CatFeatureFlatIdx) {
+                Fill(pointFeatures.CatFeature.begin(), pointFeatures.CatFeature.end(), oneHotBucketValues[bucket]);
+            } else {
+                auto& floatFeature = pointFeatures.FloatFeatures[pdFeatures[i - 1]];
+                Fill(floatFeature.begin(), floatFeature.end(), floatBucketValues[i - 1][bucket]);
+            }
+        }
+        const auto approx = ApplyModelMulti(
+            model,
+            *CreatePool(pointFeatures)->ObjectsData,
+            EPredictionType::RawFormulaVal,
+            0,
+            0,
+            &localExecutor
+        );
+        double expected = 0;
+        for (auto value : approx[0]) {
+            expected += value;
+        }
+        expected /= objectCount;
+        UNIT_ASSERT_DOUBLES_EQUAL(partialDependence[pointIdx], expected, 1e-9);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TPartialDependenceTest) {
+    Y_UNIT_TEST(MatchesBruteForce) {
+        const auto features = GenerateFeatures(200, 20240701);
+        const auto model = TrainSmallModel(features);
+        UNIT_ASSERT(model.ModelTrees->GetApplyData()->UsedModelCtrs.empty());
+
+        CheckPartialDependence(model, features, {0, 1, 2});
+        CheckPartialDependence(model, features, {(int)CatFeatureFlatIdx});
+        CheckPartialDependence(model, features, {(int)CatFeatureFlatIdx, 1});
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    // lookup counters of a cache, summed over threads or shards with +=
+    struct TCacheStats {
+        ui64 HitCount = 0;
+        ui64 MissCount = 0;
+
+    public:
+        TCacheStats& operator+=(const TCacheStats& rhs) {
+            HitCount += rhs.HitCount;
+            MissCount += rhs.MissCount;
+            return *this;
+        }
+
+        double GetHitRate() const {
+            const ui64 lookupCount = HitCount + MissCount;
+            return lookupCount ? double(HitCount) / lookupCount : 0.0;
+        }
+    };
+
+}
@@ -6,6 +6,7 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/algorithm.h>
 #include <util/generic/bitops.h>
+#include <util/system/compiler.h>
 
 namespace NCatboost {
 
@@ -57,6 +58,11 @@ namespace NCatboost {
             return NotFoundIndex;
         }
 
+        // fetch the first bucket probed by GetIndex(idx) into cache in advance
+        void PrefetchIndex(ui64 idx) const {
+            Y_PREFETCH_READ(Buckets.data() + (idx & HashMask), 3);
+        }
+
         size_t CountNonEmptyBuckets() const {
             return CountIf(
                 Buckets,
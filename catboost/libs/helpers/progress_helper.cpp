@@ -1,2 +1,28 @@
 #include "progress_helper.h"
 
+
+void TBackgroundProgressWriter::WriteFile(const TFsPath& path) {
+    const TFsPath backupPath = path.GetPath() + ".bak";
+    try {
+        Md5 = Helper.WriteOrThrow(backupPath, [&] (IOutputStream* out) {
+            out->Write(Progress.Data(), Progress.Size());
+        });
+        backupPath.ForceRenameTo(path.GetPath());
+    } catch (...) {
+        Error = CurrentExceptionMessage();
+    }
+}
+
+void TBackgroundProgressWriter::Finish() {
+    if (!WriterThread) {
+        return;
+    }
+    WriterThread->join();
+    WriterThread.Destroy();
+    if (Error) {
+        Helper.LogFailed(*Error);
+    } else {
+        Helper.LogSaved(Md5);
+    }
+    Error.Clear();
+}
@@ -4,15 +4,22 @@
 
 #include <catboost/libs/logging/logging.h>
 
+#include <util/stream/buffer.h>
 #include <util/stream/output.h>
 #include <util/stream/file.h>
 #include <util/folder/path.h>
+#include <util/generic/buffer.h>
 #include <util/generic/guid.h>
+#include <util/generic/maybe.h>
+#include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
 #include <util/system/fs.h>
 #include <util/ysaveload.h>
 
 #include <library/cpp/digest/md5/md5.h>
 
+#include <thread>
+
 class TMD5Output : public IOutputStream {
 public:
     explicit inline TMD5Output(IOutputStream* slave) noexcept
@@ -53,25 +60,46 @@ public:
 
     template <class TWriter>
     void Write(const TFsPath& path, TWriter&& writer) {
+        try {
+            const TString md5 = WriteOrThrow(path, std::forward<TWriter>(writer));
+            LogSaved(md5);
+        } catch (...) {
+            LogFailed(CurrentExceptionMessage());
+        }
+    }
+
+    // doesn't log anything, so it can be called from any thread, returns md5 sum of the file
+    template <class TWriter>
+    TString WriteOrThrow(const TFsPath& path, TWriter&& writer) {
         TString tempName = JoinFsPaths(path.Dirname(), CreateGuidAsString()) + ".tmp";
         try {
+            char md5buf[33];
+            TString md5;
             {
                 TOFStream out(tempName);
                 TMD5Output md5out(&out);
                 ::Save(&md5out, Label);
                 writer(&md5out);
-                char md5buf[33];
-                if (CalcMd5) {
-                    CATBOOST_INFO_LOG << SavedMessage << " (md5sum: " << md5out.Sum(md5buf) << " )" << Endl;
-                }
+                md5 = md5out.Sum(md5buf);
             }
             NFs::Rename(tempName, path);
+            return md5;
         } catch (...) {
-            CATBOOST_WARNING_LOG << ExceptionMessage <<  CurrentExceptionMessage() << Endl;
             NFs::Remove(tempName);
+            throw;
         }
     }
 
+    void LogSaved(const TString& md5) const {
+        if (CalcMd5) {
+            CATBOOST_INFO_LOG << SavedMessage << " (md5sum: " << md5 << " )" << Endl;
+        }
+    }
+
+    void LogFailed(const TString& exceptionMessage) const {
+        CATBOOST_WARNING_LOG << ExceptionMessage << exceptionMessage << Endl;
+    }
+
     template <class TReader>
     void CheckedLoad(const TFsPath& path, TReader&& reader) {
         TString label;
@@ -87,3 +115,52 @@ private:
     TString SavedMessage;
     bool CalcMd5;
 };
+
+/* Saves progress without making the caller wait for the file.
+ * The progress is serialized to memory by the calling thread, so the saved state is consistent,
+ * and the file is written by a background thread while the caller goes on.
+ * Only one file is written at a time, so there is at most one extra copy of the progress in memory.
+ * Results are logged by the calling thread on the next Write or Finish,
+ * because custom logging functions (e.g. in R) can't be called from other threads.
+ */
+class TBackgroundProgressWriter : public TNonCopyable {
+public:
+    explicit TBackgroundProgressWriter(const TString& label)
+        : Helper(label)
+    {}
+
+    ~TBackgroundProgressWriter() {
+        Finish();
+    }
+
+    // the file at path is replaced only after the new one is completely written
+    template <class TWriter>
+    void Write(const TFsPath& path, TWriter&& writer) {
+        Finish();
+        // the buffer keeps its capacity, so repeated snapshots of similar size don't reallocate it
+        Progress.Clear();
+        try {
+            TBufferOutput out(Progress);
+            writer(&out);
+        } catch (...) {
+            Helper.LogFailed(CurrentExceptionMessage());
+            return;
+        }
+        WriterThread = MakeHolder<std::thread>([this, path] () {
+            WriteFile(path);
+        });
+    }
+
+    // waits until the last file is written
+    void Finish();
+
+private:
+    void WriteFile(const TFsPath& path);
+
+private:
+    TProgressHelper Helper;
+    TBuffer Progress; // is read by the writer thread until Finish
+    THolder<std::thread> WriterThread;
+    TString Md5;
+    TMaybe<TString> Error;
+};
@@ -0,0 +1,102 @@
+#include <catboost/libs/helpers/progress_helper.h>
+
+#include <catboost/libs/logging/logging.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/scope.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/stream/str.h>
+
+
+static const TString Label = "CPU";
+
+static void LogToString(const char* str, size_t len, TCustomLoggingObject logObject) {
+    static_cast<TStringStream*>(logObject)->Write(str, len);
+}
+
+static TVector<ui32> MakeProgress(ui32 snapshotIdx) {
+    // snapshots of different sizes
+    TVector<ui32> progress(1000 * (snapshotIdx % 3 + 1));
+    for (auto i : xrange(progress.size())) {
+        progress[i] = snapshotIdx * 1000000 + i;
+    }
+    return progress;
+}
+
+static TVector<ui32> LoadProgress(const TFsPath& path) {
+    TVector<ui32> progress;
+    TProgressHelper(Label).CheckedLoad(path, [&] (IInputStream* in) {
+        ::Load(in, progress);
+    });
+    return progress;
+}
+
+Y_UNIT_TEST_SUITE(TBackgroundProgressWriterTest) {
+    Y_UNIT_TEST(LastSnapshotIsComplete) {
+        TTempDir tempDir;
+        const TFsPath path = tempDir.Path() / "snapshot";
+        TBackgroundProgressWriter writer(Label);
+        const ui32 snapshotCount = 10;
+        for (auto snapshotIdx : xrange(snapshotCount)) {
+            writer.Write(path, [&] (IOutputStream* out) {
+                ::Save(out, MakeProgress(snapshotIdx));
+            });
+            // previous snapshot is written before the next one starts, the file is replaced atomically
+            if (snapshotIdx > 0) {
+                const auto progress = LoadProgress(path);
+                UNIT_ASSERT(progress == MakeProgress(snapshotIdx - 1) || progress == MakeProgress(snapshotIdx));
+            }
+        }
+        writer.Finish();
+        UNIT_ASSERT(LoadProgress(path) == MakeProgress(snapshotCount - 1));
+        UNIT_ASSERT(!(tempDir.Path() / "snapshot.bak").Exists());
+    }
+
+    Y_UNIT_TEST(FailuresAreReportedLater) {
+        TTempDir tempDir;
+        const TFsPath path = tempDir.Path() / "snapshot";
+
+        TSetLogging logging(ELoggingLevel::Verbose);
+        TStringStream log;
+        SetCustomLoggingFunction(&LogToString, &LogToString, &log, &log);
+        Y_DEFER {
+            RestoreOriginalLogger();
+        };
+
+        TBackgroundProgressWriter writer(Label);
+        writer.Write(path, [&] (IOutputStream* out) {
+            ::Save(out, MakeProgress(0));
+        });
+        writer.Finish();
+        UNIT_ASSERT_STRING_CONTAINS(log.Str(), "Saved progress");
+
+        // the file is kept if serialization fails
+        log.Clear();
+        writer.Write(path, [&] (IOutputStream*) {
+            ythrow yexception() << "Serialization failure";
+        });
+        UNIT_ASSERT_STRING_CONTAINS(log.Str(), "Serialization failure");
+        writer.Finish();
+        UNIT_ASSERT(LoadProgress(path) == MakeProgress(0));
+
+        // file errors are reported by the calling thread on the next call
+        log.Clear();
+        const TFsPath unwritablePath = tempDir.Path() / "missing_dir" / "snapshot";
+        writer.Write(unwritablePath, [&] (IOutputStream* out) {
+            ::Save(out, MakeProgress(1));
+        });
+        writer.Write(path, [&] (IOutputStream* out) {
+            ::Save(out, MakeProgress(2));
+        });
+        UNIT_ASSERT_STRING_CONTAINS(log.Str(), "Can't save progress to file");
+        UNIT_ASSERT(!unwritablePath.Exists());
+
+        log.Clear();
+        writer.Finish();
+        UNIT_ASSERT_STRING_CONTAINS(log.Str(), "Saved progress");
+        UNIT_ASSERT(LoadProgress(path) == MakeProgress(2));
+    }
+}
@@ -0,0 +1,199 @@
+#include "async_log_writer.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/yexception.h>
+#include <util/system/yield.h>
+
+
+TAsyncLogWriter::TAsyncLogWriter(size_t capacity)
+    : Ring(capacity)
+{
+    CB_ENSURE_INTERNAL(capacity > 1, "Too small log records queue");
+}
+
+TAsyncLogWriter::~TAsyncLogWriter() {
+    if (!WriterThread) {
+        return;
+    }
+    try {
+        Sync(/*durable*/ true);
+    } catch (...) {
+        CATBOOST_ERROR_LOG << "Failed to write logs: " << CurrentExceptionMessage() << Endl;
+    }
+    IsStopped = true;
+    WakeUp.Signal();
+    WriterThread->join();
+}
+
+static void AddUniqueBackend(
+    const TIntrusivePtr<ILoggingBackend>& loggingBackend,
+    TVector<TIntrusivePtr<ILoggingBackend>>* uniqueBackends
+) {
+    if (!IsIn(*uniqueBackends, loggingBackend)) {
+        uniqueBackends->push_back(loggingBackend);
+    }
+}
+
+void TAsyncLogWriter::AddBackend(const TString& sourceName, TIntrusivePtr<ILoggingBackend> loggingBackend) {
+    CB_ENSURE_INTERNAL(!WriterThread, "Logging backends can't be added after the first record");
+    AddUniqueBackend(loggingBackend, &UniqueBackends);
+    Backends[sourceName].push_back(std::move(loggingBackend));
+}
+
+void TAsyncLogWriter::AddProfileBackend(TIntrusivePtr<ILoggingBackend> loggingBackend) {
+    CB_ENSURE_INTERNAL(!WriterThread, "Logging backends can't be added after the first record");
+    AddUniqueBackend(loggingBackend, &UniqueBackends);
+    ProfileOutputBackends.push_back(std::move(loggingBackend));
+}
+
+TAsyncLogWriter::TRecord& TAsyncLogWriter::StartRecord(ERecordType type) {
+    ThrowIfFailed();
+    if (!WriterThread) {
+        WriterThread = MakeHolder<std::thread>([this] () {
+            WriterLoop();
+        });
+    }
+    const size_t tail = Tail.load(std::memory_order_relaxed);
+    while (tail - Head.load(std::memory_order_acquire) == Ring.size()) {
+        ThrowIfFailed();
+        WakeUp.Signal();
+        SchedYield();
+    }
+    auto& record = Ring[tail % Ring.size()];
+    record.Type = type;
+    return record;
+}
+
+void TAsyncLogWriter::PublishRecord() {
+    const size_t tail = Tail.load(std::memory_order_relaxed) + 1;
+    Tail.store(tail, std::memory_order_release);
+    if (2 * (tail - Head.load(std::memory_order_relaxed)) >= Ring.size()) {
+        WakeUp.Signal();
+    }
+}
+
+void TAsyncLogWriter::OutputMetric(const TString& sourceName, const IMetricEvalResult& evalResult) {
+    auto& record = StartRecord(ERecordType::Metric);
+    record.SourceName = sourceName;
+    record.Metric = evalResult.Clone();
+    PublishRecord();
+}
+
+void TAsyncLogWriter::OutputParameters(const TString& sourceName, const NJson::TJsonValue& parameters) {
+    auto& record = StartRecord(ERecordType::Parameters);
+    record.SourceName = sourceName;
+    record.Parameters = parameters;
+    PublishRecord();
+}
+
+void TAsyncLogWriter::OutputProfile(const TProfileResults& profileResults) {
+    auto& record = StartRecord(ERecordType::Profile);
+    record.Profile = profileResults;
+    PublishRecord();
+}
+
+void TAsyncLogWriter::FinishIteration(int iteration) {
+    auto& record = StartRecord(ERecordType::FinishIteration);
+    record.Iteration = iteration;
+    PublishRecord();
+}
+
+void TAsyncLogWriter::Sync(bool durable) {
+    auto& record = StartRecord(ERecordType::Sync);
+    record.Durable = durable;
+    PublishRecord();
+    ++SyncRequestCount;
+    WakeUp.Signal();
+    while (SyncDoneCount.load(std::memory_order_acquire) < SyncRequestCount) {
+        SyncDone.WaitT(FlushPeriod);
+    }
+    ThrowIfFailed();
+}
+
+void TAsyncLogWriter::ThrowIfFailed() const {
+    if (IsFailed.load(std::memory_order_acquire)) {
+        std::rethrow_exception(Error);
+    }
+}
+
+void TAsyncLogWriter::WriteRecord(const TRecord& record) {
+    switch (record.Type) {
+        case ERecordType::Metric:
+            for (auto& backend : Backends[record.SourceName]) {
+                backend->OutputMetric(record.SourceName, *record.Metric);
+            }
+            break;
+        case ERecordType::Parameters:
+            for (auto& backend : Backends[record.SourceName]) {
+                backend->OutputParameters(record.SourceName, record.Parameters);
+            }
+            break;
+        case ERecordType::Profile:
+            for (auto& backend : ProfileOutputBackends) {
+                backend->OutputProfile(*record.Profile);
+            }
+            break;
+        case ERecordType::FinishIteration:
+            // same order as in TLogger
+            for (auto& [sourceName, backends] : Backends) {
+                for (auto& backend : backends) {
+                    backend->Flush(record.Iteration);
+                }
+            }
+            for (auto& backend : ProfileOutputBackends) {
+                backend->Flush(record.Iteration);
+            }
+            break;
+        case ERecordType::Sync:
+            FlushFiles(record.Durable);
+            break;
+    }
+}
+
+void TAsyncLogWriter::FlushFiles(bool durable) {
+    for (auto& backend : UniqueBackends) {
+        backend->FlushFiles(durable);
+    }
+}
+
+void TAsyncLogWriter::WriterLoop() {
+    while (true) {
+        WakeUp.WaitT(FlushPeriod);
+        const bool isStopped = IsStopped.load();
+        const size_t tail = Tail.load(std::memory_order_acquire);
+        size_t head = Head.load(std::memory_order_relaxed);
+        const bool hasRecords = head != tail;
+        for (; head != tail; ++head) {
+            auto& record = Ring[head % Ring.size()];
+            if (!IsFailed.load(std::memory_order_relaxed)) {
+                try {
+                    WriteRecord(record);
+                } catch (...) {
+                    Error = std::current_exception();
+                    IsFailed.store(true, std::memory_order_release);
+                }
+            }
+            const bool isSync = record.Type == ERecordType::Sync;
+            record.Metric.Reset();
+            Head.store(head + 1, std::memory_order_release);
+            if (isSync) {
+                SyncDoneCount.fetch_add(1, std::memory_order_release);
+                SyncDone.Signal();
+            }
+        }
+        if (hasRecords && !IsFailed.load(std::memory_order_relaxed)) {
+            try {
+                FlushFiles(/*durable*/ false);
+            } catch (...) {
+                Error = std::current_exception();
+                IsFailed.store(true, std::memory_order_release);
+            }
+        }
+        if (isStopped) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "logger.h"
+
+#include <library/cpp/json/writer/json_value.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/hash.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/event.h>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+
+/* Calls logging backends from a background thread.
+ * The thread owning TLogger copies records to a fixed size single-producer single-consumer ring
+ * (metric results are cloned, so a record may allocate), the thread waits only when the ring is full.
+ * The writer thread wakes up periodically or when the ring is half full, replays the records to the backends
+ * and passes each written batch to the OS. Files are synced to disk only by durable Sync
+ * and on destruction.
+ * Backend errors are rethrown in the owning thread by the next call.
+ */
+class TAsyncLogWriter {
+public:
+    explicit TAsyncLogWriter(size_t capacity = 4096);
+    ~TAsyncLogWriter();
+
+    // backends can be added only before the first record
+    void AddBackend(const TString& sourceName, TIntrusivePtr<ILoggingBackend> loggingBackend);
+    void AddProfileBackend(TIntrusivePtr<ILoggingBackend> loggingBackend);
+
+    bool HasBackends(const TString& sourceName) const {
+        return Backends.contains(sourceName);
+    }
+
+    bool HasProfileBackends() const {
+        return !ProfileOutputBackends.empty();
+    }
+
+    void OutputMetric(const TString& sourceName, const IMetricEvalResult& evalResult);
+    void OutputParameters(const TString& sourceName, const NJson::TJsonValue& parameters);
+    void OutputProfile(const TProfileResults& profileResults);
+    void FinishIteration(int iteration);
+
+    // waits until all previous records are written
+    void Sync(bool durable);
+
+private:
+    enum class ERecordType {
+        Metric,
+        Parameters,
+        Profile,
+        FinishIteration,
+        Sync
+    };
+
+    struct TRecord {
+        ERecordType Type = ERecordType::Sync;
+        TString SourceName;
+        THolder<IMetricEvalResult> Metric;
+        NJson::TJsonValue Parameters;
+        TMaybe<TProfileResults> Profile;
+        int Iteration = 0;
+        bool Durable = false;
+    };
+
+private:
+    // waits for a free slot, the record becomes visible to the writer after PublishRecord
+    TRecord& StartRecord(ERecordType type);
+    void PublishRecord();
+
+    void WriterLoop();
+    void WriteRecord(const TRecord& record);
+    void FlushFiles(bool durable);
+    void ThrowIfFailed() const;
+
+private:
+    static constexpr TDuration FlushPeriod = TDuration::MilliSeconds(100);
+
+    THashMap<TString, TVector<TIntrusivePtr<ILoggingBackend>>> Backends;
+    TVector<TIntrusivePtr<ILoggingBackend>> ProfileOutputBackends;
+    TVector<TIntrusivePtr<ILoggingBackend>> UniqueBackends;
+
+    TVector<TRecord> Ring;
+    std::atomic<size_t> Head = 0; // next record to write, advanced by the writer
+    std::atomic<size_t> Tail = 0; // next free slot, advanced by the owner
+    TAutoEvent WakeUp;
+    TAutoEvent SyncDone;
+    size_t SyncRequestCount = 0;
+    std::atomic<size_t> SyncDoneCount = 0;
+    std::atomic<bool> IsStopped = false;
+    std::atomic<bool> IsFailed = false;
+    std::exception_ptr Error;
+    THolder<std::thread> WriterThread;
+};
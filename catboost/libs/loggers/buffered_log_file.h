@@ -0,0 +1,42 @@
+#pragma once
+
+#include <util/generic/string.h>
+#include <util/stream/str.h>
+#include <util/system/file.h>
+
+/* Log file that accumulates records in memory.
+ * Flush passes them to the OS with one write, durable Flush also syncs the file to disk,
+ * so unlike TOFStream (which syncs on every Flush/Endl) disk syncs happen only when they are asked for.
+ */
+class TBufferedLogFile {
+public:
+    explicit TBufferedLogFile(const TString& fileName)
+        : File(fileName, CreateAlways | WrOnly | Seq)
+    {
+    }
+
+    ~TBufferedLogFile() {
+        try {
+            Flush(/*durable*/ true);
+        } catch (...) {
+        }
+    }
+
+    IOutputStream& GetStream() {
+        return Buffer;
+    }
+
+    void Flush(bool durable) {
+        if (!Buffer.Empty()) {
+            File.Write(Buffer.Str().data(), Buffer.Str().size());
+            Buffer.Clear();
+        }
+        if (durable) {
+            File.Flush();
+        }
+    }
+
+private:
+    TFile File;
+    TStringStream Buffer;
+};
@@ -164,6 +164,8 @@ void AddFileLoggers(
         int metricPeriod,
         TLogger* logger
 ) {
+    // file backends don't share state with the console one, so they can be written off the training thread
+    logger->EnableBackgroundWriting();
     TIntrusivePtr<ILoggingBackend> jsonLoggingBackend = new TJsonLoggingBackend(jsonLogFile, metaJson, metricPeriod);
     for (auto& jsonToken : metaJson["learn_sets"].GetArraySafe()) {
         TString token = jsonToken.GetString();
@@ -1,5 +1,109 @@
 #include "logger.h"
 
+#include "async_log_writer.h"
+
+
+TLogger::TLogger() = default;
+
+TLogger::TLogger(int firstIteration, int lastIteration, int iterationBlockSize)
+    : CurrentIteration(firstIteration)
+    , LastIteration(lastIteration)
+    , IterationBlockSize(iterationBlockSize)
+{
+    Y_ASSERT(CurrentIteration >= 0);
+    Y_ASSERT(LastIteration >= 0);
+    Y_ASSERT(iterationBlockSize > 0);
+}
+
+TLogger::TLogger(TLogger&& other) = default;
+
+TLogger& TLogger::operator=(TLogger&& other) = default;
+
+TLogger::~TLogger() = default;
+
+void TLogger::EnableBackgroundWriting() {
+    if (!BackgroundWriter) {
+        BackgroundWriter = MakeHolder<TAsyncLogWriter>();
+    }
+}
+
+void TLogger::AddBackend(const TString& sourceName, TIntrusivePtr<ILoggingBackend> loggingBackend) {
+    if (BackgroundWriter && loggingBackend->CanWriteInBackground()) {
+        BackgroundWriter->AddBackend(sourceName, std::move(loggingBackend));
+    } else {
+        Backends[sourceName].push_back(loggingBackend);
+    }
+}
+
+void TLogger::AddProfileBackend(TIntrusivePtr<ILoggingBackend> loggingBackend) {
+    if (BackgroundWriter && loggingBackend->CanWriteInBackground()) {
+        BackgroundWriter->AddProfileBackend(std::move(loggingBackend));
+    } else {
+        ProfileOutputBackends.push_back(loggingBackend);
+    }
+}
+
+void TLogger::Sync(bool durable) {
+    if (BackgroundWriter) {
+        BackgroundWriter->Sync(durable);
+    }
+    for (auto& it : Backends) {
+        for (auto& backend : it.second) {
+            backend->FlushFiles(durable);
+        }
+    }
+    for (auto& backend : ProfileOutputBackends) {
+        backend->FlushFiles(durable);
+    }
+}
+
+void TLogger::OutputMetric(const TString& sourceName, const IMetricEvalResult& evalResult) {
+    for (auto& backend : Backends[sourceName]) {
+        backend->OutputMetric(sourceName, evalResult);
+    }
+    if (BackgroundWriter && BackgroundWriter->HasBackends(sourceName)) {
+        BackgroundWriter->OutputMetric(sourceName, evalResult);
+    }
+}
+
+void TLogger::OutputParameters(const TString& sourceName, const NJson::TJsonValue& parameters) {
+    for (auto& backend : Backends[sourceName]) {
+        backend->OutputParameters(sourceName, parameters);
+    }
+    if (BackgroundWriter && BackgroundWriter->HasBackends(sourceName)) {
+        BackgroundWriter->OutputParameters(sourceName, parameters);
+    }
+}
+
+void TLogger::OutputProfile(const TProfileResults& profileResults) {
+    for (auto& backend : ProfileOutputBackends) {
+        backend->OutputProfile(profileResults);
+    }
+    if (BackgroundWriter && BackgroundWriter->HasProfileBackends()) {
+        BackgroundWriter->OutputProfile(profileResults);
+    }
+}
+
+void TLogger::FinishIteration() {
+    for (auto& it : Backends) {
+        for (auto backend : it.second) {
+            backend->Flush(CurrentIteration);
+            backend->FlushFiles(/*durable*/ false);
+        }
+    }
+    for (auto& backend : ProfileOutputBackends) {
+        backend->Flush(CurrentIteration);
+        backend->FlushFiles(/*durable*/ false);
+    }
+    if (BackgroundWriter) {
+        BackgroundWriter->FinishIteration(CurrentIteration);
+    }
+    CurrentIteration += IterationBlockSize;
+    if (IterationBlockSize > 1) {
+        CurrentIteration = Min(CurrentIteration, LastIteration);
+    }
+}
+
 void LogAverages(const TProfileResults& profileResults) {
     CATBOOST_NOTICE_LOG << Endl << "Average times:" << Endl;
     if (profileResults.PassedIterations == 0) {
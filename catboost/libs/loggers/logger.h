@@ -1,5 +1,6 @@
 #pragma once
 
+#include "buffered_log_file.h"
 #include "tensorboard_logger.h"
 
 #include <catboost/libs/logging/logging.h>
@@ -17,6 +18,7 @@ public:
     virtual TString GetMetricName() const = 0;
     virtual TString BuildHumanReadableMetricString() const = 0;
     virtual bool IsMainMetric() const = 0;
+    virtual THolder<IMetricEvalResult> Clone() const = 0;
     virtual ~IMetricEvalResult() = default;
 };
 
@@ -60,6 +62,10 @@ public:
         return IsMain;
     }
 
+    THolder<IMetricEvalResult> Clone() const override {
+        return MakeHolder<TMetricEvalResult>(*this);
+    }
+
     TString BuildHumanReadableMetricString() const override {
         TStringStream result;
         result << Prec(Value, PREC_POINT_DIGITS,7);
@@ -84,6 +90,12 @@ public:
     virtual void OutputParameters(const TString& /*sourceName*/, const NJson::TJsonValue& /*parameters*/) {}
     virtual void OutputProfile(const TProfileResults& /*profileResults*/) {}
     virtual void Flush(const int currentIteration) = 0;
+    // backends writing only to their own files can be called from the background writer thread of TLogger
+    virtual bool CanWriteInBackground() const {
+        return false;
+    }
+    // passes buffered records to the OS, durable also syncs files to disk
+    virtual void FlushFiles(bool /*durable*/) {}
 };
 
 inline bool DoOutputIteration(int currentIteration, int iterationsCount, int writePeriod) {
@@ -136,6 +148,16 @@ public:
         IterationJson = NJson::JSON_UNDEFINED;
     }
 
+    bool CanWriteInBackground() const {
+        return true;
+    }
+
+    void FlushFiles(bool durable) {
+        if (durable) {
+            File.Flush();
+        }
+    }
+
 private:
     bool IsFirstIteration = true;
     TFile File;
@@ -190,7 +212,7 @@ private:
 class TProfileLoggingBackend : public ILoggingBackend {
 public:
     explicit TProfileLoggingBackend(const TString& fileName)
-        : File(new TOFStream(fileName))
+        : File(fileName)
     {
     }
 
@@ -209,41 +231,50 @@ public:
     }
 
     void Flush(const int currentIteration) {
-        *File << currentIteration << Stream.Str() << Endl;
+        File.GetStream() << currentIteration << Stream.Str() << '\n';
         Stream.Clear();
     }
 
+    bool CanWriteInBackground() const {
+        return true;
+    }
+
+    void FlushFiles(bool durable) {
+        File.Flush(durable);
+    }
+
     ~TProfileLoggingBackend() {
         LogSummary();
     }
 
 private:
     void LogSummary() {
-        *File << Endl << "\nAverage times:" << Endl;
+        auto& out = File.GetStream();
+        out << '\n' << "\nAverage times:" << '\n';
         if (PassedIterations == 0) {
-            *File << Endl << "No iterations recorded" << Endl;
+            out << '\n' << "No iterations recorded" << '\n';
             return;
         }
 
         double time = OperationToTimeInAllIterations["Iteration time"] / PassedIterations;
-        *File << "Iteration time: " << FloatToString(time, PREC_NDIGITS, 3) << " sec" << Endl;
+        out << "Iteration time: " << FloatToString(time, PREC_NDIGITS, 3) << " sec" << '\n';
 
         for (const auto& it : OperationToTimeInAllIterations) {
-            *File << it.first << ": "
-                << FloatToString(it.second / PassedIterations, PREC_NDIGITS, 3) << " sec" << Endl;
+            out << it.first << ": "
+                << FloatToString(it.second / PassedIterations, PREC_NDIGITS, 3) << " sec" << '\n';
         }
     }
 
-    THolder<TOFStream> File;
+    TBufferedLogFile File;
     TStringStream Stream;
-    int PassedIterations;
+    int PassedIterations = 0;
     TMap<TString, double> OperationToTimeInAllIterations;
 };
 
 class TJsonProfileLoggingBackend : public ILoggingBackend {
 public:
     explicit TJsonProfileLoggingBackend(const TString& fileName)
-        : File(new TOFStream(fileName))
+        : File(fileName)
     {
     }
 
@@ -260,7 +291,15 @@ public:
     }
 
     void Flush(const int ) {
-        *File << CurrentValue.GetStringRobust() << Endl;
+        File.GetStream() << CurrentValue.GetStringRobust() << '\n';
+    }
+
+    bool CanWriteInBackground() const {
+        return true;
+    }
+
+    void FlushFiles(bool durable) {
+        File.Flush(durable);
     }
 
     ~TJsonProfileLoggingBackend() {
@@ -281,11 +320,11 @@ private:
         for (const auto& it : OperationToTimeInAllIterations) {
             times[it.first] = it.second / PassedIterations;
         }
-        *File << CurrentValue.GetStringRobust() << Endl;
+        File.GetStream() << CurrentValue.GetStringRobust() << '\n';
     }
     NJson::TJsonValue CurrentValue;
-    THolder<TOFStream> File;
-    int PassedIterations;
+    TBufferedLogFile File;
+    int PassedIterations = 0;
     TMap<TString, double> OperationToTimeInAllIterations;
 };
 
@@ -293,7 +332,7 @@ private:
 class TErrorFileLoggingBackend : public ILoggingBackend {
 public:
     explicit TErrorFileLoggingBackend(const TString& fileName)
-        : File(new TOFStream(fileName))
+        : File(fileName)
     {
     }
 
@@ -306,26 +345,34 @@ public:
 
     void Flush(const int currentIteration) {
         if (IsFirstIteration) {
-            *File << "iter" << TitleStream.Str() << Endl;
+            File.GetStream() << "iter" << TitleStream.Str() << '\n';
             IsFirstIteration = false;
         }
         if (!Stream.Empty()) {
-            *File << currentIteration << Stream.Str() << Endl;
+            File.GetStream() << currentIteration << Stream.Str() << '\n';
             Stream.Clear();
         }
     }
 
+    bool CanWriteInBackground() const {
+        return true;
+    }
+
+    void FlushFiles(bool durable) {
+        File.Flush(durable);
+    }
+
 private:
     bool IsFirstIteration = true;
     TStringStream Stream;
     TStringStream TitleStream;
-    THolder<TOFStream> File;
+    TBufferedLogFile File;
 };
 
 class TTimeFileLoggingBackend : public ILoggingBackend {
 public:
     explicit TTimeFileLoggingBackend(const TString& fileName)
-        : File(new TOFStream(fileName))
+        : File(fileName)
     {
     }
 
@@ -339,18 +386,26 @@ public:
 
     void Flush(const int currentIteration) {
         if (IsFirstIteration) {
-            *File << "iter" << TitleStream.Str() << Endl;
+            File.GetStream() << "iter" << TitleStream.Str() << '\n';
             IsFirstIteration = false;
         }
-        *File << currentIteration << Stream.Str() << Endl;
+        File.GetStream() << currentIteration << Stream.Str() << '\n';
         Stream.Clear();
     }
 
+    bool CanWriteInBackground() const {
+        return true;
+    }
+
+    void FlushFiles(bool durable) {
+        File.Flush(durable);
+    }
+
 private:
     bool IsFirstIteration = true;
     TStringStream Stream;
     TStringStream TitleStream;
-    THolder<TOFStream> File;
+    TBufferedLogFile File;
 };
 
 class TTensorBoardLoggingBackend : public ILoggingBackend {
@@ -371,6 +426,14 @@ public:
         MetricsInfo.clear();
     }
 
+    bool CanWriteInBackground() const {
+        return true;
+    }
+
+    void FlushFiles(bool durable) {
+        Logger->Flush(durable);
+    }
+
 private:
     struct MetricInfo {
         MetricInfo(const TString& name, const double value)
@@ -384,65 +447,37 @@ private:
 };
 
 class TOneInterationLogger;
+class TAsyncLogWriter;
 
 class TLogger {
 public:
-    TLogger() = default;
-    TLogger(int firstIteration, int lastIteration, int iterationBlockSize)
-        : CurrentIteration(firstIteration)
-        , LastIteration(lastIteration)
-        , IterationBlockSize(iterationBlockSize)
-    {
-        Y_ASSERT(CurrentIteration >= 0);
-        Y_ASSERT(LastIteration >= 0);
-        Y_ASSERT(iterationBlockSize > 0);
-    }
+    TLogger();
+    TLogger(int firstIteration, int lastIteration, int iterationBlockSize);
+    TLogger(TLogger&& other);
+    TLogger& operator=(TLogger&& other);
+    ~TLogger();
 
-    void AddBackend(const TString& sourceName, TIntrusivePtr<ILoggingBackend> loggingBackend) {
-        Backends[sourceName].push_back(loggingBackend);
-    }
+    /* Backends that can write in background and are added after this call
+     * are called from a separate thread, so the training thread only copies records to a queue.
+     */
+    void EnableBackgroundWriting();
 
-    void AddProfileBackend(TIntrusivePtr<ILoggingBackend> loggingBackend) {
-        ProfileOutputBackends.push_back(loggingBackend);
-    }
+    void AddBackend(const TString& sourceName, TIntrusivePtr<ILoggingBackend> loggingBackend);
+    void AddProfileBackend(TIntrusivePtr<ILoggingBackend> loggingBackend);
 
-private:
-    void OutputMetric(const TString& sourceName, const IMetricEvalResult& evalResult) {
-        for (auto& backend : Backends[sourceName]) {
-            backend->OutputMetric(sourceName, evalResult);
-        }
-    }
+    // waits until all finished iterations are written to files, durable also syncs files to disk
+    void Sync(bool durable);
 
-    void OutputParameters(const TString& sourceName, const NJson::TJsonValue& parameters) {
-        for (auto& backend : Backends[sourceName]) {
-            backend->OutputParameters(sourceName, parameters);
-        }
-    }
-
-    void OutputProfile(const TProfileResults& profileResults) {
-        for (auto& backend : ProfileOutputBackends) {
-            backend->OutputProfile(profileResults);
-        }
-    }
-
-    void FinishIteration() {
-        for (auto& it : Backends) {
-            for (auto backend : it.second) {
-                backend->Flush(CurrentIteration);
-            }
-        }
-        for (auto& backend : ProfileOutputBackends) {
-            backend->Flush(CurrentIteration);
-        }
-        CurrentIteration += IterationBlockSize;
-        if (IterationBlockSize > 1) {
-            CurrentIteration = Min(CurrentIteration, LastIteration);
-        }
-    }
+private:
+    void OutputMetric(const TString& sourceName, const IMetricEvalResult& evalResult);
+    void OutputParameters(const TString& sourceName, const NJson::TJsonValue& parameters);
+    void OutputProfile(const TProfileResults& profileResults);
+    void FinishIteration();
 
     friend TOneInterationLogger;
     THashMap<TString, TVector<TIntrusivePtr<ILoggingBackend>>> Backends;
     TVector<TIntrusivePtr<ILoggingBackend>> ProfileOutputBackends;
+    THolder<TAsyncLogWriter> BackgroundWriter;
     int CurrentIteration = 0;
     int LastIteration = 0;
     int IterationBlockSize = 1;
@@ -10,11 +10,11 @@ int TTensorBoardLogger::Write(tensorboard::Event& event) {
     uint32_t lenCrc = Mask(Crc32c((char*)&bufLen, sizeof(uint64_t)));
     uint32_t dataCrc = Mask(Crc32c(buf.c_str(), buf.size()));
 
-    OutputStream->Write((char*)&bufLen, sizeof(uint64_t));
-    OutputStream->Write((char*)&lenCrc, sizeof(uint32_t));
-    OutputStream->Write(buf.c_str(), buf.size());
-    OutputStream->Write((char*)&dataCrc, sizeof(uint32_t));
-    OutputStream->Flush();
+    IOutputStream& output = OutputFile->GetStream();
+    output.Write((char*)&bufLen, sizeof(uint64_t));
+    output.Write((char*)&lenCrc, sizeof(uint32_t));
+    output.Write(buf.c_str(), buf.size());
+    output.Write((char*)&dataCrc, sizeof(uint32_t));
     return 0;
 }
 
@@ -34,7 +34,7 @@ TTensorBoardLogger::TTensorBoardLogger(const TString& logDir) {
         MakePathIfNotExist(logDir.c_str());
     }
     TString logFile = JoinFsPaths(logDir, "events.out.tfevents");
-    OutputStream = THolder<TOFStream>(new TOFStream(logFile));
+    OutputFile = MakeHolder<TBufferedLogFile>(logFile);
 }
 
 int TTensorBoardLogger::AddScalar(const TString& tag, int step, float value) {
@@ -48,3 +48,9 @@ int TTensorBoardLogger::AddScalar(const TString& tag, int step, float value) {
     return 0;
 }
 
+
+void TTensorBoardLogger::Flush(bool durable) {
+    if (OutputFile) {
+        OutputFile->Flush(durable);
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "buffered_log_file.h"
+
 #include "contrib/libs/tensorboard/event.pb.h"
 
 #include <util/generic/string.h>
@@ -15,7 +17,7 @@
 
 class TTensorBoardLogger {
 private:
-    THolder<TOFStream> OutputStream;
+    THolder<TBufferedLogFile> OutputFile;
 
     int AddEvent(int64_t step, THolder<tensorboard::Summary>* summary);
     int Write(tensorboard::Event& event);
@@ -24,4 +26,6 @@ public:
     TTensorBoardLogger() = default;
     TTensorBoardLogger(const TString& logDir);
     int AddScalar(const TString& tag, int step, float value);
+    // events are buffered until Flush, durable Flush also syncs the file to disk
+    void Flush(bool durable);
 };
@@ -0,0 +1,146 @@
+#include <catboost/libs/loggers/async_log_writer.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+
+
+namespace {
+    // backend methods are called from the writer thread only, results are read after Sync
+    class TRecordingBackend : public ILoggingBackend {
+    public:
+        void OutputMetric(const TString& sourceName, const IMetricEvalResult& evalResult) override {
+            Records.push_back(sourceName + ":" + evalResult.GetMetricName() + "=" + ToString(evalResult.GetMetricValue()));
+        }
+
+        void OutputParameters(const TString& sourceName, const NJson::TJsonValue& parameters) override {
+            Records.push_back(sourceName + ":" + parameters.GetStringRobust());
+        }
+
+        void OutputProfile(const TProfileResults& profileResults) override {
+            Records.push_back("profile:" + ToString(profileResults.PassedTime));
+        }
+
+        void Flush(const int currentIteration) override {
+            Records.push_back("iteration:" + ToString(currentIteration));
+        }
+
+        bool CanWriteInBackground() const override {
+            return true;
+        }
+
+        void FlushFiles(bool durable) override {
+            if (durable) {
+                ++DurableFlushCount;
+            }
+        }
+
+    public:
+        TVector<TString> Records;
+        int DurableFlushCount = 0;
+    };
+
+    class TThrowingBackend : public ILoggingBackend {
+    public:
+        void OutputMetric(const TString& /*sourceName*/, const IMetricEvalResult& /*evalResult*/) override {
+            ythrow yexception() << "Backend failure";
+        }
+
+        void Flush(const int /*currentIteration*/) override {
+        }
+
+        bool CanWriteInBackground() const override {
+            return true;
+        }
+    };
+}
+
+Y_UNIT_TEST_SUITE(TAsyncLogWriterTest) {
+    Y_UNIT_TEST(RecordsAreReplayedInOrder) {
+        TIntrusivePtr<TRecordingBackend> learnBackend = new TRecordingBackend;
+        TIntrusivePtr<TRecordingBackend> testBackend = new TRecordingBackend;
+        TAsyncLogWriter writer;
+        writer.AddBackend("learn", learnBackend);
+        writer.AddBackend("test", testBackend);
+        writer.AddProfileBackend(learnBackend);
+        UNIT_ASSERT(writer.HasBackends("learn"));
+        UNIT_ASSERT(!writer.HasBackends("other"));
+        UNIT_ASSERT(writer.HasProfileBackends());
+
+        NJson::TJsonValue parameters;
+        parameters["lr"] = 0.5;
+        writer.OutputParameters("learn", parameters);
+        writer.OutputMetric("learn", TMetricEvalResult("RMSE", 1, true));
+        writer.OutputMetric("test", TMetricEvalResult("RMSE", 2, true));
+        writer.OutputMetric("learn", TMetricEvalResult("MAE", 3, false));
+        writer.OutputProfile(TProfileResults(4, 5));
+        writer.FinishIteration(0);
+        writer.Sync(/*durable*/ false);
+
+        const TVector<TString> expectedLearnRecords = {
+            "learn:" + parameters.GetStringRobust(),
+            "learn:RMSE=1",
+            "learn:MAE=3",
+            "profile:4",
+            // flushed both as a metric and as a profile backend
+            "iteration:0",
+            "iteration:0"
+        };
+        UNIT_ASSERT_VALUES_EQUAL(learnBackend->Records, expectedLearnRecords);
+        UNIT_ASSERT_VALUES_EQUAL(testBackend->Records, (TVector<TString>{"test:RMSE=2", "iteration:0"}));
+        UNIT_ASSERT_VALUES_EQUAL(learnBackend->DurableFlushCount, 0);
+    }
+
+    Y_UNIT_TEST(RingWrapsAround) {
+        TIntrusivePtr<TRecordingBackend> backend = new TRecordingBackend;
+        const size_t capacity = 4;
+        TAsyncLogWriter writer(capacity);
+        writer.AddBackend("learn", backend);
+
+        const int iterationCount = 100;
+        TVector<TString> expectedRecords;
+        for (auto iteration : xrange(iterationCount)) {
+            writer.OutputMetric("learn", TMetricEvalResult("RMSE", iteration, true));
+            writer.FinishIteration(iteration);
+            expectedRecords.push_back("learn:RMSE=" + ToString(iteration));
+            expectedRecords.push_back("iteration:" + ToString(iteration));
+            if (iteration == iterationCount / 2) {
+                writer.Sync(/*durable*/ false);
+                UNIT_ASSERT_VALUES_EQUAL(backend->Records, expectedRecords);
+            }
+        }
+        writer.Sync(/*durable*/ false);
+        UNIT_ASSERT_VALUES_EQUAL(backend->Records, expectedRecords);
+    }
+
+    Y_UNIT_TEST(DurableSyncWritesFiles) {
+        TTempDir tempDir;
+        const TString fileName = tempDir.Name() + "/learn_error.tsv";
+        TIntrusivePtr<TRecordingBackend> recordingBackend = new TRecordingBackend;
+        TAsyncLogWriter writer;
+        writer.AddBackend("learn", new TErrorFileLoggingBackend(fileName));
+        writer.AddBackend("learn", recordingBackend);
+
+        for (auto iteration : xrange(3)) {
+            writer.OutputMetric("learn", TMetricEvalResult("RMSE", iteration, true));
+            writer.FinishIteration(iteration);
+        }
+        writer.Sync(/*durable*/ true);
+
+        UNIT_ASSERT_VALUES_EQUAL(recordingBackend->DurableFlushCount, 1);
+        UNIT_ASSERT_VALUES_EQUAL(TFileInput(fileName).ReadAll(), "iter\tRMSE\n0\t0\n1\t1\n2\t2\n");
+    }
+
+    Y_UNIT_TEST(BackendErrorIsRethrown) {
+        TAsyncLogWriter writer;
+        writer.AddBackend("learn", new TThrowingBackend);
+        writer.OutputMetric("learn", TMetricEvalResult("RMSE", 1, true));
+        UNIT_ASSERT_EXCEPTION_CONTAINS(writer.Sync(/*durable*/ false), yexception, "Backend failure");
+        // the writer stays failed
+        UNIT_ASSERT_EXCEPTION_CONTAINS(writer.FinishIteration(0), yexception, "Backend failure");
+        UNIT_ASSERT_EXCEPTION_CONTAINS(writer.Sync(/*durable*/ true), yexception, "Backend failure");
+    }
+}
@@ -0,0 +1,108 @@
+#include <catboost/libs/model/static_ctr_provider.h>
+
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/singleton.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/string/cast.h>
+
+
+const ui32 CatFeatureCount = 16;
+const ui32 ValueCount = 1 << 20; // per table, large enough not to fit into caches
+const size_t DocCount = 128; // evaluation block size
+
+static ui32 GetCatValueHash(ui32 valueIdx) {
+    return valueIdx * 7 + 1;
+}
+
+static TModelCtrBase MakeCatCtrBase(int catFeatureIdx, ECtrType ctrType) {
+    TModelCtrBase ctrBase;
+    ctrBase.Projection.CatFeatures = {catFeatureIdx};
+    ctrBase.CtrType = ctrType;
+    return ctrBase;
+}
+
+static TCtrValueTable MakeValueTable(const TModelCtrBase& ctrBase, TFastRng64* rng) {
+    TCtrValueTable table;
+    table.ModelCtrBase = ctrBase;
+    auto hashBuilder = table.GetIndexHashBuilder(ValueCount);
+    if (ctrBase.CtrType == ECtrType::Counter) {
+        table.CounterDenominator = ValueCount;
+        auto counters = table.AllocateBlobAndGetArrayRef<int>(ValueCount);
+        for (auto valueIdx : xrange(ValueCount)) {
+            const ui32 bucketIdx = hashBuilder.AddIndex(CalcHash(0, (ui64)(int)GetCatValueHash(valueIdx)));
+            counters[bucketIdx] = rng->Uniform(1000);
+        }
+    } else {
+        table.TargetClassesCount = 2;
+        auto history = table.AllocateBlobAndGetArrayRef<int>(2 * ValueCount);
+        for (auto valueIdx : xrange(ValueCount)) {
+            const ui32 bucketIdx = hashBuilder.AddIndex(CalcHash(0, (ui64)(int)GetCatValueHash(valueIdx)));
+            history[2 * bucketIdx] = rng->Uniform(100);
+            history[2 * bucketIdx + 1] = rng->Uniform(100);
+        }
+    }
+    return table;
+}
+
+namespace {
+    // Borders and Counter ctrs with two priors on each of the cat features
+    template <bool CompactCounters>
+    struct TCtrProviderData {
+        TStaticCtrProvider Provider;
+        TVector<TModelCtr> NeededCtrs;
+        TVector<ui32> HashedCatFeatures; // [featureIdx][docIdx]
+
+    public:
+        TCtrProviderData() {
+            TFastRng64 rng(0);
+            TVector<TCatFeature> catFeatures;
+            for (auto catFeatureIdx : xrange<int>(CatFeatureCount)) {
+                catFeatures.emplace_back(true, catFeatureIdx, catFeatureIdx, "c" + ToString(catFeatureIdx));
+                for (auto ctrType : {ECtrType::Borders, ECtrType::Counter}) {
+                    const auto ctrBase = MakeCatCtrBase(catFeatureIdx, ctrType);
+                    auto table = MakeValueTable(ctrBase, &rng);
+                    if (CompactCounters) {
+                        table.CompactCounters();
+                    }
+                    Provider.AddCtrCalcerData(std::move(table));
+                    for (float priorNum : {0.0f, 0.5f}) {
+                        TModelCtr ctr;
+                        ctr.Base = ctrBase;
+                        ctr.PriorNum = priorNum;
+                        ctr.PriorDenom = 1.0f;
+                        NeededCtrs.push_back(ctr);
+                    }
+                }
+            }
+            Provider.SetupBinFeatureIndexes({}, {}, catFeatures);
+            Sort(NeededCtrs);
+
+            // about a quarter of values are not in tables
+            HashedCatFeatures.yresize(CatFeatureCount * DocCount);
+            for (auto& catValueHash : HashedCatFeatures) {
+                catValueHash = GetCatValueHash(rng.Uniform(ValueCount + ValueCount / 3));
+            }
+        }
+    };
+}
+
+template <bool CompactCounters>
+static void CalcCtrs(const NBench::NCpu::TParams& iface) {
+    auto& data = *Singleton<TCtrProviderData<CompactCounters>>();
+    TVector<float> result(data.NeededCtrs.size() * DocCount);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        data.Provider.CalcCtrs(data.NeededCtrs, {}, data.HashedCatFeatures, DocCount, result);
+        Y_DO_NOT_OPTIMIZE_AWAY(result);
+    }
+}
+
+Y_CPU_BENCHMARK(StaticCtrProviderCalcCtrs, iface) {
+    CalcCtrs</*CompactCounters*/ false>(iface);
+}
+
+Y_CPU_BENCHMARK(StaticCtrProviderCalcCtrsCompactCounters, iface) {
+    CalcCtrs</*CompactCounters*/ true>(iface);
+}
@@ -3,6 +3,7 @@
 #include "flatbuffers_serializer_helper.h"
 #include <catboost/libs/model/flatbuffers/ctr_data.fbs.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/stream/mem.h>
@@ -27,7 +28,8 @@ void TCtrValueTable::Save(IOutputStream* s) const {
             indexHashOffset,
             ctrBlob,
             CounterDenominator,
-            TargetClassesCount);
+            TargetClassesCount,
+            CounterByteSize);
         serializer.FlatbufBuilder.Finish(ctrValueTable);
     } else {
         auto& thin = std::get<TThinTable>(Impl);
@@ -40,7 +42,8 @@ void TCtrValueTable::Save(IOutputStream* s) const {
             indexHashOffset,
             ctrBlob,
             CounterDenominator,
-            TargetClassesCount);
+            TargetClassesCount,
+            CounterByteSize);
         serializer.FlatbufBuilder.Finish(ctrValueTable);
     }
     SaveSize(s, serializer.FlatbufBuilder.GetSize());
@@ -63,6 +66,7 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
     CounterDenominator = ctrValueTable->CounterDenominator();
     TargetClassesCount = ctrValueTable->TargetClassesCount();
+    CounterByteSize = ctrValueTable->CounterByteSize();
     solid.IndexBuckets.assign((NCatboost::TBucket*)ctrValueTable->IndexHashRaw()->data(),
                               (NCatboost::TBucket*)(ctrValueTable->IndexHashRaw()->data() + ctrValueTable->IndexHashRaw()->size()));
 
@@ -83,6 +87,7 @@ void TCtrValueTable::LoadThin(TMemoryInput* in) {
     ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
     CounterDenominator = ctrValueTable->CounterDenominator();
     TargetClassesCount = ctrValueTable->TargetClassesCount();
+    CounterByteSize = ctrValueTable->CounterByteSize();
 
     thin.IndexBuckets = TConstArrayRef<NCatboost::TBucket>(
         reinterpret_cast<const NCatboost::TBucket*>(ctrValueTable->IndexHashRaw()->data()),
@@ -90,3 +95,57 @@ void TCtrValueTable::LoadThin(TMemoryInput* in) {
     );
     thin.CTRBlob = TConstArrayRef<ui8>(ctrValueTable->CTRBlob()->data(), ctrValueTable->CTRBlob()->size());
 }
+
+template <class TCounter>
+static void NarrowCounters(TConstArrayRef<int> counters, TVector<ui8>* blob) {
+    TVector<ui8> narrowBlob(counters.size() * sizeof(TCounter));
+    TCounter* narrowCounters = reinterpret_cast<TCounter*>(narrowBlob.data());
+    for (size_t i = 0; i < counters.size(); ++i) {
+        narrowCounters[i] = static_cast<TCounter>(counters[i]);
+    }
+    blob->swap(narrowBlob);
+}
+
+void TCtrValueTable::CompactCounters() {
+    if (!HasIntegerCounters() || (CounterByteSize != sizeof(int))) {
+        return;
+    }
+    if (std::holds_alternative<TThinTable>(Impl)) {
+        TSolidTable solid;
+        std::get<TThinTable>(Impl).ToSolidTable(&solid);
+        Impl = std::move(solid);
+    }
+    const auto counters = GetTypedArrayRefForBlobData<int>();
+    if (counters.empty() || (*MinElement(counters.begin(), counters.end()) < 0)) {
+        return;
+    }
+    const int maxCounter = *MaxElement(counters.begin(), counters.end());
+    auto& blob = std::get<TSolidTable>(Impl).CTRBlob;
+    if (maxCounter <= Max<ui8>()) {
+        NarrowCounters<ui8>(counters, &blob);
+        CounterByteSize = sizeof(ui8);
+    } else if (maxCounter <= Max<ui16>()) {
+        NarrowCounters<ui16>(counters, &blob);
+        CounterByteSize = sizeof(ui16);
+    }
+}
+
+template <class TCounter>
+static TVector<int> WidenCounters(TConstArrayRef<TCounter> counters) {
+    return TVector<int>(counters.begin(), counters.end());
+}
+
+NCB::TMaybeOwningConstArrayHolder<int> TCtrValueTable::GetIntCounters() const {
+    switch (CounterByteSize) {
+        case sizeof(ui8):
+            return NCB::TMaybeOwningConstArrayHolder<int>::CreateOwning(
+                WidenCounters(GetTypedArrayRefForBlobData<ui8>()));
+        case sizeof(ui16):
+            return NCB::TMaybeOwningConstArrayHolder<int>::CreateOwning(
+                WidenCounters(GetTypedArrayRefForBlobData<ui16>()));
+        case sizeof(int):
+            return NCB::TMaybeOwningConstArrayHolder<int>::CreateNonOwning(GetTypedArrayRefForBlobData<int>());
+        default:
+            CB_ENSURE(false, "Unsupported ctr value table counter size " << (int)CounterByteSize);
+    }
+}
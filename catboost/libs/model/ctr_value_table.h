@@ -3,6 +3,8 @@
 #include "online_ctr.h"
 
 #include <catboost/libs/helpers/dense_hash_view.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
 
 #include <util/generic/array_ref.h>
 #include <util/generic/variant.h>
@@ -12,6 +14,7 @@
 
 #include <algorithm>
 #include <tuple>
+#include <type_traits>
 
 
 class TCtrValueTable {
@@ -46,12 +49,19 @@ public:
     }
 
     bool operator==(const TCtrValueTable& other) const {
-        return std::tie(CounterDenominator, TargetClassesCount, Impl) ==
-               std::tie(other.CounterDenominator, other.TargetClassesCount, other.Impl);
+        return std::tie(CounterDenominator, TargetClassesCount, CounterByteSize, Impl) ==
+               std::tie(other.CounterDenominator, other.TargetClassesCount, other.CounterByteSize, other.Impl);
     }
 
+    // for integer counters T must match CounterByteSize, use GetIntCounters to get them as int in any case
     template <typename T>
     TConstArrayRef<T> GetTypedArrayRefForBlobData() const {
+        if constexpr (std::is_integral_v<T>) {
+            CB_ENSURE_INTERNAL(
+                sizeof(T) == CounterByteSize,
+                "Ctr value table counters are " << (int)CounterByteSize << " bytes, requested " << sizeof(T)
+            );
+        }
         if (std::holds_alternative<TSolidTable>(Impl)) {
             auto& solid = std::get<TSolidTable>(Impl);
             return MakeArrayRef(
@@ -94,6 +104,22 @@ public:
         solid.IndexBuckets.resize(bucketCount);
         return NCatboost::TDenseIndexHashBuilder(solid.IndexBuckets);
     }
+    // ctr types other than target mean values store integer counters in CTRBlob
+    bool HasIntegerCounters() const {
+        return (ModelCtrBase.CtrType != ECtrType::BinarizedTargetMeanValue)
+            && (ModelCtrBase.CtrType != ECtrType::FloatTargetMeanValue);
+    }
+
+    /* Store integer counters as ui8 or ui16 if all of them fit.
+     * Counter values are not changed, so ctrs calculated from the table stay exactly the same.
+     * Models with compact tables are saved under TStaticCtrProvider::CompactCountersModelPartId(),
+     * so versions that don't know about CounterByteSize fail to load them.
+     */
+    void CompactCounters();
+
+    // integer counters as int, copied only if they are stored compacted
+    NCB::TMaybeOwningConstArrayHolder<int> GetIntCounters() const;
+
     void Save(IOutputStream* s) const;
 
     void Load(IInputStream* s);
@@ -104,6 +130,8 @@ public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
     int TargetClassesCount = 0;
+    // size of one integer counter in CTRBlob, sizeof(int) unless CompactCounters has been applied
+    ui8 CounterByteSize = sizeof(int);
 private:
     std::variant<TSolidTable, TThinTable> Impl;
 };
@@ -1206,7 +1206,9 @@ void TFullModel::Load(IInputStream* s) {
     }
     if (!modelParts.empty()) {
         for (const auto& modelPartId : modelParts) {
-            if (modelPartId == TStaticCtrProvider::ModelPartId()) {
+            if (modelPartId == TStaticCtrProvider::ModelPartId()
+                || modelPartId == TStaticCtrProvider::CompactCountersModelPartId())
+            {
                 CtrProvider = new TStaticCtrProvider;
                 CtrProvider->Load(s);
             } else if (modelPartId == NCB::TTextProcessingCollection::GetStringIdentifier()) {
@@ -1262,7 +1264,9 @@ void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binarySize) {
 
     if (!modelParts.empty()) {
         for (const auto& modelPartId : modelParts) {
-            if (modelPartId == TStaticCtrProvider::ModelPartId()) {
+            if (modelPartId == TStaticCtrProvider::ModelPartId()
+                || modelPartId == TStaticCtrProvider::CompactCountersModelPartId())
+            {
                 auto ptr = new TStaticCtrProvider;
                 CtrProvider = ptr;
                 ptr->LoadNonOwning(&in);
@@ -134,8 +134,8 @@ namespace NCB {
                 out << "}" << commaInner;
             }
             out << "}," << '\n';
-            const TConstArrayRef<int> ctrTotal = learnCtrValueTable.GetTypedArrayRefForBlobData<int>();
-            out << indent << WN("CtrTotal") << "{" << OutputArrayInitializer(ctrTotal) << "}" << '\n';
+            const auto ctrTotal = learnCtrValueTable.GetIntCounters();
+            out << indent << WN("CtrTotal") << "{" << OutputArrayInitializer(*ctrTotal) << "}" << '\n';
             out << --indent << "}" << '\n';
             out << --indent << "}" << comma << '\n';
         };
@@ -442,6 +442,9 @@ static NJson::TJsonValue ConvertCtrsToJson(const TStaticCtrProvider* ctrProvider
             auto hashIndexResolver = learnCtr.GetIndexHashViewer();
             const ECtrType ctrType = ctr->Base.CtrType;
             THashSet<ui64> hashIndexes;
+            const auto intCounters = learnCtr.HasIntegerCounters()
+                ? learnCtr.GetIntCounters()
+                : NCB::TMaybeOwningConstArrayHolder<int>();
             for (const auto& bucket: hashIndexResolver.GetBuckets()) {
                 auto value = bucket.IndexValue;
                 if (value == NCatboost::TDenseIndexHashView::NotFoundIndex) {
@@ -461,12 +464,10 @@ static NJson::TJsonValue ConvertCtrsToJson(const TStaticCtrProvider* ctrProvider
                         hashValue.AppendValue(ctrMeanHistory.Count);
                     }
                 } else  if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-                    TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
-                    hashValue.AppendValue(ctrTotal[value]);
+                    hashValue.AppendValue(intCounters[value]);
                 } else {
-                    auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
                     const int targetClassesCount = learnCtr.TargetClassesCount;
-                    auto ctrHistory = MakeArrayRef(ctrIntArray.data() + value * targetClassesCount, targetClassesCount);
+                    auto ctrHistory = MakeArrayRef((*intCounters).data() + value * targetClassesCount, targetClassesCount);
                     for (int classId = 0; classId < targetClassesCount; ++classId) {
                         hashValue.AppendValue(ctrHistory[classId]);
                     }
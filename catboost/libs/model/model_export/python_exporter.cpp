@@ -133,8 +133,8 @@ namespace NCB {
                 out << ")" << commaInner;
             }
             out << "]," << '\n';
-            const TConstArrayRef<int> ctrTotal = learnCtrValueTable.GetTypedArrayRefForBlobData<int>();
-            out << indent << "ctr_total = [" << OutputArrayInitializer(ctrTotal) << "]" << '\n';
+            const auto ctrTotal = learnCtrValueTable.GetIntCounters();
+            out << indent << "ctr_total = [" << OutputArrayInitializer(*ctrTotal) << "]" << '\n';
             out << --indent << ")" << comma << '\n';
         };
         out << --indent << "}" << '\n';
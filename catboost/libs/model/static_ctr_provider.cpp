@@ -7,10 +7,153 @@
 #include <util/generic/xrange.h>
 #include <util/string/cast.h>
 
+#include <algorithm>
+
 
 using namespace NCB;
 
 
+// prefetch buckets of hash index this number of documents ahead of the probe
+static constexpr size_t INDEX_PREFETCH_DISTANCE = 16;
+
+static void GetBucketIndexes(
+    const NCatboost::TDenseIndexHashView& hashIndexResolver,
+    TConstArrayRef<ui64> ctrHashes,
+    TArrayRef<ui64> buckets
+) {
+    const size_t samplesCount = ctrHashes.size();
+    for (size_t docId = 0; docId < Min(INDEX_PREFETCH_DISTANCE, samplesCount); ++docId) {
+        hashIndexResolver.PrefetchIndex(ctrHashes[docId]);
+    }
+    for (size_t docId = 0; docId < samplesCount; ++docId) {
+        if (docId + INDEX_PREFETCH_DISTANCE < samplesCount) {
+            hashIndexResolver.PrefetchIndex(ctrHashes[docId + INDEX_PREFETCH_DISTANCE]);
+        }
+        buckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
+    }
+}
+
+// ctrs of types with integer counters, TCounter is the type counters are stored with in the table
+template <class TCounter>
+static void CalcCtrsFromCounters(
+    const TModelCtr& ctr,
+    const TCtrValueTable& learnCtr,
+    const ui64* ptrBuckets,
+    size_t samplesCount,
+    float* resultPtr
+) {
+    const ECtrType ctrType = ctr.Base.CtrType;
+    if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        TConstArrayRef<TCounter> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<TCounter>();
+        const int denominator = learnCtr.CounterDenominator;
+        auto emptyVal = ctr.Calc(0, denominator);
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                resultPtr[doc] = ctr.Calc(ctrTotal[ptrBuckets[doc]], denominator);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else if (ctrType == ECtrType::Buckets) {
+        auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<TCounter>();
+        const int targetClassesCount = learnCtr.TargetClassesCount;
+        auto emptyVal = ctr.Calc(0, 0);
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                int goodCount = 0;
+                int totalCount = 0;
+                auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
+                goodCount = ctrHistory[ctr.TargetBorderIdx];
+                for (int classId = 0; classId < targetClassesCount; ++classId) {
+                    totalCount += ctrHistory[classId];
+                }
+                resultPtr[doc] = ctr.Calc(goodCount, totalCount);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else {
+        auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<TCounter>();
+        const int targetClassesCount = learnCtr.TargetClassesCount;
+
+        auto emptyVal = ctr.Calc(0, 0);
+        if (targetClassesCount > 2) {
+            for (size_t doc = 0; doc < samplesCount; ++doc) {
+                int goodCount = 0;
+                int totalCount = 0;
+                if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                    auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
+                    for (int classId = 0; classId < ctr.TargetBorderIdx + 1; ++classId) {
+                        totalCount += ctrHistory[classId];
+                    }
+                    for (int classId = ctr.TargetBorderIdx + 1; classId < targetClassesCount; ++classId) {
+                        goodCount += ctrHistory[classId];
+                    }
+                    totalCount += goodCount;
+                }
+                resultPtr[doc] = ctr.Calc(goodCount, totalCount);
+            }
+        } else {
+            for (size_t doc = 0; doc < samplesCount; ++doc) {
+                if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                    const TCounter* ctrHistory = &ctrIntArray[ptrBuckets[doc] * 2];
+                    resultPtr[doc] = ctr.Calc(ctrHistory[1], ctrHistory[0] + ctrHistory[1]);
+                } else {
+                    resultPtr[doc] = emptyVal;
+                }
+            }
+        }
+    }
+}
+
+THolder<TStaticCtrProvider::TCtrApplyPlan> TStaticCtrProvider::BuildApplyPlan(
+    TConstArrayRef<TModelCtr> neededCtrs
+) const {
+    auto applyPlan = MakeHolder<TCtrApplyPlan>();
+    applyPlan->NeededCtrs.assign(neededCtrs.begin(), neededCtrs.end());
+
+    // NeededCtrs are sorted so ctrs with the same projection and then with the same base are adjacent
+    size_t resultIdx = 0;
+    for (const auto& compressedModelCtr : NCB::CompressModelCtrs(applyPlan->NeededCtrs)) {
+        const auto& proj = *compressedModelCtr.Projection;
+        auto& projectionPlan = applyPlan->Projections.emplace_back();
+        for (const auto feature : proj.CatFeatures) {
+            projectionPlan.TransposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
+        }
+        for (const auto feature : proj.BinFeatures ) {
+            projectionPlan.BinarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
+        }
+        for (const auto feature : proj.OneHotFeatures ) {
+            projectionPlan.BinarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
+        }
+        const TModelCtrBase* prevBase = nullptr;
+        for (const auto* ctr : compressedModelCtr.ModelCtrs) {
+            if (!prevBase || (*prevBase != ctr->Base)) {
+                projectionPlan.CtrBases.push_back({&CtrData.LearnCtrs.at(ctr->Base), {}});
+                prevBase = &ctr->Base;
+            }
+            projectionPlan.CtrBases.back().Ctrs.push_back({ctr, resultIdx++});
+        }
+    }
+    return applyPlan;
+}
+
+TAtomicSharedPtr<const TStaticCtrProvider::TCtrApplyPlan> TStaticCtrProvider::GetApplyPlan(
+    TConstArrayRef<TModelCtr> neededCtrs
+) {
+    TAtomicSharedPtr<const TCtrApplyPlan> applyPlan;
+    with_lock(ApplyPlanLock) {
+        applyPlan = ApplyPlan;
+    }
+    if (!applyPlan || !std::equal(applyPlan->NeededCtrs.begin(), applyPlan->NeededCtrs.end(), neededCtrs.begin(), neededCtrs.end())) {
+        applyPlan = BuildApplyPlan(neededCtrs).Release();
+        with_lock(ApplyPlanLock) {
+            ApplyPlan = applyPlan;
+        }
+    }
+    return applyPlan;
+}
+
 void TStaticCtrProvider::CalcCtrs(const TConstArrayRef<TModelCtr> neededCtrs,
                                   const TConstArrayRef<ui8> binarizedFeatures,
                                   const TConstArrayRef<ui32> hashedCatFeatures,
@@ -19,109 +162,50 @@ void TStaticCtrProvider::CalcCtrs(const TConstArrayRef<TModelCtr> neededCtrs,
     if (neededCtrs.empty()) {
         return;
     }
-    auto compressedModelCtrs = NCB::CompressModelCtrs(neededCtrs);
+    const auto applyPlan = GetApplyPlan(neededCtrs);
     size_t samplesCount = docCount;
     TVector<ui64> ctrHashes(samplesCount);
     TVector<ui64> buckets(samplesCount);
-    size_t resultIdx = 0;
-    float* resultPtr = result.data();
-    TVector<int> transposedCatFeatureIndexes;
-    TVector<TBinFeatureIndexValue> binarizedIndexes;
-    for (size_t idx = 0; idx < compressedModelCtrs.size(); ++idx) {
-        auto& proj = *compressedModelCtrs[idx].Projection;
-        binarizedIndexes.clear();
-        transposedCatFeatureIndexes.clear();
-        for (const auto feature : proj.CatFeatures) {
-            transposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
-        }
-        for (const auto feature : proj.BinFeatures ) {
-            binarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
-        }
-        for (const auto feature : proj.OneHotFeatures ) {
-            binarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
-        }
-        CalcHashes(binarizedFeatures, hashedCatFeatures, transposedCatFeatureIndexes, binarizedIndexes, docCount, &ctrHashes);
-        for (const auto& ctr: compressedModelCtrs[idx].ModelCtrs) {
-            auto& learnCtr = CtrData.LearnCtrs.at(ctr->Base);
-            auto hashIndexResolver = learnCtr.GetIndexHashViewer();
-            const ECtrType ctrType = ctr->Base.CtrType;
-            auto ptrBuckets = buckets.data();
-            for (size_t docId = 0; docId < samplesCount; ++docId) {
-                ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
-            }
-            if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
-                const auto emptyVal = ctr->Calc(0.f, 0.f);
-                auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        const TCtrMeanHistory& ctrMeanHistory = ctrMean[ptrBuckets[doc]];
-                        resultPtr[doc + resultIdx] = ctr->Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
-                    }
-                }
-            } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-                TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int denominator = learnCtr.CounterDenominator;
-                auto emptyVal = ctr->Calc(0, denominator);
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        resultPtr[doc + resultIdx] = ctr->Calc(ctrTotal[ptrBuckets[doc]], denominator);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
-                    }
-                }
-            } else if (ctrType == ECtrType::Buckets) {
-                auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int targetClassesCount = learnCtr.TargetClassesCount;
-                auto emptyVal = ctr->Calc(0, 0);
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        int goodCount = 0;
-                        int totalCount = 0;
-                        auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
-                        goodCount = ctrHistory[ctr->TargetBorderIdx];
-                        for (int classId = 0; classId < targetClassesCount; ++classId) {
-                            totalCount += ctrHistory[classId];
-                        }
-                        resultPtr[doc + resultIdx] = ctr->Calc(goodCount, totalCount);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
-                    }
-                }
-            } else {
-                auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int targetClassesCount = learnCtr.TargetClassesCount;
-
-                auto emptyVal = ctr->Calc(0, 0);
-                if (targetClassesCount > 2) {
+    for (const auto& projectionPlan : applyPlan->Projections) {
+        CalcHashes(
+            binarizedFeatures,
+            hashedCatFeatures,
+            projectionPlan.TransposedCatFeatureIndexes,
+            projectionPlan.BinarizedIndexes,
+            docCount,
+            &ctrHashes);
+        for (const auto& ctrBasePlan : projectionPlan.CtrBases) {
+            const auto& learnCtr = *ctrBasePlan.Table;
+            GetBucketIndexes(learnCtr.GetIndexHashViewer(), ctrHashes, buckets);
+            const auto ptrBuckets = buckets.data();
+            for (const auto& ctrPlan : ctrBasePlan.Ctrs) {
+                const auto* ctr = ctrPlan.Ctr;
+                const ECtrType ctrType = ctr->Base.CtrType;
+                float* resultPtr = result.data() + ctrPlan.ResultIdx * docCount;
+                if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+                    const auto emptyVal = ctr->Calc(0.f, 0.f);
+                    auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
                     for (size_t doc = 0; doc < samplesCount; ++doc) {
-                        int goodCount = 0;
-                        int totalCount = 0;
                         if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                            auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
-                            for (int classId = 0; classId < ctr->TargetBorderIdx + 1; ++classId) {
-                                totalCount += ctrHistory[classId];
-                            }
-                            for (int classId = ctr->TargetBorderIdx + 1; classId < targetClassesCount; ++classId) {
-                                goodCount += ctrHistory[classId];
-                            }
-                            totalCount += goodCount;
+                            const TCtrMeanHistory& ctrMeanHistory = ctrMean[ptrBuckets[doc]];
+                            resultPtr[doc] = ctr->Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
+                        } else {
+                            resultPtr[doc] = emptyVal;
                         }
-                        resultPtr[doc + resultIdx] = ctr->Calc(goodCount, totalCount);
                     }
                 } else {
-                    for (size_t doc = 0; doc < samplesCount; ++doc) {
-                        if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                            const int* ctrHistory = &ctrIntArray[ptrBuckets[doc] * 2];
-                            resultPtr[doc + resultIdx] = ctr->Calc(ctrHistory[1], ctrHistory[0] + ctrHistory[1]);
-                        } else {
-                            resultPtr[doc + resultIdx] = emptyVal;
-                        }
+                    switch (learnCtr.CounterByteSize) {
+                        case sizeof(ui8):
+                            CalcCtrsFromCounters<ui8>(*ctr, learnCtr, ptrBuckets, samplesCount, resultPtr);
+                            break;
+                        case sizeof(ui16):
+                            CalcCtrsFromCounters<ui16>(*ctr, learnCtr, ptrBuckets, samplesCount, resultPtr);
+                            break;
+                        default:
+                            CalcCtrsFromCounters<int>(*ctr, learnCtr, ptrBuckets, samplesCount, resultPtr);
                     }
                 }
             }
-            resultIdx += docCount;
         }
     }
 }
@@ -138,6 +222,7 @@ bool TStaticCtrProvider::HasNeededCtrs(TConstArrayRef<TModelCtr> neededCtrs) con
 void TStaticCtrProvider::SetupBinFeatureIndexes(const TConstArrayRef<TFloatFeature> floatFeatures,
                                                 const TConstArrayRef<TOneHotFeature> oheFeatures,
                                                 const TConstArrayRef<TCatFeature> catFeatures) {
+    ResetApplyPlan();
     ui32 currentIndex = 0;
     FloatFeatureIndexes.clear();
     for (const auto& floatFeature : floatFeatures) {
@@ -226,9 +311,9 @@ static void MergeBuckets(const TVector<const TCtrValueTable*>& tables, TCtrValue
     case ECtrType::FeatureFreq:
     case ECtrType::Counter:
         {
-            TVector<TConstArrayRef<int>> counters;
+            TVector<NCB::TMaybeOwningConstArrayHolder<int>> counters;
             for (const auto& table : tables) {
-                counters.emplace_back(table->GetTypedArrayRefForBlobData<int>());
+                counters.emplace_back(table->GetIntCounters());
             }
             auto targetBuf = target->AllocateBlobAndGetArrayRef<int>(uniqueHashes.size());
             for (auto hash : uniqueHashes) {
@@ -256,9 +341,9 @@ static void MergeBuckets(const TVector<const TCtrValueTable*>& tables, TCtrValue
     case ECtrType::Borders:
         {
             const auto targetClassesCount = tables.back()->TargetClassesCount;
-            TVector<TConstArrayRef<int>> counters;
+            TVector<NCB::TMaybeOwningConstArrayHolder<int>> counters;
             for (const auto& table : tables) {
-                counters.emplace_back(table->GetTypedArrayRefForBlobData<int>());
+                counters.emplace_back(table->GetIntCounters());
             }
             auto targetBuf = target->AllocateBlobAndGetArrayRef<int>(uniqueHashes.size() * tables.back()->TargetClassesCount);
             for (auto hash : uniqueHashes) {
@@ -5,8 +5,12 @@
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/hash.h>
+#include <util/generic/ptr.h>
 #include <util/generic/utility.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
 
 #include <functional>
 
@@ -37,11 +41,13 @@ public:
     }
 
     void AddCtrCalcerData(TCtrValueTable&& valueTable) override {
+        ResetApplyPlan();
         auto ctrBase = valueTable.ModelCtrBase;
         CtrData.LearnCtrs[ctrBase] = std::move(valueTable);
     }
 
     void DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) override {
+        ResetApplyPlan();
         TCtrData ctrData;
         for (auto& base: usedModelCtrBase) {
             ctrData.LearnCtrs[base] = std::move(CtrData.LearnCtrs[base]);
@@ -54,10 +60,12 @@ public:
     }
 
     void Load(IInputStream* inp) override {
+        ResetApplyPlan();
         ::Load(inp, CtrData);
     }
 
     void LoadNonOwning(TMemoryInput* in) {
+        ResetApplyPlan();
         CtrData.LoadNonOwning(in);
     }
 
@@ -65,8 +73,21 @@ public:
         return "static_provider_v1";
     }
 
+    /* Part id of ctr data with compact counters (see TCtrValueTable::CompactCounters).
+     * Versions that can't read such tables reject it as an unknown model part instead of misreading the counters.
+     */
+    static TString CompactCountersModelPartId() {
+        return "static_provider_v2";
+    }
+
     TString ModelPartIdentifier() const override {
-        return ModelPartId();
+        return HasCompactCounters() ? CompactCountersModelPartId() : ModelPartId();
+    }
+
+    bool HasCompactCounters() const {
+        return AnyOf(CtrData.LearnCtrs, [] (const auto& baseAndTable) {
+            return baseAndTable.second.CounterByteSize != sizeof(int);
+        });
     }
 
     const THashMap<TFloatSplit, TBinFeatureIndexValue>& GetFloatFeatureIndexes() const {
@@ -81,10 +102,53 @@ public:
 
 public:
     TCtrData CtrData;
+private:
+    /* Everything CalcCtrs needs for a particular list of ctrs that does not depend on the data:
+     * feature indexes of projections and value tables of ctr bases.
+     * Ctrs that differ only in prior or target border share a base, its table is probed once for all of them.
+     */
+    struct TCtrApplyPlan {
+        struct TCtr {
+            const TModelCtr* Ctr = nullptr; // points to NeededCtrs
+            size_t ResultIdx = 0;
+        };
+
+        struct TCtrBase {
+            const TCtrValueTable* Table = nullptr;
+            TVector<TCtr> Ctrs;
+        };
+
+        struct TProjection {
+            TVector<int> TransposedCatFeatureIndexes;
+            TVector<TBinFeatureIndexValue> BinarizedIndexes;
+            TVector<TCtrBase> CtrBases;
+        };
+
+    public:
+        TVector<TModelCtr> NeededCtrs;
+        TVector<TProjection> Projections;
+    };
+
+private:
+    THolder<TCtrApplyPlan> BuildApplyPlan(TConstArrayRef<TModelCtr> neededCtrs) const;
+
+    // plan for the last neededCtrs passed to CalcCtrs, rebuilt if they change
+    TAtomicSharedPtr<const TCtrApplyPlan> GetApplyPlan(TConstArrayRef<TModelCtr> neededCtrs);
+
+    // must be called on each change of feature indexes or CtrData
+    void ResetApplyPlan() {
+        with_lock(ApplyPlanLock) {
+            ApplyPlan.Reset();
+        }
+    }
+
 private:
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
+
+    TAtomicSharedPtr<const TCtrApplyPlan> ApplyPlan;
+    TAdaptiveLock ApplyPlanLock;
 };
 
 class TStaticCtrOnFlightSerializationProvider: public ICtrProvider {
@@ -92,12 +156,15 @@ public:
     using TCtrParallelGenerator = std::function<void(const TVector<TModelCtrBase>&, TCtrDataStreamWriter*)>;
 
 public:
+    // compactCounters must be set if the generator can compact counters of tables
     TStaticCtrOnFlightSerializationProvider(
         TVector<TModelCtrBase> ctrBases,
-        TCtrParallelGenerator ctrParallelGenerator
+        TCtrParallelGenerator ctrParallelGenerator,
+        bool compactCounters = false
     )
         : CtrBases(ctrBases)
         , CtrParallelGenerator(ctrParallelGenerator)
+        , CompactCounters(compactCounters)
     {
     }
     ~TStaticCtrOnFlightSerializationProvider() = default;
@@ -148,13 +215,17 @@ public:
             << "TStaticCtrOnFlightSerializationProvider is for streamed serialization only";
     }
 
+    // tables are generated only on Save, after the part id has been written
     TString ModelPartIdentifier() const override {
-        return "static_provider_v1";
+        return CompactCounters
+            ? TStaticCtrProvider::CompactCountersModelPartId()
+            : TStaticCtrProvider::ModelPartId();
     }
 
 private:
     TVector<TModelCtrBase> CtrBases;
     TCtrParallelGenerator CtrParallelGenerator;
+    bool CompactCounters;
 };
 
 TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(
@@ -0,0 +1,172 @@
+#include <catboost/libs/model/static_ctr_provider.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/str.h>
+
+
+static TModelCtrBase MakeCatCtrBase(int catFeatureIdx, ECtrType ctrType) {
+    TModelCtrBase ctrBase;
+    ctrBase.Projection.CatFeatures = {catFeatureIdx};
+    ctrBase.CtrType = ctrType;
+    return ctrBase;
+}
+
+static TModelCtr MakeCtr(const TModelCtrBase& ctrBase, float priorNum, float priorDenom) {
+    TModelCtr ctr;
+    ctr.Base = ctrBase;
+    ctr.PriorNum = priorNum;
+    ctr.PriorDenom = priorDenom;
+    return ctr;
+}
+
+static ui32 GetCatValueHash(ui32 valueIdx) {
+    return valueIdx * 7 + 1;
+}
+
+// value table with entries for cat values [0, valueCount), stats of value v are (v % 5, v % 3) or v % counterMod
+static TCtrValueTable MakeValueTable(const TModelCtrBase& ctrBase, ui32 valueCount, ui32 counterMod = 11) {
+    TCtrValueTable table;
+    table.ModelCtrBase = ctrBase;
+    auto hashBuilder = table.GetIndexHashBuilder(valueCount);
+    if (ctrBase.CtrType == ECtrType::Counter) {
+        table.CounterDenominator = 20;
+        auto counters = table.AllocateBlobAndGetArrayRef<int>(valueCount);
+        for (auto valueIdx : xrange(valueCount)) {
+            const ui32 bucketIdx = hashBuilder.AddIndex(CalcHash(0, (ui64)(int)GetCatValueHash(valueIdx)));
+            counters[bucketIdx] = valueIdx % counterMod;
+        }
+    } else {
+        table.TargetClassesCount = 2;
+        auto history = table.AllocateBlobAndGetArrayRef<int>(2 * valueCount);
+        for (auto valueIdx : xrange(valueCount)) {
+            const ui32 bucketIdx = hashBuilder.AddIndex(CalcHash(0, (ui64)(int)GetCatValueHash(valueIdx)));
+            history[2 * bucketIdx] = valueIdx % 5;
+            history[2 * bucketIdx + 1] = valueIdx % 3;
+        }
+    }
+    return table;
+}
+
+static float CalcExpectedCtr(const TModelCtr& ctr, const TCtrValueTable& table, ui32 catValueHash) {
+    const ui32 bucketIdx = table.GetIndexHashViewer().GetIndex(CalcHash(0, (ui64)(int)catValueHash));
+    if (ctr.Base.CtrType == ECtrType::Counter) {
+        const int count = bucketIdx == NCatboost::TDenseIndexHashView::NotFoundIndex
+            ? 0
+            : table.GetIntCounters()[bucketIdx];
+        return ctr.Calc(count, table.CounterDenominator);
+    }
+    if (bucketIdx == NCatboost::TDenseIndexHashView::NotFoundIndex) {
+        return ctr.Calc(0, 0);
+    }
+    const auto counters = table.GetIntCounters();
+    return ctr.Calc(counters[2 * bucketIdx + 1], counters[2 * bucketIdx] + counters[2 * bucketIdx + 1]);
+}
+
+Y_UNIT_TEST_SUITE(TStaticCtrProvider) {
+    Y_UNIT_TEST(CalcCtrsOnLargeTables) {
+        const ui32 valueCount = 1 << 17;
+        const size_t docCount = 1000;
+
+        const auto bordersBase = MakeCatCtrBase(0, ECtrType::Borders);
+        const auto counterBase = MakeCatCtrBase(1, ECtrType::Counter);
+
+        TStaticCtrProvider provider;
+        provider.AddCtrCalcerData(MakeValueTable(bordersBase, valueCount));
+        provider.AddCtrCalcerData(MakeValueTable(counterBase, valueCount));
+        const TCatFeature catFeatures[] = {TCatFeature(true, 0, 0, "c0"), TCatFeature(true, 1, 1, "c1")};
+        provider.SetupBinFeatureIndexes({}, {}, catFeatures);
+
+        // two ctrs share the borders table
+        TVector<TModelCtr> neededCtrs = {
+            MakeCtr(bordersBase, 0.0f, 1.0f),
+            MakeCtr(bordersBase, 0.5f, 1.0f),
+            MakeCtr(counterBase, 1.0f, 2.0f)
+        };
+        Sort(neededCtrs);
+
+        TFastRng64 rng(0);
+        TVector<ui32> hashedCatFeatures(2 * docCount); // [featureIdx][docIdx]
+        for (auto& catValueHash : hashedCatFeatures) {
+            // about a quarter of values are not in tables
+            catValueHash = GetCatValueHash(rng.Uniform(valueCount + valueCount / 3));
+        }
+
+        const auto checkCtrs = [&] (TConstArrayRef<TModelCtr> ctrs) {
+            TVector<float> result(ctrs.size() * docCount);
+            provider.CalcCtrs(ctrs, {}, hashedCatFeatures, docCount, result);
+            for (auto ctrIdx : xrange(ctrs.size())) {
+                const auto& ctr = ctrs[ctrIdx];
+                const auto& table = provider.CtrData.LearnCtrs.at(ctr.Base);
+                const int catFeatureIdx = ctr.Base.Projection.CatFeatures[0];
+                for (auto docIdx : xrange(docCount)) {
+                    UNIT_ASSERT_VALUES_EQUAL(
+                        result[ctrIdx * docCount + docIdx],
+                        CalcExpectedCtr(ctr, table, hashedCatFeatures[catFeatureIdx * docCount + docIdx]));
+                }
+            }
+        };
+
+        checkCtrs(neededCtrs);
+        checkCtrs(neededCtrs);
+        checkCtrs(MakeArrayRef(neededCtrs).subspan(1));
+        checkCtrs(neededCtrs);
+    }
+
+    Y_UNIT_TEST(CompactCounters) {
+        const ui32 valueCount = 1 << 12;
+        const size_t docCount = 500;
+
+        const auto bordersBase = MakeCatCtrBase(0, ECtrType::Borders);
+        const auto counterBase = MakeCatCtrBase(1, ECtrType::Counter);
+        const TVector<TModelCtr> neededCtrs = {MakeCtr(bordersBase, 0.5f, 1.0f), MakeCtr(counterBase, 1.0f, 2.0f)};
+
+        TStaticCtrProvider provider;
+        provider.AddCtrCalcerData(MakeValueTable(bordersBase, valueCount));
+        provider.AddCtrCalcerData(MakeValueTable(counterBase, valueCount, /*counterMod*/ 1000));
+        const TCatFeature catFeatures[] = {TCatFeature(true, 0, 0, "c0"), TCatFeature(true, 1, 1, "c1")};
+        provider.SetupBinFeatureIndexes({}, {}, catFeatures);
+
+        TFastRng64 rng(0);
+        TVector<ui32> hashedCatFeatures(2 * docCount);
+        for (auto& catValueHash : hashedCatFeatures) {
+            catValueHash = GetCatValueHash(rng.Uniform(valueCount + valueCount / 3));
+        }
+
+        TVector<float> expectedResult(neededCtrs.size() * docCount);
+        provider.CalcCtrs(neededCtrs, {}, hashedCatFeatures, docCount, expectedResult);
+
+        UNIT_ASSERT_VALUES_EQUAL(provider.ModelPartIdentifier(), TStaticCtrProvider::ModelPartId());
+
+        TVector<TVector<int>> expectedCounters;
+        for (const auto& ctr : neededCtrs) {
+            auto& table = provider.CtrData.LearnCtrs.at(ctr.Base);
+            const auto counters = table.GetIntCounters();
+            expectedCounters.emplace_back((*counters).begin(), (*counters).end());
+            table.CompactCounters();
+        }
+        UNIT_ASSERT_VALUES_EQUAL(provider.CtrData.LearnCtrs.at(bordersBase).CounterByteSize, sizeof(ui8));
+        UNIT_ASSERT_VALUES_EQUAL(provider.CtrData.LearnCtrs.at(counterBase).CounterByteSize, sizeof(ui16));
+        // older versions must not misread the compacted counters
+        UNIT_ASSERT_VALUES_EQUAL(provider.ModelPartIdentifier(), TStaticCtrProvider::CompactCountersModelPartId());
+
+        for (auto ctrIdx : xrange(neededCtrs.size())) {
+            const auto& table = provider.CtrData.LearnCtrs.at(neededCtrs[ctrIdx].Base);
+            TStringStream stream;
+            table.Save(&stream);
+            TCtrValueTable loadedTable;
+            loadedTable.Load(&stream);
+            UNIT_ASSERT_VALUES_EQUAL(loadedTable.CounterByteSize, table.CounterByteSize);
+            UNIT_ASSERT(loadedTable == table);
+            const auto counters = loadedTable.GetIntCounters();
+            UNIT_ASSERT_VALUES_EQUAL(TVector<int>((*counters).begin(), (*counters).end()), expectedCounters[ctrIdx]);
+        }
+
+        TVector<float> result(neededCtrs.size() * docCount);
+        provider.CalcCtrs(neededCtrs, {}, hashedCatFeatures, docCount, result);
+        UNIT_ASSERT_VALUES_EQUAL(result, expectedResult);
+    }
+}
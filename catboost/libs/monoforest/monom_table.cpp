@@ -0,0 +1,119 @@
+#include "monom_table.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/digest/numeric.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+
+namespace NMonoForest {
+    static constexpr size_t MinSlotCount = 64;
+
+    ui64 TMonomTable::EncodeSplit(const TBinarySplit& split) {
+        CB_ENSURE_INTERNAL(split.BinIdx < (1u << 31), "Bin index " << split.BinIdx << " is too big");
+        return (ui64(split.FeatureId) << 32) | (ui64(split.BinIdx) << 1) | ui64(split.SplitType);
+    }
+
+    TBinarySplit TMonomTable::DecodeSplit(ui64 code) {
+        return TBinarySplit(code >> 32, (code & Max<ui32>()) >> 1, static_cast<EBinSplitType>(code & 1));
+    }
+
+    void TMonomTable::SetDimension(ui32 dimension) {
+        if (Monoms.empty()) {
+            Dimension = dimension;
+        }
+        CB_ENSURE(Dimension == dimension, "Trees with different output dimensions: " << Dimension << " ≠ " << dimension);
+    }
+
+    ui64 TMonomTable::CalcHash(TConstArrayRef<ui64> splitCodes) {
+        ui64 hash = splitCodes.size();
+        for (auto code : splitCodes) {
+            hash = CombineHashes(hash, IntHash(code));
+        }
+        return hash;
+    }
+
+    void TMonomTable::Rehash(size_t slotCount) {
+        Slots.assign(slotCount, 0);
+        const size_t slotMask = slotCount - 1;
+        for (auto monomIdx : xrange(Monoms.size())) {
+            size_t slotIdx = Monoms[monomIdx].Hash & slotMask;
+            while (Slots[slotIdx]) {
+                slotIdx = (slotIdx + 1) & slotMask;
+            }
+            Slots[slotIdx] = monomIdx + 1;
+        }
+    }
+
+    ui32 TMonomTable::FindOrAdd(TConstArrayRef<ui64> splitCodes) {
+        if (2 * (Monoms.size() + 1) > Slots.size()) {
+            Rehash(Max(MinSlotCount, 2 * Slots.size()));
+        }
+        const ui64 hash = CalcHash(splitCodes);
+        const size_t slotMask = Slots.size() - 1;
+        size_t slotIdx = hash & slotMask;
+        for (; Slots[slotIdx]; slotIdx = (slotIdx + 1) & slotMask) {
+            const ui32 monomIdx = Slots[slotIdx] - 1;
+            const auto& monom = Monoms[monomIdx];
+            if (monom.Hash == hash && Equal(splitCodes.begin(), splitCodes.end(), GetSplitCodes(monom).begin(), GetSplitCodes(monom).end())) {
+                return monomIdx;
+            }
+        }
+        const ui32 monomIdx = Monoms.size();
+        TMonomEntry monom;
+        monom.Hash = hash;
+        monom.SplitsOffset = SplitCodes.size();
+        monom.SplitCount = splitCodes.size();
+        Monoms.push_back(monom);
+        SplitCodes.insert(SplitCodes.end(), splitCodes.begin(), splitCodes.end());
+        Values.resize(Values.size() + Dimension);
+        Slots[slotIdx] = monomIdx + 1;
+        return monomIdx;
+    }
+
+    void TMonomTable::SetWeight(ui32 monomIdx, double weight) {
+        auto& dst = Monoms[monomIdx].Weight;
+        if (dst < 0) {
+            dst = weight;
+        } else {
+            CB_ENSURE(dst == weight,
+                      "error: monom weight depends on dataset only: " << weight << " ≠ " << dst);
+        }
+    }
+
+    void TMonomTable::Merge(const TMonomTable& other) {
+        if (other.Monoms.empty()) {
+            return;
+        }
+        SetDimension(other.Dimension);
+        for (auto otherIdx : xrange(other.Monoms.size())) {
+            const auto& otherMonom = other.Monoms[otherIdx];
+            const ui32 monomIdx = FindOrAdd(other.GetSplitCodes(otherMonom));
+            if (otherMonom.Weight >= 0) {
+                SetWeight(monomIdx, otherMonom.Weight);
+            }
+            auto value = GetValue(monomIdx);
+            const double* otherValue = other.Values.data() + (size_t)otherIdx * Dimension;
+            for (auto dim : xrange(Dimension)) {
+                value[dim] += otherValue[dim];
+            }
+        }
+    }
+
+    THashMap<TMonomStructure, TMonomStat> TMonomTable::Export() const {
+        THashMap<TMonomStructure, TMonomStat> monoms;
+        monoms.reserve(Monoms.size());
+        for (auto monomIdx : xrange(Monoms.size())) {
+            const auto& monom = Monoms[monomIdx];
+            TMonomStructure structure;
+            for (auto code : GetSplitCodes(monom)) {
+                structure.AddSplit(DecodeSplit(code));
+            }
+            const double* value = Values.data() + (size_t)monomIdx * Dimension;
+            auto& dst = monoms[structure];
+            dst.Value.assign(value, value + Dimension);
+            dst.Weight = monom.Weight;
+        }
+        return monoms;
+    }
+}
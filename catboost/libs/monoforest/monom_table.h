@@ -0,0 +1,71 @@
+#pragma once
+
+#include "monom.h"
+#include "split.h"
+
+#include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NMonoForest {
+    /* Open-addressing table of monoms used by TPolynomBuilder.
+     * Monom structure is a sorted sequence of split codes (see EncodeSplit) stored in one buffer,
+     * values of all monoms are stored in one buffer too, so there are no per-monom allocations.
+     */
+    class TMonomTable {
+    public:
+        // codes are ordered in the same way as splits
+        static ui64 EncodeSplit(const TBinarySplit& split);
+        static TBinarySplit DecodeSplit(ui64 code);
+
+        // can be changed only while the table is empty
+        void SetDimension(ui32 dimension);
+
+        ui32 GetDimension() const {
+            return Dimension;
+        }
+
+        size_t Size() const {
+            return Monoms.size();
+        }
+
+        // splitCodes must be sorted and unique, returns index of monom
+        ui32 FindOrAdd(TConstArrayRef<ui64> splitCodes);
+
+        TArrayRef<double> GetValue(ui32 monomIdx) {
+            return TArrayRef<double>(Values.data() + (size_t)monomIdx * Dimension, Dimension);
+        }
+
+        // weight depends on dataset only, so it must be the same for all trees with the monom
+        void SetWeight(ui32 monomIdx, double weight);
+
+        void Merge(const TMonomTable& other);
+
+        THashMap<TMonomStructure, TMonomStat> Export() const;
+
+    private:
+        struct TMonomEntry {
+            ui64 Hash = 0;
+            ui32 SplitsOffset = 0;
+            ui32 SplitCount = 0;
+            double Weight = -1;
+        };
+
+    private:
+        static ui64 CalcHash(TConstArrayRef<ui64> splitCodes);
+
+        TConstArrayRef<ui64> GetSplitCodes(const TMonomEntry& monom) const {
+            return TConstArrayRef<ui64>(SplitCodes.data() + monom.SplitsOffset, monom.SplitCount);
+        }
+
+        void Rehash(size_t slotCount);
+
+    private:
+        ui32 Dimension = 0;
+        TVector<ui32> Slots; // monomIdx + 1, 0 for empty slots
+        TVector<TMonomEntry> Monoms;
+        TVector<ui64> SplitCodes;
+        TVector<double> Values; // [monomIdx * Dimension + dim]
+    };
+}
@@ -2,186 +2,133 @@
 
 #include <catboost/libs/helpers/set.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/xrange.h>
 
-namespace NMonoForest {
-    struct TPathBit {
-        int Bits = 0;
-        int Sign = 1;
-    };
-
-    static inline TVector<TPathBit> LeafToPolynoms(const int path, int maxDepth) {
-        TVector<TPathBit> pathBits = {{}};
-        for (int depth = 0; depth < maxDepth; ++depth) {
-            const int mask = 1 << depth;
-            const bool isOne = path & mask;
+#include <bit>
 
-            if (isOne) {
-                for (auto& bit : pathBits) {
-                    bit.Bits |= 1 << depth;
+namespace NMonoForest {
+    // codes of splits with the mask bits, x > a and x > b are merged into x > max(a, b);
+    // returns false if there are several one-hot splits of the same feature (such monom is always zero)
+    static bool GetMonomSplitCodes(
+        TConstArrayRef<TBinarySplit> splits,
+        TConstArrayRef<ui64> splitCodes,
+        ui32 mask,
+        TVector<ui64>* monomSplitCodes)
+    {
+        monomSplitCodes->clear();
+        bool isNonZero = true;
+        for (auto depth : xrange(splits.size())) {
+            if (!(mask & (1u << depth))) {
+                continue;
+            }
+            const auto& split = splits[depth];
+            ui64 code = splitCodes[depth];
+            for (auto otherDepth : xrange(splits.size())) {
+                if (otherDepth == depth || !(mask & (1u << otherDepth)) || splits[otherDepth].FeatureId != split.FeatureId) {
+                    continue;
                 }
-            } else {
-                ui64 currentPaths = pathBits.size();
-                for (ui64 i = 0; i < currentPaths; ++i) {
-                    auto bit = pathBits[i];
-                    bit.Bits |= 1 << depth;
-                    bit.Sign *= -1;
-                    pathBits.push_back(bit);
+                if (split.SplitType == EBinSplitType::TakeBin) {
+                    isNonZero = false;
+                } else {
+                    code = Max(code, splitCodes[otherDepth]);
                 }
             }
+            monomSplitCodes->push_back(code);
         }
-        return pathBits;
+        SortUnique(*monomSplitCodes);
+        return isNonZero;
     }
 
     void TPolynomBuilder::AddTree(const TObliviousTree& tree) {
-        const auto& treeStructure = tree.GetStructure();
-
-        const int maxDepth = static_cast<int>(treeStructure.GetDepth());
-        const int leavesCount = treeStructure.LeavesCount();
-
-        TVector<double> values(leavesCount * tree.OutputDim());
-
-        for (int path = 0; path < leavesCount; ++path) {
-            auto polynoms = LeafToPolynoms(path, maxDepth);
-
-            for (const auto& polynom : polynoms) {
-                int idx = polynom.Bits;
-                for (ui32 dim = 0; dim < tree.OutputDim(); ++dim) {
-                    values[idx * tree.OutputDim() + dim] +=
-                        polynom.Sign * tree.GetValues()[path * tree.OutputDim() + dim];
+        const auto& treeSplits = tree.GetStructure().Splits;
+        const int maxDepth = static_cast<int>(treeSplits.size());
+        const int leavesCount = tree.LeavesCount();
+        const ui32 outputDim = tree.OutputDim();
+        Monoms.SetDimension(outputDim);
+
+        // monom with the splits of mask has the value sum((-1)^|mask \ leaf| * leafValue) over leaves
+        // with path bits from mask only, which is the Moebius transform of leaf values
+        TVector<double> values = tree.GetValues();
+        for (int depth = 0; depth < maxDepth; ++depth) {
+            const int bit = 1 << depth;
+            for (int mask = 0; mask < leavesCount; ++mask) {
+                if (mask & bit) {
+                    for (ui32 dim = 0; dim < outputDim; ++dim) {
+                        values[mask * outputDim + dim] -= values[(mask ^ bit) * outputDim + dim];
+                    }
                 }
             }
         }
 
-        THashMap<TMonomStructure, TMonomStat> monomsEnsemble;
-
-        for (int i = 0; i < leavesCount; ++i) {
-            TMonomStructure monomStructure;
-
-            THashMap<int, int> maxBins;
-            TVector<TBinarySplit> splits;
+        // weight of the splits of mask is the sum of weights of leaves with all these path bits set
+        TVector<double> weights = tree.GetWeights();
+        const bool hasWeights = !weights.empty();
+        if (hasWeights) {
             for (int depth = 0; depth < maxDepth; ++depth) {
-                int mask = 1 << depth;
-                if (i & mask) {
-                    auto& split = treeStructure.Splits[depth];
-                    maxBins[split.FeatureId] = Max<int>(split.BinIdx, maxBins[split.FeatureId]);
-                    splits.push_back(split);
-                }
-            }
-            THashMap<int, int> oheSplits;
-            bool degenerate = false;
-
-            for (const auto split : splits) {
-                if (split.SplitType == EBinSplitType::TakeBin) {
-                    oheSplits[split.FeatureId]++;
-                    if (oheSplits[split.FeatureId] > 1) {
-                        degenerate = true;
+                const int bit = 1 << depth;
+                for (int mask = 0; mask < leavesCount; ++mask) {
+                    if (!(mask & bit)) {
+                        weights[mask] += weights[mask | bit];
                     }
-                    monomStructure.Splits.push_back(split);
-                } else {
-                    TBinarySplit fixedSplit = split;
-                    fixedSplit.BinIdx = maxBins[split.FeatureId];
-                    monomStructure.Splits.push_back(fixedSplit);
                 }
             }
-            if (degenerate) {
+        }
+
+        TVector<ui64> splitCodes;
+        for (const auto& split : treeSplits) {
+            splitCodes.push_back(TMonomTable::EncodeSplit(split));
+        }
+        TVector<ui64> monomSplitCodes;
+        for (int mask = 0; mask < leavesCount; ++mask) {
+            if (!GetMonomSplitCodes(treeSplits, splitCodes, mask, &monomSplitCodes)) {
                 continue;
             }
-            SortUnique(monomStructure.Splits);
-
-            int weightMask = 0;
-            for (const auto& split : monomStructure.Splits) {
+            const ui32 monomIdx = Monoms.FindOrAdd(monomSplitCodes);
+            auto monomValue = Monoms.GetValue(monomIdx);
+            for (ui32 dim = 0; dim < outputDim; ++dim) {
+                monomValue[dim] += values[mask * outputDim + dim];
+            }
+            if (hasWeights) {
+                int weightMask = 0;
                 for (int depth = 0; depth < maxDepth; ++depth) {
-                    const auto& treeSplit = treeStructure.Splits[depth];
-                    if (treeSplit == split) {
+                    if (BinarySearch(monomSplitCodes.begin(), monomSplitCodes.end(), splitCodes[depth])) {
                         weightMask |= 1 << depth;
                     }
                 }
-            }
-            double monomWeight = 0;
-            for (int leaf = 0; leaf < leavesCount; ++leaf) {
-                if ((leaf & weightMask) == weightMask) {
-                    monomWeight += tree.GetWeights()[leaf];
-                }
-            }
-
-            auto& dst = monomsEnsemble[monomStructure];
-
-            if (dst.Weight < 0) {
-                dst.Weight = monomWeight;
-            } else {
-                CB_ENSURE(dst.Weight == monomWeight,
-                          "error: monom weight depends on dataset only: " << monomWeight << " ≠ "
-                                                                          << dst.Weight);
-            }
-
-            if (dst.Value.size() < tree.OutputDim()) {
-                dst.Value.resize(tree.OutputDim());
-            }
-            for (ui32 dim = 0; dim < tree.OutputDim(); ++dim) {
-                dst.Value[dim] += values[i * tree.OutputDim() + dim];
-            }
-        }
-
-        for (const auto& [structure, stat] : monomsEnsemble) {
-            auto& dst = MonomsEnsemble[structure];
-            if (dst.Weight < 0) {
-                dst.Weight = stat.Weight;
-            } else {
-                CB_ENSURE(dst.Weight == stat.Weight,
-                          "error: monom weight depends on dataset only: " << stat.Weight << " ≠ "
-                                                                          << dst.Weight);
-            }
-            if (dst.Value.size() < tree.OutputDim()) {
-                dst.Value.resize(tree.OutputDim());
-            }
-            for (ui32 k = 0; k < tree.OutputDim(); ++k) {
-                dst.Value[k] += stat.Value[k];
+                Monoms.SetWeight(monomIdx, weights[weightMask]);
             }
         }
     }
 
     void TPolynomBuilder::AddTree(const TNonSymmetricTree& tree) {
+        TVector<ui64> splitCodes;
+        TVector<ui64> monomSplitCodes;
         auto visitor = [&](const TLeafPath& path, TConstArrayRef<float> leaf, double) {
           CB_ENSURE(leaf.size());
+          Monoms.SetDimension(leaf.size());
 
-          int bits = 0;
+          ui32 bits = 0;
+          splitCodes.clear();
           for (ui32 depth = 0; depth < path.GetDepth(); ++depth) {
               if (path.Directions[depth] == ESplitValue::One) {
-                  bits |= 1 << depth;
+                  bits |= 1u << depth;
               }
+              splitCodes.push_back(TMonomTable::EncodeSplit(path.Splits[depth]));
           }
-          auto monoms = LeafToPolynoms(bits, path.GetDepth());
 
-          for (const auto& monom : monoms) {
-              const int activeFeatures = monom.Bits;
-              THashMap<TBinarySplit, ui32> splits;
+          // leaf value goes with sign (-1)^|S| to monoms with the splits of bits and S for all S from zero directions
+          const ui32 zeroBits = ((1u << path.GetDepth()) - 1) & ~bits;
+          for (ui32 subset = zeroBits; ; subset = (subset - 1) & zeroBits) {
+              GetMonomSplitCodes(path.Splits, splitCodes, bits | subset, &monomSplitCodes);
 
-              for (ui32 i = 0; i < path.GetDepth(); ++i) {
-                  if (activeFeatures & (1 << i)) {
-                      auto srcSplit = path.Splits[i];
-
-                      if (srcSplit.SplitType == EBinSplitType::TakeGreater) {
-                          auto baseSplit = srcSplit;
-                          baseSplit.BinIdx = 0;
-                          splits[baseSplit] = std::max<ui32>(splits[baseSplit], srcSplit.BinIdx);
-                      } else {
-                          splits[srcSplit] = srcSplit.BinIdx;
-                      }
-                  }
-              }
-
-              TMonomStructure structure;
-              for (const auto& [baseSplit, binIdx] : splits) {
-                  auto split = baseSplit;
-                  split.BinIdx = binIdx;
-                  structure.Splits.push_back(split);
-              }
-              SortUnique(structure.Splits);
-              auto& dst = MonomsEnsemble[structure];
-              dst.Value.resize(leaf.size());
+              const double sign = std::popcount(subset) % 2 ? -1.0 : 1.0;
+              auto monomValue = Monoms.GetValue(Monoms.FindOrAdd(monomSplitCodes));
               for (ui32 i = 0; i < leaf.size(); ++i) {
-                  dst.Value[i] += monom.Sign * leaf[i];
+                  monomValue[i] += sign * leaf[i];
+              }
+              if (subset == 0) {
+                  break;
               }
           }
         };
@@ -189,7 +136,7 @@ namespace NMonoForest {
     }
 
     TPolynom TPolynomBuilder::Build() {
-        return {MonomsEnsemble};
+        return {Monoms.Export()};
     }
 
     static inline void AddMonomToTree(const TMonom& monom, const TObliviousTreeStructure& treeStructure, TArrayRef<double> leafValues) {
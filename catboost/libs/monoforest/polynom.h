@@ -2,9 +2,14 @@
 
 #include "additive_model.h"
 #include "monom.h"
+#include "monom_table.h"
 #include "oblivious_tree.h"
 #include "non_symmetric_tree.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/hash.h>
+#include <util/generic/xrange.h>
 
 namespace NMonoForest {
     struct TPolynom {
@@ -22,12 +27,39 @@ namespace NMonoForest {
     public:
         void AddTree(const TObliviousTree& tree);
         void AddTree(const TNonSymmetricTree& tree);
+
+        // expands blocks of trees in parallel and merges their monoms in the order of blocks
+        template <class TWeakModel>
+        void AddTrees(const TAdditiveModel<TWeakModel>& model, NPar::ILocalExecutor* localExecutor);
+
         TPolynom Build();
 
     private:
-        THashMap<TMonomStructure, TMonomStat> MonomsEnsemble;
+        TMonomTable Monoms;
     };
 
+    template <class TWeakModel>
+    void TPolynomBuilder::AddTrees(const TAdditiveModel<TWeakModel>& model, NPar::ILocalExecutor* localExecutor) {
+        NPar::ILocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(model.Size()));
+        blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+        TVector<TPolynomBuilder> blockBuilders(blockParams.GetBlockCount());
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                const int blockBegin = blockParams.FirstId + blockIdx * blockParams.GetBlockSize();
+                const int blockEnd = Min(blockBegin + blockParams.GetBlockSize(), blockParams.LastId);
+                for (auto treeIdx : xrange(blockBegin, blockEnd)) {
+                    blockBuilders[blockIdx].AddTree(model.GetWeakModel(treeIdx));
+                }
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        for (const auto& blockBuilder : blockBuilders) {
+            Monoms.Merge(blockBuilder.Monoms);
+        }
+    }
+
     template <typename TWeakModel>
     class IPolynomToAdditiveModelConverter {
     public:
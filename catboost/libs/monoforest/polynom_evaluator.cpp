@@ -0,0 +1,125 @@
+#include "polynom_evaluator.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash.h>
+#include <util/generic/xrange.h>
+
+#include <array>
+
+namespace NMonoForest {
+    TVector<ui32> BinarizeFeature(const IGrid& grid, int featureIdx, TConstArrayRef<float> values) {
+        const int borderCount = grid.BorderCount(featureIdx);
+        TVector<float> borders;
+        borders.reserve(borderCount);
+        for (auto borderIdx : xrange(borderCount)) {
+            borders.push_back(grid.Border(featureIdx, borderIdx));
+        }
+
+        TVector<ui32> bins;
+        bins.yresize(values.size());
+        if (grid.FeatureType(featureIdx) == EFeatureType::Float) {
+            for (auto docIdx : xrange(values.size())) {
+                bins[docIdx] = LowerBound(borders.begin(), borders.end(), values[docIdx]) - borders.begin();
+            }
+        } else {
+            THashMap<float, ui32> valueToBin;
+            for (auto borderIdx : xrange(borderCount)) {
+                valueToBin[borders[borderIdx]] = borderIdx;
+            }
+            for (auto docIdx : xrange(values.size())) {
+                const auto binIt = valueToBin.find(values[docIdx]);
+                bins[docIdx] = binIt != valueToBin.end() ? binIt->second : borderCount;
+            }
+        }
+        return bins;
+    }
+
+    TPolynomEvaluator::TPolynomEvaluator(const TPolynom& polynom) {
+        if (polynom.MonomsEnsemble.empty()) {
+            return;
+        }
+        Dimension = polynom.Dimension();
+        SplitOffsets.push_back(0);
+        for (const auto& [structure, stat] : polynom.MonomsEnsemble) {
+            CB_ENSURE(stat.Value.size() == Dimension, "Monoms with different dimensions");
+            Splits.insert(Splits.end(), structure.Splits.begin(), structure.Splits.end());
+            SplitOffsets.push_back(Splits.size());
+            Values.insert(Values.end(), stat.Value.begin(), stat.Value.end());
+        }
+    }
+
+    void TPolynomEvaluator::CalcBlock(
+        TConstArrayRef<TConstArrayRef<ui32>> featureBins,
+        ui32 blockBegin,
+        ui32 blockEnd,
+        TArrayRef<double> result) const
+    {
+        const ui32 blockSize = blockEnd - blockBegin;
+        std::array<ui8, DOC_BLOCK_SIZE> isSatisfied;
+        for (auto monomIdx : xrange(SplitOffsets.size() - 1)) {
+            Fill(isSatisfied.begin(), isSatisfied.begin() + blockSize, 1);
+            for (auto splitIdx : xrange(SplitOffsets[monomIdx], SplitOffsets[monomIdx + 1])) {
+                const auto& split = Splits[splitIdx];
+                const ui32* bins = featureBins[split.FeatureId].data() + blockBegin;
+                const ui32 binIdx = split.BinIdx;
+                if (split.SplitType == EBinSplitType::TakeGreater) {
+                    for (ui32 docIdx = 0; docIdx < blockSize; ++docIdx) {
+                        isSatisfied[docIdx] &= bins[docIdx] > binIdx;
+                    }
+                } else {
+                    for (ui32 docIdx = 0; docIdx < blockSize; ++docIdx) {
+                        isSatisfied[docIdx] &= bins[docIdx] == binIdx;
+                    }
+                }
+            }
+            const double* value = Values.data() + monomIdx * Dimension;
+            if (Dimension == 1) {
+                double* blockResult = result.data() + blockBegin;
+                for (ui32 docIdx = 0; docIdx < blockSize; ++docIdx) {
+                    blockResult[docIdx] += isSatisfied[docIdx] * value[0];
+                }
+            } else {
+                for (ui32 docIdx = 0; docIdx < blockSize; ++docIdx) {
+                    if (isSatisfied[docIdx]) {
+                        double* docResult = result.data() + (size_t)(blockBegin + docIdx) * Dimension;
+                        for (auto dim : xrange(Dimension)) {
+                            docResult[dim] += value[dim];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void TPolynomEvaluator::Calc(
+        TConstArrayRef<TConstArrayRef<ui32>> featureBins,
+        TArrayRef<double> result,
+        NPar::ILocalExecutor* localExecutor) const
+    {
+        Fill(result.begin(), result.end(), 0.0);
+        if (Dimension == 0) {
+            return;
+        }
+        CB_ENSURE(result.size() % Dimension == 0, "Result size is not a multiple of polynom dimension");
+        const ui32 docCount = result.size() / Dimension;
+        for (const auto& split : Splits) {
+            CB_ENSURE(split.FeatureId < featureBins.size(), "No bins for feature " << split.FeatureId);
+            CB_ENSURE(featureBins[split.FeatureId].size() == docCount, "Wrong bins count of feature " << split.FeatureId);
+        }
+
+        NPar::ILocalExecutor::TExecRangeParams blockParams(0, docCount);
+        blockParams.SetBlockSize(DOC_BLOCK_SIZE);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                const ui32 blockBegin = blockIdx * DOC_BLOCK_SIZE;
+                const ui32 blockEnd = Min(blockBegin + DOC_BLOCK_SIZE, docCount);
+                CalcBlock(featureBins, blockBegin, blockEnd, result);
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "grid.h"
+#include "polynom.h"
+#include "split.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NMonoForest {
+    /* Bin of a float feature value is the number of grid borders less than the value,
+     * bin of a one-hot feature value is the index of the value in grid borders
+     * or the borders count if the value is unknown.
+     */
+    TVector<ui32> BinarizeFeature(const IGrid& grid, int featureIdx, TConstArrayRef<float> values);
+
+    /* Calculates polynom values for documents given by feature bins.
+     * Documents are processed in blocks: each monom computes a mask of documents satisfying its splits
+     * with one pass over the block per split, so inner loops run over contiguous arrays of documents.
+     */
+    class TPolynomEvaluator {
+    public:
+        static constexpr ui32 DOC_BLOCK_SIZE = 512;
+
+    public:
+        explicit TPolynomEvaluator(const TPolynom& polynom);
+
+        ui32 GetDimension() const {
+            return Dimension;
+        }
+
+        // featureBins is [featureIdx][docIdx], result is [docIdx * dimension + dim]
+        void Calc(
+            TConstArrayRef<TConstArrayRef<ui32>> featureBins,
+            TArrayRef<double> result,
+            NPar::ILocalExecutor* localExecutor) const;
+
+    private:
+        void CalcBlock(
+            TConstArrayRef<TConstArrayRef<ui32>> featureBins,
+            ui32 blockBegin,
+            ui32 blockEnd,
+            TArrayRef<double> result) const;
+
+    private:
+        ui32 Dimension = 0;
+        TVector<TBinarySplit> Splits; // splits of monom i are [SplitOffsets[i], SplitOffsets[i + 1])
+        TVector<ui32> SplitOffsets;
+        TVector<double> Values; // [monomIdx * Dimension + dim]
+    };
+}
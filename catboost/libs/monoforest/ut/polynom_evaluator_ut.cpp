@@ -0,0 +1,137 @@
+#include <catboost/libs/monoforest/model_import.h>
+#include <catboost/libs/monoforest/polynom_evaluator.h>
+
+#include <catboost/libs/model/model_build_helper.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NMonoForest;
+
+
+static const int OneHotValues[] = {5, 17, 42};
+
+// two float features with flat indices 0 and 2, one-hot feature with flat index 1
+static TFullModel MakeModel(int approxDimension, ui64 seed) {
+    const TVector<TFloatFeature> floatFeatures = {
+        TFloatFeature(false, 0, 0, {-0.5f, 0.f, 0.25f}, "f0"),
+        TFloatFeature(false, 1, 2, {0.1f, 0.7f}, "f2")
+    };
+    const TVector<TCatFeature> catFeatures = {TCatFeature(true, 0, 1, "c1")};
+    const TModelSplit splits[] = {
+        TModelSplit(TFloatSplit(0, -0.5f)),
+        TModelSplit(TFloatSplit(0, 0.f)),
+        TModelSplit(TFloatSplit(0, 0.25f)),
+        TModelSplit(TFloatSplit(1, 0.1f)),
+        TModelSplit(TFloatSplit(1, 0.7f)),
+        TModelSplit(TOneHotSplit(0, OneHotValues[0])),
+        TModelSplit(TOneHotSplit(0, OneHotValues[2]))
+    };
+
+    TFastRng<ui64> prng(seed);
+    TObliviousTreeBuilder builder(floatFeatures, catFeatures, {}, {}, approxDimension);
+    for (auto treeIdx : xrange(20)) {
+        const ui32 depth = treeIdx % 3 + 1;
+        // the first trees use all the splits, so all the borders are in the model
+        TVector<TModelSplit> treeSplits = {splits[treeIdx % std::size(splits)]};
+        while (treeSplits.size() < depth) {
+            treeSplits.push_back(splits[prng.Uniform(std::size(splits))]);
+        }
+        TVector<double> leafValues((1 << depth) * approxDimension);
+        for (auto& value : leafValues) {
+            value = prng.GenRandReal1() - 0.5;
+        }
+        builder.AddTree(treeSplits, leafValues, TVector<double>(1 << depth, 1.0));
+    }
+
+    TFullModel model;
+    builder.Build(model.ModelTrees.GetMutable());
+    // bias is supported for single-dimensional models only
+    model.SetScaleAndBias({0.5, TVector<double>(approxDimension, approxDimension == 1 ? 0.25 : 0.0)});
+    model.UpdateDynamicData();
+    return model;
+}
+
+static void CheckPolynomValues(int approxDimension, ui32 docCount) {
+    const auto model = MakeModel(approxDimension, 20240705 + approxDimension);
+
+    TFastRng<ui64> prng(docCount);
+    // [docIdx][floatFeatureIdx] and [docIdx][catFeatureIdx]
+    TVector<TVector<float>> floatFeatures(docCount, TVector<float>(2));
+    TVector<TVector<int>> catFeatures(docCount, TVector<int>(1));
+    for (auto docIdx : xrange(docCount)) {
+        floatFeatures[docIdx][0] = prng.GenRandReal1() * 2 - 1;
+        floatFeatures[docIdx][1] = prng.GenRandReal1();
+        // unknown value is possible as well
+        catFeatures[docIdx][0] = prng.Uniform(4) < 3 ? OneHotValues[prng.Uniform(3)] : 100;
+    }
+    // values equal to borders go to the lower bin
+    floatFeatures[0][0] = 0.f;
+    floatFeatures[0][1] = 0.7f;
+
+    const TVector<TConstArrayRef<float>> floatFeaturesRef(floatFeatures.begin(), floatFeatures.end());
+    const TVector<TConstArrayRef<int>> catFeaturesRef(catFeatures.begin(), catFeatures.end());
+    TVector<double> expected(docCount * approxDimension);
+    model.Calc(floatFeaturesRef, catFeaturesRef, expected);
+
+    const auto importer = MakeCatBoostImporter(model);
+    const IGrid& grid = importer->GetGrid();
+    TVector<TVector<ui32>> featureBins;
+    for (auto featureIdx : xrange(grid.FeatureCount())) {
+        const int flatFeatureIdx = grid.ExternalFlatFeatureIndex(featureIdx);
+        TVector<float> values;
+        for (auto docIdx : xrange(docCount)) {
+            // one-hot feature values are compared with the hashes stored as grid borders
+            values.push_back(
+                flatFeatureIdx == 1 ? catFeatures[docIdx][0] : floatFeatures[docIdx][flatFeatureIdx / 2]);
+        }
+        featureBins.push_back(BinarizeFeature(grid, featureIdx, values));
+    }
+    const TVector<TConstArrayRef<ui32>> featureBinsRef(featureBins.begin(), featureBins.end());
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(3);
+    TPolynomBuilder builder;
+    builder.AddTrees(importer->GetModel(), &localExecutor);
+    const TPolynomEvaluator evaluator(builder.Build());
+    UNIT_ASSERT_VALUES_EQUAL(evaluator.GetDimension(), approxDimension);
+
+    TVector<double> result(docCount * approxDimension, 1.0);
+    evaluator.Calc(featureBinsRef, result, &localExecutor);
+    for (auto i : xrange(result.size())) {
+        UNIT_ASSERT_DOUBLES_EQUAL(result[i], expected[i], 1e-9);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TPolynomEvaluatorTest) {
+    Y_UNIT_TEST(TestBinarizeFeature) {
+        const auto model = MakeModel(1, 1);
+        const auto importer = MakeCatBoostImporter(model);
+        const IGrid& grid = importer->GetGrid();
+        UNIT_ASSERT_VALUES_EQUAL(grid.FeatureCount(), 3);
+        UNIT_ASSERT_EQUAL(
+            BinarizeFeature(grid, 0, {-1.f, -0.5f, -0.1f, 0.f, 0.25f, 0.3f}),
+            (TVector<ui32>{0, 0, 1, 1, 2, 3}));
+        UNIT_ASSERT_EQUAL(grid.FeatureType(2), NMonoForest::EFeatureType::OneHot);
+        TVector<float> oneHotValues;
+        for (auto borderIdx : xrange(grid.BorderCount(2))) {
+            oneHotValues.push_back(grid.Border(2, borderIdx));
+        }
+        oneHotValues.push_back(100);
+        TVector<ui32> expectedBins = xrange<ui32>(grid.BorderCount(2) + 1);
+        UNIT_ASSERT_EQUAL(BinarizeFeature(grid, 2, oneHotValues), expectedBins);
+    }
+
+    Y_UNIT_TEST(TestMatchesModel) {
+        // several blocks with a partial last one
+        CheckPolynomValues(1, 3 * TPolynomEvaluator::DOC_BLOCK_SIZE + 17);
+        CheckPolynomValues(1, 5);
+    }
+
+    Y_UNIT_TEST(TestMatchesMultiDimensionalModel) {
+        CheckPolynomValues(3, 2 * TPolynomEvaluator::DOC_BLOCK_SIZE + 1);
+    }
+}
@@ -0,0 +1,157 @@
+#include <catboost/libs/monoforest/polynom.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+
+
+using namespace NMonoForest;
+
+
+static TObliviousTree MakeTree(TVector<TBinarySplit> splits, TVector<double> values, TVector<double> weights) {
+    TObliviousTreeStructure structure;
+    structure.Splits = std::move(splits);
+    return TObliviousTree(std::move(structure), std::move(values), std::move(weights), /*dim*/ 1);
+}
+
+static TMonomStructure MakeMonomStructure(TVector<TBinarySplit> splits) {
+    TMonomStructure structure;
+    structure.Splits = std::move(splits);
+    return structure;
+}
+
+static void AssertMonom(const TPolynom& polynom, TVector<TBinarySplit> splits, double value, double weight) {
+    const auto it = polynom.MonomsEnsemble.find(MakeMonomStructure(std::move(splits)));
+    UNIT_ASSERT(it != polynom.MonomsEnsemble.end());
+    UNIT_ASSERT_VALUES_EQUAL(it->second.Value.size(), 1);
+    UNIT_ASSERT_DOUBLES_EQUAL(it->second.Value[0], value, 1e-12);
+    UNIT_ASSERT_DOUBLES_EQUAL(it->second.Weight, weight, 1e-12);
+}
+
+Y_UNIT_TEST_SUITE(TPolynomTest) {
+    const TBinarySplit SplitA(0, 0, EBinSplitType::TakeGreater);
+    const TBinarySplit SplitB(1, 2, EBinSplitType::TakeGreater);
+
+    // leaf index bit d is set if split d is satisfied
+    TObliviousTree MakeFirstTree() {
+        return MakeTree({SplitA, SplitB}, {1, 2, 3, 5}, {10, 20, 30, 40});
+    }
+
+    TObliviousTree MakeSecondTree() {
+        return MakeTree({SplitA}, {0.5, -1}, {40, 60});
+    }
+
+    Y_UNIT_TEST(TestMonomTable) {
+        const TBinarySplit splits[] = {
+            {0, 5, EBinSplitType::TakeBin},
+            {0, 5, EBinSplitType::TakeGreater},
+            {0, 6, EBinSplitType::TakeBin},
+            {1, 0, EBinSplitType::TakeGreater},
+            {Max<ui32>(), (1u << 31) - 1, EBinSplitType::TakeGreater}
+        };
+        for (auto i : xrange(std::size(splits))) {
+            UNIT_ASSERT_EQUAL(TMonomTable::DecodeSplit(TMonomTable::EncodeSplit(splits[i])), splits[i]);
+            if (i > 0) {
+                UNIT_ASSERT(TMonomTable::EncodeSplit(splits[i - 1]) < TMonomTable::EncodeSplit(splits[i]));
+            }
+        }
+
+        TMonomTable table;
+        table.SetDimension(2);
+        // enough monoms for several rehashes
+        const ui32 monomCount = 1000;
+        for (auto i : xrange(monomCount)) {
+            const ui64 codes[] = {i, i + monomCount};
+            const ui32 monomIdx = table.FindOrAdd(codes);
+            UNIT_ASSERT_VALUES_EQUAL(monomIdx, i);
+            table.GetValue(monomIdx)[1] += i;
+            table.SetWeight(monomIdx, i);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(table.Size(), monomCount);
+        for (auto i : xrange(monomCount)) {
+            const ui64 codes[] = {i, i + monomCount};
+            UNIT_ASSERT_VALUES_EQUAL(table.FindOrAdd(codes), i);
+            UNIT_ASSERT_VALUES_EQUAL(table.GetValue(i)[0], 0.0);
+            UNIT_ASSERT_VALUES_EQUAL(table.GetValue(i)[1], double(i));
+        }
+        UNIT_ASSERT_VALUES_EQUAL(table.FindOrAdd({}), monomCount);
+        UNIT_ASSERT_EXCEPTION(table.SetDimension(1), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(table.SetWeight(0, 1), TCatBoostException);
+        table.SetWeight(1, 1);
+
+        TMonomTable other;
+        other.SetDimension(2);
+        const ui64 codes[] = {1, 1 + monomCount};
+        other.GetValue(other.FindOrAdd(codes))[0] = 0.5;
+        other.SetWeight(0, 1);
+        table.Merge(other);
+        UNIT_ASSERT_VALUES_EQUAL(table.Size(), monomCount + 1);
+        UNIT_ASSERT_VALUES_EQUAL(table.GetValue(1)[0], 0.5);
+        UNIT_ASSERT_VALUES_EQUAL(table.GetValue(1)[1], 1.0);
+
+        const auto monoms = table.Export();
+        UNIT_ASSERT_VALUES_EQUAL(monoms.size(), monomCount + 1);
+        const auto& stat = monoms.at(MakeMonomStructure({TMonomTable::DecodeSplit(1), TMonomTable::DecodeSplit(1 + monomCount)}));
+        UNIT_ASSERT_EQUAL(stat.Value, (TVector<double>{0.5, 1.0}));
+        UNIT_ASSERT_VALUES_EQUAL(stat.Weight, 1.0);
+        UNIT_ASSERT_VALUES_EQUAL(monoms.at(TMonomStructure()).Weight, -1.0);
+    }
+
+    Y_UNIT_TEST(TestObliviousTrees) {
+        TPolynomBuilder builder;
+        builder.AddTree(MakeFirstTree());
+        builder.AddTree(MakeSecondTree());
+        const auto polynom = builder.Build();
+
+        // first tree: 1 + 1 * [A] + 2 * [B] + 1 * [A][B], second tree: 0.5 - 1.5 * [A]
+        UNIT_ASSERT_VALUES_EQUAL(polynom.MonomsEnsemble.size(), 4);
+        AssertMonom(polynom, {}, 1.5, 100);
+        AssertMonom(polynom, {SplitA}, -0.5, 60);
+        AssertMonom(polynom, {SplitB}, 2, 70);
+        AssertMonom(polynom, {SplitA, SplitB}, 1, 40);
+    }
+
+    Y_UNIT_TEST(TestSplitsOfSameFeature) {
+        const TBinarySplit lowBorder(0, 1, EBinSplitType::TakeGreater);
+        const TBinarySplit highBorder(0, 3, EBinSplitType::TakeGreater);
+
+        TPolynomBuilder builder;
+        // the leaf with x > 3 and x <= 1 is unreachable, its value does not matter
+        builder.AddTree(MakeTree({lowBorder, highBorder}, {1, 2, 7, 4}, {10, 20, 0, 30}));
+        const auto polynom = builder.Build();
+
+        // [x > 1][x > 3] = [x > 3], so the value of this monom is 4 - 7 - 2 + 1 + (7 - 1)
+        UNIT_ASSERT_VALUES_EQUAL(polynom.MonomsEnsemble.size(), 3);
+        AssertMonom(polynom, {}, 1, 60);
+        AssertMonom(polynom, {lowBorder}, 1, 50);
+        AssertMonom(polynom, {highBorder}, 2, 30);
+    }
+
+    Y_UNIT_TEST(TestParallelAddTrees) {
+        const int repeatCount = 15;
+        TAdditiveModel<TObliviousTree> model;
+        for (auto i : xrange(repeatCount)) {
+            Y_UNUSED(i);
+            model.AddWeakModel(MakeFirstTree());
+            model.AddWeakModel(MakeSecondTree());
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TPolynomBuilder builder;
+        builder.AddTrees(model, &localExecutor);
+        const auto polynom = builder.Build();
+
+        UNIT_ASSERT_VALUES_EQUAL(polynom.MonomsEnsemble.size(), 4);
+        AssertMonom(polynom, {}, 1.5 * repeatCount, 100);
+        AssertMonom(polynom, {SplitA}, -0.5 * repeatCount, 60);
+        AssertMonom(polynom, {SplitB}, 2 * repeatCount, 70);
+        AssertMonom(polynom, {SplitA, SplitB}, 1 * repeatCount, 40);
+
+        TPolynomBuilder sequentialBuilder;
+        for (auto treeIdx : xrange(model.Size())) {
+            sequentialBuilder.AddTree(model.GetWeakModel(treeIdx));
+        }
+        UNIT_ASSERT_EQUAL(sequentialBuilder.Build().MonomsEnsemble, polynom.MonomsEnsemble);
+    }
+}
@@ -414,6 +414,8 @@ static void Train(
     THPTimer timer;
 
     const auto onSaveSnapshotCallback = [&] (IOutputStream* out) {
+        // logs must be on disk before the snapshot they describe
+        loggingData.Logger.Sync(/*durable*/ true);
         trainingCallbacks->OnSaveSnapshot(NJson::TJsonValue{}, out);
     };
 
@@ -720,6 +722,8 @@ static void SaveModel(
             trainingDataForCpu.FeatureEstimators
         ).WithMetrics(
             ctx.LearnProgress->MetricsAndTimeHistory
+        ).WithCompactCtrTables(
+            ctx.OutputOptions.CompactCtrTables()
         );
 
         const TVector<TTargetClassifier>* targetClassifiers = &ctx.CtrsHelper.GetTargetClassifiers();
@@ -927,6 +931,8 @@ namespace {
                     initLearnProgressLearnAndTestQuantizedFeaturesCheckSum,
                     dstModel);
             }
+            // the last snapshot is written while the model is saved
+            ctx.FinishSavingProgress();
             if (dstLearnProgress) {
                 ctx.LearnProgress->PrepareForContinuation();
                 *dstLearnProgress = std::move(ctx.LearnProgress);
@@ -2,6 +2,7 @@
 #include <catboost/libs/data/data_provider_builders.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/libs/train_lib/train_model.h>
 
 #include <library/cpp/testing/unittest/registar.h>
@@ -9,6 +10,8 @@
 #include <util/folder/tempdir.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
 #include <util/random/fast.h>
 
 #include <limits>
@@ -263,4 +266,112 @@ Y_UNIT_TEST_SUITE(TrainModelTests) {
 
         UNIT_ASSERT_VALUES_UNEQUAL(predictions[0][0], predictions[1][0]);
     }
+
+    Y_UNIT_TEST(TrainWithCompactCtrTables) {
+        // Compact ctr tables must give the same predictions after the model is saved and loaded again
+
+        const ui32 objectCount = 200;
+        const ui32 catValueCount[2] = {5, 40};
+
+        TVector<float> floatFeature(objectCount);
+        TVector<TVector<TString>> catFeatures(2, TVector<TString>(objectCount));
+        TVector<float> target(objectCount);
+        TFastRng<ui64> prng(20240517);
+        for (auto objectIdx : xrange(objectCount)) {
+            floatFeature[objectIdx] = prng.GenRandReal1();
+            for (auto catFeatureIdx : xrange(2)) {
+                catFeatures[catFeatureIdx][objectIdx] = ToString(prng.Uniform(catValueCount[catFeatureIdx]));
+            }
+            target[objectIdx] = (catFeatures[0][objectIdx] < "2") + floatFeature[objectIdx] + 0.1 * prng.GenRandReal1();
+        }
+
+        TFullModel models[2];
+        for (auto compactCtrTables : {false, true}) {
+            TTempDir trainDir;
+
+            TDataProviders dataProviders;
+            dataProviders.Learn = CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.TargetType = ERawTargetType::Float;
+                    metaInfo.TargetCount = 1;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        (ui32)3,
+                        TVector<ui32>{1, 2},
+                        TVector<TString>{}
+                    );
+
+                    visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+                    visitor->AddFloatFeature(
+                        0,
+                        MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(floatFeature))
+                    );
+                    visitor->AddCatFeature(1, TConstArrayRef<TString>(catFeatures[0]));
+                    visitor->AddCatFeature(2, TConstArrayRef<TString>(catFeatures[1]));
+                    visitor->AddTarget(MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(target)));
+
+                    visitor->Finish();
+                }
+            );
+            dataProviders.Test.push_back(dataProviders.Learn);
+
+            TEvalResult evalResult;
+            NJson::TJsonValue params;
+            params.InsertValue("iterations", 10);
+            params.InsertValue("random_seed", 1);
+            params.InsertValue("train_dir", trainDir.Name());
+            params.InsertValue("one_hot_max_size", 1);
+            params.InsertValue("compact_ctr_tables", compactCtrTables);
+            TrainModel(
+                params,
+                nullptr,
+                {},
+                {},
+                Nothing(),
+                std::move(dataProviders),
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &models[compactCtrTables],
+                {&evalResult}
+            );
+        }
+
+        TTempDir modelDir;
+        const TString modelPath = modelDir.Name() + "/model.bin";
+        OutputModel(models[1], modelPath);
+        const TFullModel loadedModel = ReadModel(modelPath);
+
+        // the model part id of the ctr data is changed, so older versions refuse to load the model
+        UNIT_ASSERT(TFileInput(modelPath).ReadAll().Contains(TStaticCtrProvider::CompactCountersModelPartId()));
+        UNIT_ASSERT_VALUES_EQUAL(
+            loadedModel.CtrProvider->ModelPartIdentifier(),
+            TStaticCtrProvider::CompactCountersModelPartId()
+        );
+        UNIT_ASSERT_VALUES_EQUAL(models[0].CtrProvider->ModelPartIdentifier(), TStaticCtrProvider::ModelPartId());
+
+        const auto* ctrProvider = dynamic_cast<const TStaticCtrProvider*>(loadedModel.CtrProvider.Get());
+        UNIT_ASSERT(ctrProvider);
+        UNIT_ASSERT(!ctrProvider->CtrData.LearnCtrs.empty());
+        for (const auto& [ctrBase, table] : ctrProvider->CtrData.LearnCtrs) {
+            if (table.HasIntegerCounters()) {
+                UNIT_ASSERT((size_t)table.CounterByteSize < sizeof(int));
+            }
+        }
+
+        TVector<TConstArrayRef<float>> floatFeatures;
+        TVector<TVector<TStringBuf>> objectCatFeatures;
+        for (auto objectIdx : xrange(objectCount)) {
+            floatFeatures.push_back(TConstArrayRef<float>(&floatFeature[objectIdx], 1));
+            objectCatFeatures.push_back({catFeatures[0][objectIdx], catFeatures[1][objectIdx]});
+        }
+        TVector<double> predictions(objectCount);
+        TVector<double> compactPredictions(objectCount);
+        models[0].Calc(floatFeatures, objectCatFeatures, predictions);
+        loadedModel.Calc(floatFeatures, objectCatFeatures, compactPredictions);
+        for (auto objectIdx : xrange(objectCount)) {
+            UNIT_ASSERT_VALUES_EQUAL(predictions[objectIdx], compactPredictions[objectIdx]);
+        }
+    }
 }
@@ -36,6 +36,7 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/ymath.h>
 
 template <bool StoreExpApprox, int VectorWidth>
@@ -573,22 +574,69 @@ static void UpdateApproxDeltasHistoricallyImpl(
     double bodySumWeight,
     ELeavesEstimation estimationMethod,
     bool useExpApprox,
+    NPar::ILocalExecutor* localExecutor,
     TArrayRef<TSum> leafDers,
     TArrayRef<double> approxDeltas) {
+
+    // rows of different leaves depend on each other only through the running sum of weights
+    constexpr int MIN_ROW_COUNT_FOR_PARALLEL_UPDATE = 4096;
+    const bool isParallel = (rowCount >= MIN_ROW_COUNT_FOR_PARALLEL_UPDATE)
+        && (leafDers.size() > 1)
+        && (localExecutor->GetThreadCount() > 0);
+
     const auto impl = [=](auto EstimationMethod, auto UseExpApprox, auto UseWeights) {
-        double sumWeights = bodySumWeight;
-        for (auto rowIdx : xrange(rowStart, rowStart + rowCount)) {
+        const auto updateRow = [=](int rowIdx, double sumWeights, TSum* leafDer) {
             const double rowWeight = UseWeights ? weights[rowIdx] : 1;
-            sumWeights += rowWeight;
-            TSum& leafDer = leafDers[leafIndices[rowIdx]];
             AddMethodDer<EstimationMethod>(
-                approxDers[rowIdx - rowStart], rowWeight, /* updateWeight */ true, &leafDer);
-            double approxDelta = CalcMethodDelta<EstimationMethod>(leafDer, l2Regularizer, sumWeights, rowIdx);
+                approxDers[rowIdx - rowStart], rowWeight, /* updateWeight */ true, leafDer);
+            double approxDelta = CalcMethodDelta<EstimationMethod>(*leafDer, l2Regularizer, sumWeights, rowIdx);
             if (UseExpApprox) {
                 NCB::FastExpWithInfInplace(&approxDelta, /*count*/ 1);
             }
             approxDeltas[rowIdx] = UpdateApprox<UseExpApprox>(approxDeltas[rowIdx], approxDelta);
+        };
+
+        if (!isParallel) {
+            double sumWeights = bodySumWeight;
+            for (auto rowIdx : xrange(rowStart, rowStart + rowCount)) {
+                sumWeights += UseWeights ? weights[rowIdx] : 1;
+                updateRow(rowIdx, sumWeights, &leafDers[leafIndices[rowIdx]]);
+            }
+            return;
+        }
+
+        // running sums of weights and per-leaf derivative sums are accumulated in the same order
+        // as in the serial loop above, so the results are the same
+        TVector<double> rowSumWeights;
+        rowSumWeights.yresize(rowCount);
+        const size_t leafCount = leafDers.size();
+        TVector<int> leafOffsets(leafCount + 1, 0);
+        double sumWeights = bodySumWeight;
+        for (auto rowIdx : xrange(rowStart, rowStart + rowCount)) {
+            sumWeights += UseWeights ? weights[rowIdx] : 1;
+            rowSumWeights[rowIdx - rowStart] = sumWeights;
+            ++leafOffsets[leafIndices[rowIdx] + 1];
+        }
+        for (auto leaf : xrange(leafCount)) {
+            leafOffsets[leaf + 1] += leafOffsets[leaf];
+        }
+        TVector<int> leafRows;
+        leafRows.yresize(rowCount);
+        TVector<int> leafPositions(leafOffsets.begin(), leafOffsets.end() - 1);
+        for (auto rowIdx : xrange(rowStart, rowStart + rowCount)) {
+            leafRows[leafPositions[leafIndices[rowIdx]]++] = rowIdx;
         }
+        localExecutor->ExecRange(
+            [&](int leaf) {
+                TSum* leafDer = &leafDers[leaf];
+                for (auto position : xrange(leafOffsets[leaf], leafOffsets[leaf + 1])) {
+                    const int rowIdx = leafRows[position];
+                    updateRow(rowIdx, rowSumWeights[rowIdx - rowStart], leafDer);
+                }
+            },
+            0,
+            SafeIntegerCast<int>(leafCount),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
     };
     using TAllowedLeavesEstimation = TIntOption<
         ELeavesEstimation, ELeavesEstimation::Newton, ELeavesEstimation::Gradient>;
@@ -674,10 +722,21 @@ static void UpdateApproxDeltasHistorically(
         bt.BodySumWeight,
         estimationMethod,
         error.GetIsExpApprox(),
+        localExecutor,
         leafDers,
         *approxDeltas);
 }
 
+namespace {
+    // residuals and weights grouped by leaf, iteration scratch space for CalcExactLeafDeltas
+    struct TExactLeafSamples {
+        TVector<size_t> LeafOffsets; // [leafCount + 1]
+        TVector<size_t> LeafPositions; // [leafCount]
+        TVector<float> Samples;
+        TVector<float> Weights;
+    };
+}
+
 static void CalcExactLeafDeltas(
     const NCatboostOptions::TLossDescription& lossDescription,
     const size_t leafCount,
@@ -686,21 +745,43 @@ static void CalcExactLeafDeltas(
     TConstArrayRef<double> approxes,
     TConstArrayRef<float> targets,
     TConstArrayRef<float> weights,
+    NPar::ILocalExecutor* localExecutor,
+    TExactLeafSamples* leafSamples,
     TVector<double>* leafDeltas) {
-    TVector<TVector<float>> leafSamples(leafCount);
-    TVector<TVector<float>> leafWeights(leafCount);
 
+    // counting sort by leaf, samples keep their relative order within each leaf
+    TVector<size_t>& leafOffsets = leafSamples->LeafOffsets;
+    leafOffsets.assign(leafCount + 1, 0);
+    for (size_t i = 0; i < sampleCount; i++) {
+        Y_ASSERT(indices[i] < leafCount);
+        ++leafOffsets[indices[i] + 1];
+    }
+    for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+        leafOffsets[leaf + 1] += leafOffsets[leaf];
+    }
+    leafSamples->Samples.yresize(sampleCount);
+    leafSamples->Weights.yresize(sampleCount);
+    TVector<size_t>& leafPositions = leafSamples->LeafPositions;
+    leafPositions.assign(leafOffsets.begin(), leafOffsets.end() - 1);
     for (size_t i = 0; i < sampleCount; i++) {
-        Y_ASSERT(indices[i] < leafSamples.size());
-        leafSamples[indices[i]].emplace_back(targets[i] - approxes[i]);
-        leafWeights[indices[i]].emplace_back(weights[i]);
+        const size_t position = leafPositions[indices[i]]++;
+        leafSamples->Samples[position] = targets[i] - approxes[i];
+        leafSamples->Weights[position] = weights[i];
     }
 
     Y_ASSERT(leafCount == leafDeltas->size());
-    for (size_t i = 0; i < leafCount; i++) {
-        double& leafDelta = (*leafDeltas)[i];
-        leafDelta = *NCB::CalcOneDimensionalOptimumConstApprox(lossDescription, leafSamples[i], leafWeights[i]);
-    }
+    localExecutor->ExecRangeWithThrow(
+        [&](int leaf) {
+            const size_t leafBegin = leafOffsets[leaf];
+            const size_t leafSize = leafOffsets[leaf + 1] - leafBegin;
+            (*leafDeltas)[leaf] = *NCB::CalcOneDimensionalOptimumConstApprox(
+                lossDescription,
+                TConstArrayRef<float>(leafSamples->Samples.data() + leafBegin, leafSize),
+                TConstArrayRef<float>(leafSamples->Weights.data() + leafBegin, leafSize));
+        },
+        0,
+        SafeIntegerCast<int>(leafCount),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
 static void CalcApproxDeltaSimple(
@@ -722,6 +803,7 @@ static void CalcApproxDeltaSimple(
     TVector<TSum> leafDers(leafCount, TSum()); // iteration scratch space
     TArray2D<double> pairwiseBuckets;          // iteration scratch space
     TVector<TDers> weightedDers;               // iteration scratch space
+    TExactLeafSamples exactLeafSamples;        // iteration scratch space
     const bool treeHasMonotonicConstraints = AnyOf(
         treeMonotoneConstraints,
         [](int val) { return val != 0; });
@@ -740,6 +822,8 @@ static void CalcApproxDeltaSimple(
                 bt.Approx[0],
                 fold.LearnTarget[0],
                 MakeConstArrayRef(fold.SampleWeights),
+                ctx->LocalExecutor,
+                &exactLeafSamples,
                 &(*leafDeltas)[0]);
             return;
         }
@@ -925,6 +1009,7 @@ static void CalcLeafValuesSimple(
     TVector<TSum> leafDers(leafCount, TSum()); // iteration scratch space
     TArray2D<double> pairwiseBuckets;          // iteration scratch space
     TVector<TDers> weightedDers;               // iteration scratch space
+    TExactLeafSamples exactLeafSamples;        // iteration scratch space
     const auto leafUpdaterFunc = [&](
                                      bool recalcLeafWeights,
                                      const TVector<TVector<double>>& approxes,
@@ -939,6 +1024,8 @@ static void CalcLeafValuesSimple(
                 bt.Approx[0],
                 fold.LearnTarget[0],
                 MakeConstArrayRef(fold.SampleWeights),
+                ctx->LocalExecutor,
+                &exactLeafSamples,
                 &(*leafDeltas)[0]);
             return;
         }
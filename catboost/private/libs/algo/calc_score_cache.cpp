@@ -1,6 +1,7 @@
 #include "calc_score_cache.h"
 
 #include <catboost/libs/helpers/restorable_rng.h>
+#include <catboost/libs/logging/logging.h>
 #include <catboost/private/libs/options/oblivious_tree_options.h>
 
 #include <util/generic/algorithm.h>
@@ -9,6 +10,8 @@
 #include <util/generic/ymath.h>
 #include <util/system/guard.h>
 
+#include <cstring>
+
 
 using namespace NCB;
 
@@ -22,36 +25,56 @@ TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetStats(
     int splitStatsCount,
     bool* areStatsDirty
 ) {
+    auto& shard = GetShard(splitEnsemble);
     TVector<TBucketStats, TPoolAllocator>* splitStats;
-    with_lock(Lock) {
-        decltype(Stats)::insert_ctx statsInsertCtx;
-        auto it = Stats.find(splitEnsemble, statsInsertCtx);
-        if ((it != Stats.end()) && (it->second != nullptr)) {
+    with_lock(shard.Lock) {
+        decltype(shard.Stats)::insert_ctx statsInsertCtx;
+        auto it = shard.Stats.find(splitEnsemble, statsInsertCtx);
+        if ((it != shard.Stats.end()) && (it->second != nullptr)) {
             splitStats = it->second.Get();
             Y_ASSERT(splitStats->ysize() >= splitStatsCount);
             *areStatsDirty = false;
+            ++shard.CacheStats.HitCount;
         } else {
-            auto holder = MakeHolder<TVector<TBucketStats, TPoolAllocator>>(MemoryPool.Get());
+            auto holder = MakeHolder<TVector<TBucketStats, TPoolAllocator>>(shard.MemoryPool.Get());
             holder->yresize(MaxBodyTailCount * ApproxDimension * splitStatsCount);
-            if (it == Stats.end()) {
-                it = Stats.emplace_direct(statsInsertCtx, splitEnsemble, std::move(holder));
+            if (it == shard.Stats.end()) {
+                it = shard.Stats.emplace_direct(statsInsertCtx, splitEnsemble, std::move(holder));
             } else {
                 it->second = std::move(holder);
             }
             splitStats = it->second.Get();
             *areStatsDirty = true;
+            ++shard.CacheStats.MissCount;
         }
     }
     return *splitStats;
 }
 
 void TBucketStatsCache::GarbageCollect() {
-    if (MemoryPool->MemoryWaste() > InitialSize) { // limit memory overhead
-        Stats.clear();
-        MemoryPool->Clear();
+    size_t memoryWaste = 0;
+    for (const auto& shard : Shards) {
+        memoryWaste += shard.MemoryPool->MemoryWaste();
+    }
+    if (memoryWaste > InitialSize) { // limit memory overhead
+        const auto cacheStats = GetCacheStats();
+        CATBOOST_DEBUG_LOG << "Clear bucket stats cache: " << cacheStats.HitCount << " hits, "
+            << cacheStats.MissCount << " misses, hit rate " << cacheStats.GetHitRate() << Endl;
+        for (auto& shard : Shards) {
+            shard.Stats.clear();
+            shard.MemoryPool->Clear();
+        }
     }
 }
 
+TCacheStats TBucketStatsCache::GetCacheStats() const {
+    TCacheStats result;
+    for (const auto& shard : Shards) {
+        result += shard.CacheStats;
+    }
+    return result;
+}
+
 TVector<TBucketStats> TBucketStatsCache::GetStatsInUse(int segmentCount,
     int segmentSize,
     int statsCount,
@@ -1347,3 +1370,50 @@ void TStats3D::Add(const TStats3D& stats3D) {
         Stats[statIdx].Add(stats3D.Stats[statIdx]);
     }
 }
+
+/* Stats are sent between workers in distributed training. On deep tree levels and for sparse
+ * features most buckets are empty, so only non-empty buckets are written together with a bitmask
+ * of their positions. Values are kept as is, so reduced stats are the same as in local training.
+ */
+int TStats3D::operator&(IBinSaver& binSaver) {
+    binSaver.Add(0, &BucketCount);
+    binSaver.Add(0, &MaxLeafCount);
+    binSaver.Add(0, &SplitEnsembleSpec);
+
+    constexpr ui64 MASK_WORD_BITS = 64;
+    const TBucketStats emptyStats{0, 0, 0, 0};
+    const auto isEmpty = [&emptyStats] (const TBucketStats& stats) {
+        return memcmp(&stats, &emptyStats, sizeof(TBucketStats)) == 0;
+    };
+
+    ui64 statsCount = Stats.size();
+    binSaver.Add(0, &statsCount);
+    TVector<ui64> nonEmptyMask;
+    TVector<TBucketStats> nonEmptyStats;
+    if (!binSaver.IsReading()) {
+        nonEmptyMask.resize(CeilDiv(statsCount, MASK_WORD_BITS), 0);
+        for (auto statIdx : xrange(statsCount)) {
+            if (!isEmpty(Stats[statIdx])) {
+                nonEmptyMask[statIdx / MASK_WORD_BITS] |= ui64(1) << (statIdx % MASK_WORD_BITS);
+                nonEmptyStats.push_back(Stats[statIdx]);
+            }
+        }
+    }
+    binSaver.Add(0, &nonEmptyMask);
+    binSaver.Add(0, &nonEmptyStats);
+    if (binSaver.IsReading()) {
+        CB_ENSURE(nonEmptyMask.size() == CeilDiv(statsCount, MASK_WORD_BITS), "Corrupted bucket stats mask");
+        Stats.yresize(statsCount);
+        size_t nonEmptyIdx = 0;
+        for (auto statIdx : xrange(statsCount)) {
+            if (nonEmptyMask[statIdx / MASK_WORD_BITS] & (ui64(1) << (statIdx % MASK_WORD_BITS))) {
+                CB_ENSURE(nonEmptyIdx < nonEmptyStats.size(), "Corrupted bucket stats mask");
+                Stats[statIdx] = nonEmptyStats[nonEmptyIdx++];
+            } else {
+                Stats[statIdx] = emptyStats;
+            }
+        }
+        CB_ENSURE(nonEmptyIdx == nonEmptyStats.size(), "Corrupted bucket stats mask");
+    }
+    return 0;
+}
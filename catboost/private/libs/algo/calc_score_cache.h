@@ -1,5 +1,6 @@
 #pragma once
 
+#include <catboost/libs/helpers/cache_stats.h>
 #include <catboost/libs/helpers/dbg_output.h>
 
 #include "fold.h"
@@ -9,13 +10,18 @@
 #include <catboost/private/libs/index_range/index_range.h>
 #include <catboost/private/libs/options/restrictions.h>
 
+#include <util/digest/numeric.h>
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
 #include <util/generic/ptr.h>
 #include <util/generic/xrange.h>
 #include <util/memory/pool.h>
 #include <util/system/info.h>
+#include <util/system/guard.h>
 #include <util/system/spinlock.h>
 
+#include <array>
 #include <atomic>
 
 
@@ -122,23 +128,49 @@ inline static int CountNonCtrBuckets(
     return nonCtrBucketCount;
 }
 
+/* Stats of split ensembles from the previous tree level.
+ * Split ensembles are distributed between shards by hash, each shard has its own lock and memory pool,
+ * so parallel GetStats calls for different candidates rarely contend.
+ * Create and GarbageCollect must not be called concurrently with GetStats.
+ */
 class TBucketStatsCache {
+public:
+    static constexpr size_t SHARD_COUNT = 64;
+
 public:
     inline void Create(const TVector<TFold>& folds, int bucketCount, int depth) {
-        Stats.clear();
         ApproxDimension = folds[0].GetApproxDimension();
         MaxBodyTailCount = GetMaxBodyTailCount(folds);
         InitialSize = sizeof(TBucketStats) * bucketCount * (1ULL << depth) * ApproxDimension * MaxBodyTailCount;
         if (InitialSize == 0) {
             InitialSize = NSystemInfo::GetPageSize();
         }
-        MemoryPool = MakeHolder<TMemoryPool>(InitialSize);
+        const size_t shardInitialSize = Max<size_t>(InitialSize / SHARD_COUNT, NSystemInfo::GetPageSize());
+        for (auto& shard : Shards) {
+            shard.Stats.clear();
+            shard.MemoryPool = MakeHolder<TMemoryPool>(shardInitialSize);
+            shard.CacheStats = NCB::TCacheStats();
+        }
     }
     TVector<TBucketStats, TPoolAllocator>& GetStats(
         const TSplitEnsemble& splitEnsemble,
         int statsCount,
         bool* areStatsDirty
     );
+    void Erase(const TSplitEnsemble& splitEnsemble) {
+        auto& shard = GetShard(splitEnsemble);
+        with_lock(shard.Lock) {
+            shard.Stats.erase(splitEnsemble);
+        }
+    }
+    template <class TPredicate>
+    void EraseIf(TPredicate&& predicate) {
+        for (auto& shard : Shards) {
+            with_lock(shard.Lock) {
+                EraseNodesIf(shard.Stats, [&] (const auto& item) { return predicate(item.first); });
+            }
+        }
+    }
     void GarbageCollect();
     static TVector<TBucketStats> GetStatsInUse(
         int segmentCount,
@@ -147,12 +179,25 @@ public:
         const TVector<TBucketStats, TPoolAllocator>& cachedStats
     );
 
-public:
-    THashMap<TSplitEnsemble, THolder<TVector<TBucketStats, TPoolAllocator>>> Stats;
+    // hits and misses of GetStats since Create
+    NCB::TCacheStats GetCacheStats() const;
+
+private:
+    struct alignas(64) TShard {
+        THashMap<TSplitEnsemble, THolder<TVector<TBucketStats, TPoolAllocator>>> Stats;
+        THolder<TMemoryPool> MemoryPool;
+        TAdaptiveLock Lock;
+        NCB::TCacheStats CacheStats;
+    };
+
+private:
+    TShard& GetShard(const TSplitEnsemble& splitEnsemble) {
+        // THashMap uses low bits of the same hash to select a bucket, so mix it before selecting a shard
+        return Shards[IntHash<ui64>(splitEnsemble.GetHash()) % SHARD_COUNT];
+    }
 
 private:
-    THolder<TMemoryPool> MemoryPool;
-    TAdaptiveLock Lock;
+    std::array<TShard, SHARD_COUNT> Shards;
     size_t InitialSize = 0;
     int MaxBodyTailCount = 0;
     int ApproxDimension = 0;
@@ -423,7 +468,8 @@ struct TStats3D {
     TSplitEnsembleSpec SplitEnsembleSpec;
 
 public:
-    SAVELOAD(Stats, BucketCount, MaxLeafCount, SplitEnsembleSpec);
+    // only non-empty buckets are serialized, see the implementation
+    int operator&(IBinSaver& binSaver);
 
     void Add(const TStats3D& stats3D);
 };
@@ -502,6 +502,13 @@ namespace NCB {
         return *this;
     }
 
+    TCoreModelToFullModelConverter& TCoreModelToFullModelConverter::WithCompactCtrTables(
+        bool compactCtrTables
+    ) {
+        CompactCtrTables = compactCtrTables;
+        return *this;
+    }
+
     void TCoreModelToFullModelConverter::Do(
         bool requiresStaticCtrProvider,
         TFullModel* dstModel,
@@ -674,7 +681,8 @@ namespace NCB {
                             streamWriter->SaveOneCtr(table);
                         }
                     );
-                }
+                },
+                CompactCtrTables
             );
         }
     }
@@ -697,7 +705,12 @@ namespace NCB {
             StoreAllSimpleCtrs,
             Options.CatFeatureParams.Get().CounterCalcMethod,
             ctrBases,
-            std::move(asyncCtrValueTableCallback),
+            [this, asyncCtrValueTableCallback = std::move(asyncCtrValueTableCallback)] (TCtrValueTable&& table) {
+                if (CompactCtrTables) {
+                    table.CompactCounters();
+                }
+                asyncCtrValueTableCallback(std::move(table));
+            },
             &localExecutor
         );
     }
@@ -83,6 +83,12 @@ namespace NCB {
 
         TCoreModelToFullModelConverter& WithMetrics(const TMetricsAndTimeLeftHistory& metrics);
 
+        /* store integer counters of final ctr tables as ui8/ui16 where they fit (see TCtrValueTable::CompactCounters),
+         * predictions are the same but the model gets a new ctr model part id, so versions without compact
+         * tables support refuse to load it
+         */
+        TCoreModelToFullModelConverter& WithCompactCtrTables(bool compactCtrTables = true);
+
         void Do(
             bool requiresStaticCtrProvider,
             TFullModel* dstModel,
@@ -133,6 +139,7 @@ namespace NCB {
         const NCB::TPerfectHashedToHashedCatValuesMap* PerfectHashedToHashedCatValuesMap = nullptr;
         const TMetricsAndTimeLeftHistory* MetricsAndTimeHistory = nullptr;
         TFeatureEstimatorsPtr FeatureEstimators = nullptr;
+        bool CompactCtrTables = false;
 
         TGetBinarizedDataFunc GetBinarizedDataFunc;
         TObjectsDataProviderPtr LearnObjectsData;
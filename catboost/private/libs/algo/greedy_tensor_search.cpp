@@ -389,7 +389,7 @@ static void SelectCandidatesAndCleanupStatsFromPrevTree(
         if (addCandSubListToResult) {
             updatedCandList.push_back(std::move(candSubList));
         } else if (ctx->UseTreeLevelCaching()) {
-            statsFromPrevTree->Stats.erase(splitEnsemble);
+            statsFromPrevTree->Erase(splitEnsemble);
         }
     }
 
@@ -448,7 +448,7 @@ static void DropStatsForProjection(
                 TSplitCandidate splitCandidate;
                 splitCandidate.Type = ESplitType::OnlineCtr;
                 splitCandidate.Ctr = TCtr(proj, ctrIdx, border, prior, ctrMeta.BorderCount);
-                statsFromPrevTree->Stats.erase(TSplitEnsemble(std::move(splitCandidate)));
+                statsFromPrevTree->Erase(TSplitEnsemble(std::move(splitCandidate)));
             }
         }
     }
@@ -550,17 +550,11 @@ static void AddTreeCtrs(
         );
     }
     if (ctx->UseTreeLevelCaching()) {
-        THashSet<TSplitEnsemble> candidatesToErase;
-        for (auto& [splitEnsemble, value] : statsFromPrevTree->Stats) {
-            if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
-                if (!addedProjHash.contains(splitEnsemble.SplitCandidate.Ctr.Projection)) {
-                    candidatesToErase.insert(splitEnsemble);
-                }
-            }
-        }
-        for (const auto& splitEnsemble : candidatesToErase) {
-            statsFromPrevTree->Stats.erase(splitEnsemble);
-        }
+        statsFromPrevTree->EraseIf(
+            [&] (const TSplitEnsemble& splitEnsemble) {
+                return splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)
+                    && !addedProjHash.contains(splitEnsemble.SplitCandidate.Ctr.Projection);
+            });
     }
 }
 
@@ -360,15 +360,22 @@ void TLearnContext::SaveProgress(std::function<void(IOutputStream*)> onSaveSnaps
     if (!OutputOptions.SaveSnapshot()) {
         return;
     }
-    const auto snapshotBackup = Files.SnapshotFile + ".bak";
-    TProgressHelper(ToString(ETaskType::CPU)).Write(
-        snapshotBackup,
+    if (!SnapshotWriter) {
+        SnapshotWriter = MakeHolder<TBackgroundProgressWriter>(ToString(ETaskType::CPU));
+    }
+    SnapshotWriter->Write(
+        Files.SnapshotFile,
         [&](IOutputStream* out) {
             onSaveSnapshot(out);
             ::SaveMany(out, *LearnProgress, Profile.DumpProfileInfo());
         }
     );
-    TFsPath(snapshotBackup).ForceRenameTo(Files.SnapshotFile);
+}
+
+void TLearnContext::FinishSavingProgress() {
+    if (SnapshotWriter) {
+        SnapshotWriter->Finish();
+    }
 }
 
 bool TLearnContext::TryLoadProgress(std::function<bool(IInputStream*)> onLoadSnapshot) {
@@ -10,6 +10,7 @@
 #include <catboost/private/libs/algo_helpers/scratch_cache.h>
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/data/features_layout.h>
+#include <catboost/libs/helpers/progress_helper.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/private/libs/labels/label_converter.h>
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
@@ -215,7 +216,10 @@ public:
         NPar::ILocalExecutor* localExecutor,
         const TString& fileNamesPrefix = "");
 
+    // the snapshot file is written in background, see TBackgroundProgressWriter
     void SaveProgress(std::function<void(IOutputStream*)> onSaveSnapshot = [] (IOutputStream* /*snapshot*/) {});
+    // waits until the last snapshot file is written
+    void FinishSavingProgress();
     bool TryLoadProgress(std::function<bool(IInputStream*)> onLoadSnapshot = [] (IInputStream* /*snapshot*/) { return true; });
     bool UseTreeLevelCaching() const;
     bool GetHasWeights() const;
@@ -235,6 +239,7 @@ public:
 private:
     bool UseTreeLevelCachingFlag;
     bool HasWeights;
+    THolder<TBackgroundProgressWriter> SnapshotWriter;
 };
 
 bool NeedToUseTreeLevelCaching(
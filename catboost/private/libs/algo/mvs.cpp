@@ -78,6 +78,10 @@ double TMvsSampler::GetLambda(
     return mean * mean;
 }
 
+static double GetMedianOfThree(double a, double b, double c) {
+    return Max(Min(a, b), Min(Max(a, b), c));
+}
+
 double TMvsSampler::CalculateThreshold(
     TVector<double>::iterator candidatesBegin,
     TVector<double>::iterator candidatesEnd,
@@ -85,34 +89,40 @@ double TMvsSampler::CalculateThreshold(
     ui32 numberOfLargeCurrent,
     double sampleSize) const {
 
-    double threshold = *candidatesBegin;
-    auto middleBegin = std::partition(candidatesBegin, candidatesEnd, [threshold](double candidate) {
-        return candidate < threshold;
-    });
-    auto middleEnd = std::partition(middleBegin, candidatesEnd, [threshold](double candidate) {
-        return candidate <= threshold;
-    });
-
-    double sumOfSmallUpdate = Accumulate(candidatesBegin, middleBegin, 0.0);
-    ui32 numberOfLargeUpdate = candidatesEnd - middleEnd;
-    ui32 numberOfMiddle = middleEnd - middleBegin;
-    double sumOfMiddle = numberOfMiddle * threshold;
-
-    double estimatedSampleSize =
-        (sumOfSmallCurrent + sumOfSmallUpdate) / threshold + numberOfLargeCurrent + numberOfLargeUpdate + numberOfMiddle;
-    if (estimatedSampleSize > sampleSize) {
-        if (middleEnd != candidatesEnd) {
-            sumOfSmallCurrent += sumOfMiddle + sumOfSmallUpdate;
-            return CalculateThreshold(middleEnd, candidatesEnd, sumOfSmallCurrent, numberOfLargeCurrent, sampleSize);
-        } else {
-            return (sumOfSmallCurrent + sumOfSmallUpdate + sumOfMiddle) / (sampleSize - numberOfLargeCurrent);
-        }
-    } else {
-        if (middleBegin != candidatesBegin) {
-            numberOfLargeCurrent += numberOfLargeUpdate + numberOfMiddle;
-            return CalculateThreshold(candidatesBegin, middleBegin, sumOfSmallCurrent, numberOfLargeCurrent, sampleSize);
+    while (true) {
+        // median of three keeps the number of iterations logarithmic for sorted candidates
+        const double threshold = GetMedianOfThree(
+            *candidatesBegin,
+            *(candidatesBegin + (candidatesEnd - candidatesBegin) / 2),
+            *(candidatesEnd - 1));
+        auto middleBegin = std::partition(candidatesBegin, candidatesEnd, [threshold](double candidate) {
+            return candidate < threshold;
+        });
+        auto middleEnd = std::partition(middleBegin, candidatesEnd, [threshold](double candidate) {
+            return candidate <= threshold;
+        });
+
+        double sumOfSmallUpdate = Accumulate(candidatesBegin, middleBegin, 0.0);
+        ui32 numberOfLargeUpdate = candidatesEnd - middleEnd;
+        ui32 numberOfMiddle = middleEnd - middleBegin;
+        double sumOfMiddle = numberOfMiddle * threshold;
+
+        double estimatedSampleSize =
+            (sumOfSmallCurrent + sumOfSmallUpdate) / threshold + numberOfLargeCurrent + numberOfLargeUpdate + numberOfMiddle;
+        if (estimatedSampleSize > sampleSize) {
+            if (middleEnd != candidatesEnd) {
+                sumOfSmallCurrent += sumOfMiddle + sumOfSmallUpdate;
+                candidatesBegin = middleEnd;
+            } else {
+                return (sumOfSmallCurrent + sumOfSmallUpdate + sumOfMiddle) / (sampleSize - numberOfLargeCurrent);
+            }
         } else {
-            return sumOfSmallCurrent / (sampleSize - numberOfLargeCurrent - numberOfMiddle - numberOfLargeUpdate);
+            if (middleBegin != candidatesBegin) {
+                numberOfLargeCurrent += numberOfLargeUpdate + numberOfMiddle;
+                candidatesEnd = middleBegin;
+            } else {
+                return sumOfSmallCurrent / (sampleSize - numberOfLargeCurrent - numberOfMiddle - numberOfLargeUpdate);
+            }
         }
     }
 }
@@ -183,17 +193,19 @@ void TMvsSampler::GenSampleWeights(
                 );
                 const ui32 blockFinish = blockOffset + blockSize;
 
-                TVector<double> thresholdCandidates(blockSize, lambda);
+                // gradient norms are computed once, CalculateThreshold reorders a copy of them
+                TVector<double> gradNorms(blockSize, 0.0);
                 for (auto dim : xrange(approxDimension)) {
                     TConstArrayRef<double> derivativesRef(derivatives[dim].begin() + blockOffset, blockSize);
                     for (auto idx : xrange(blockSize)) {
                         const double der = derivativesRef[idx];
-                        thresholdCandidates[idx] += der * der;
+                        gradNorms[idx] += der * der;
                     }
                 }
-                for (auto& value : thresholdCandidates) {
-                    value = sqrt(value);
+                for (auto& value : gradNorms) {
+                    value = sqrt(value + lambda);
                 }
+                TVector<double> thresholdCandidates = gradNorms;
                 double threshold = CalculateThreshold(
                     thresholdCandidates.begin(),
                     thresholdCandidates.end(),
@@ -201,12 +213,7 @@ void TMvsSampler::GenSampleWeights(
                     0,
                     SampleRate * blockSize);
                 for (ui32 i = blockOffset; i < blockFinish; ++i) {
-                    double grad2 = 0;
-                    for (auto dim : xrange(approxDimension)) {
-                        const double der = derivatives[dim][i];
-                        grad2 += der * der;
-                    }
-                    const double probability = GetSingleProbability(sqrt(grad2 + lambda), threshold);
+                    const double probability = GetSingleProbability(gradNorms[i - blockOffset], threshold);
                     if (probability > std::numeric_limits<double>::epsilon()) {
                         const double weight = 1 / probability;
                         double r = prng.GenRandReal1();
@@ -120,6 +120,51 @@ inline static void UpdateWeightSumFromNonDiagStats(
 }
 
 
+/* Pointers to per-bucket statistics of leaf pairs (y, x), y < x, in the order they are visited by per-split
+ * updates of weight sums: [xy, yx] for (0, 1), (0, 2), ..., (1, 2), ...
+ * Sweeps over all leaf pairs for each split go through this flat table instead of TArray2D and TVector
+ * indirections.
+ */
+static void GatherNonDiagPairWeightStatistics(
+    const TArray2D<TVector<TBucketPairWeightStatistics>>& pairWeightStatistics,
+    TVector<const TBucketPairWeightStatistics*>* nonDiagStats
+) {
+    const int leafCount = pairWeightStatistics.GetYSize();
+    nonDiagStats->clear();
+    nonDiagStats->reserve(leafCount * (leafCount - 1));
+    for (int y = 0; y < leafCount; ++y) {
+        for (int x = y + 1; x < leafCount; ++x) {
+            nonDiagStats->push_back(pairWeightStatistics[x][y].data());
+            nonDiagStats->push_back(pairWeightStatistics[y][x].data());
+        }
+    }
+}
+
+
+inline static void UpdateWeightSumForSplit(
+    int leafCount,
+    int bucketIdx,
+    const TArray2D<TVector<TBucketPairWeightStatistics>>& pairWeightStatistics,
+    TConstArrayRef<const TBucketPairWeightStatistics*> nonDiagStats,
+    TArray2D<double>* weightSum
+) {
+    auto& weightSumRef = *weightSum;
+    const TBucketPairWeightStatistics* const* pairStats = nonDiagStats.data();
+    for (int y = 0; y < leafCount; ++y) {
+        const TBucketPairWeightStatistics& yy = pairWeightStatistics[y][y][bucketIdx];
+        const double weightDelta = yy.SmallerBorderWeightSum - yy.GreaterBorderRightWeightSum;
+        weightSumRef[2 * y][2 * y + 1] += weightDelta;
+        weightSumRef[2 * y + 1][2 * y] += weightDelta;
+        weightSumRef[2 * y][2 * y] -= weightDelta;
+        weightSumRef[2 * y + 1][2 * y + 1] -= weightDelta;
+
+        for (int x = y + 1; x < leafCount; ++x, pairStats += 2) {
+            UpdateWeightSumFromNonDiagStats(y, x, pairStats[0][bucketIdx], pairStats[1][bucketIdx], weightSum);
+        }
+    }
+}
+
+
 void CalculatePairwiseScore(
     const TPairwiseStats& pairwiseStats,
     int bucketCount,
@@ -135,6 +180,12 @@ void CalculatePairwiseScore(
 
     TArray2D<double> weightSum(2 * leafCount, 2 * leafCount);
 
+    // iteration scratch space
+    TVector<const TBucketPairWeightStatistics*> nonDiagStats;
+    GatherNonDiagPairWeightStatistics(pairWeightStatistics, &nonDiagStats);
+    TVector<double> systemMatrix;
+    TVector<double> leafValues;
+
     // TODO(ilyzhin): refactor this (extract common code to functions)
     switch (pairwiseStats.SplitEnsembleSpec.Type) {
         case ESplitEnsembleType::OneFeature:
@@ -206,27 +257,16 @@ void CalculatePairwiseScore(
                         const double derDelta = derSums[y][splitId];
                         derSum[2 * y] += derDelta;
                         derSum[2 * y + 1] -= derDelta;
-
-                        const double weightDelta = (pairWeightStatistics[y][y][splitId].SmallerBorderWeightSum
-                            - pairWeightStatistics[y][y][splitId].GreaterBorderRightWeightSum);
-                        weightSum[2 * y][2 * y + 1] += weightDelta;
-                        weightSum[2 * y + 1][2 * y] += weightDelta;
-                        weightSum[2 * y][2 * y] -= weightDelta;
-                        weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-
-                        for (int x = y + 1; x < leafCount; ++x) {
-                            const TBucketPairWeightStatistics& xy = pairWeightStatistics[x][y][splitId];
-                            const TBucketPairWeightStatistics& yx = pairWeightStatistics[y][x][splitId];
-
-                            UpdateWeightSumFromNonDiagStats(y, x, xy, yx, &weightSum);
-                        }
                     }
+                    UpdateWeightSumForSplit(leafCount, splitId, pairWeightStatistics, nonDiagStats, &weightSum);
 
-                    const TVector<double> leafValues = CalculatePairwiseLeafValues(
+                    CalculatePairwiseLeafValues(
                         weightSum,
                         derSum,
                         l2DiagReg,
-                        pairwiseBucketWeightPriorReg);
+                        pairwiseBucketWeightPriorReg,
+                        &systemMatrix,
+                        &leafValues);
                     scoreCalcer->CalculateScore(splitId, leafValues, derSum, weightSum);
                 }
             }
@@ -279,11 +319,13 @@ void CalculatePairwiseScore(
                         }
                     }
 
-                    const TVector<double> leafValues = CalculatePairwiseLeafValues(
+                    CalculatePairwiseLeafValues(
                         weightSum,
                         binDerSums,
                         l2DiagReg,
-                        pairwiseBucketWeightPriorReg);
+                        pairwiseBucketWeightPriorReg,
+                        &systemMatrix,
+                        &leafValues);
                     scoreCalcer->CalculateScore(binFeatureIdx, leafValues, binDerSums, weightSum);
                 }
             }
@@ -395,28 +437,16 @@ void CalculatePairwiseScore(
                                 derSum[2 * y] += derDelta;
                                 derSum[2 * y + 1] -= derDelta;
                             }
-
-                            const double weightDelta =
-                                (pairWeightStatistics[y][y][bucketId].SmallerBorderWeightSum
-                                 - pairWeightStatistics[y][y][bucketId].GreaterBorderRightWeightSum);
-                            weightSum[2 * y][2 * y + 1] += weightDelta;
-                            weightSum[2 * y + 1][2 * y] += weightDelta;
-                            weightSum[2 * y][2 * y] -= weightDelta;
-                            weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-
-                            for (int x = y + 1; x < leafCount; ++x) {
-                                const TBucketPairWeightStatistics& xy = pairWeightStatistics[x][y][bucketId];
-                                const TBucketPairWeightStatistics& yx = pairWeightStatistics[y][x][bucketId];
-
-                                UpdateWeightSumFromNonDiagStats(y, x, xy, yx, &weightSum);
-                            }
                         }
+                        UpdateWeightSumForSplit(leafCount, bucketId, pairWeightStatistics, nonDiagStats, &weightSum);
 
-                        const TVector<double> leafValues = CalculatePairwiseLeafValues(
+                        CalculatePairwiseLeafValues(
                             weightSum,
                             derSum,
                             l2DiagReg,
-                            pairwiseBucketWeightPriorReg);
+                            pairwiseBucketWeightPriorReg,
+                            &systemMatrix,
+                            &leafValues);
                         scoreCalcer->CalculateScore(
                             dstBinOffset + splitId,
                             leafValues,
@@ -495,24 +525,15 @@ void CalculatePairwiseScore(
                             const double derDelta = derSums[y][bucketId];
                             derSum[2 * y] += derDelta;
                             derSum[2 * y + 1] -= derDelta;
-                            const double weightDelta = (
-                                pairWeightStatistics[y][y][bucketId].SmallerBorderWeightSum
-                                - pairWeightStatistics[y][y][bucketId].GreaterBorderRightWeightSum);
-                            weightSum[2 * y][2 * y + 1] += weightDelta;
-                            weightSum[2 * y + 1][2 * y] += weightDelta;
-                            weightSum[2 * y][2 * y] -= weightDelta;
-                            weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-                            for (int x = y + 1; x < leafCount; ++x) {
-                                const TBucketPairWeightStatistics& xy = pairWeightStatistics[x][y][bucketId];
-                                const TBucketPairWeightStatistics& yx = pairWeightStatistics[y][x][bucketId];
-                                UpdateWeightSumFromNonDiagStats(y, x, xy, yx, &weightSum);
-                            }
                         }
-                        const TVector<double> leafValues = CalculatePairwiseLeafValues(
+                        UpdateWeightSumForSplit(leafCount, bucketId, pairWeightStatistics, nonDiagStats, &weightSum);
+                        CalculatePairwiseLeafValues(
                             weightSum,
                             derSum,
                             l2DiagReg,
-                            pairwiseBucketWeightPriorReg);
+                            pairwiseBucketWeightPriorReg,
+                            &systemMatrix,
+                            &leafValues);
                         scoreCalcer->CalculateScore(splitId, leafValues, derSum, weightSum);
                     }
                     bucketIdxOffset += part.BucketCount;
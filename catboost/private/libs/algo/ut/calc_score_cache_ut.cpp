@@ -0,0 +1,112 @@
+#include <catboost/private/libs/algo/calc_score_cache.h>
+
+#include <library/cpp/binsaver/util_stream_io.h>
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/stream/buffer.h>
+
+#include <limits>
+
+
+Y_UNIT_TEST_SUITE(TStats3DSerialization) {
+    static void CheckSaveLoad(const TStats3D& stats) {
+        TBuffer buffer;
+        {
+            TStats3D statsCopy = stats;
+            TBufferOutput out(buffer);
+            SerializeToArcadiaStream(out, statsCopy);
+        }
+        TStats3D loadedStats;
+        {
+            TBufferInput in(buffer);
+            SerializeFromStream(in, loadedStats);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(loadedStats.BucketCount, stats.BucketCount);
+        UNIT_ASSERT_VALUES_EQUAL(loadedStats.MaxLeafCount, stats.MaxLeafCount);
+        UNIT_ASSERT(loadedStats.SplitEnsembleSpec == stats.SplitEnsembleSpec);
+        UNIT_ASSERT_VALUES_EQUAL(loadedStats.Stats.size(), stats.Stats.size());
+        for (auto statIdx : xrange(stats.Stats.size())) {
+            UNIT_ASSERT_EQUAL(
+                memcmp(&loadedStats.Stats[statIdx], &stats.Stats[statIdx], sizeof(TBucketStats)),
+                0
+            );
+        }
+    }
+
+    Y_UNIT_TEST(Empty) {
+        CheckSaveLoad(TStats3D());
+    }
+
+    Y_UNIT_TEST(Sparse) {
+        TStats3D stats;
+        stats.BucketCount = 50;
+        stats.MaxLeafCount = 4;
+        stats.SplitEnsembleSpec = TSplitEnsembleSpec(ESplitEnsembleType::OneFeature, ESplitType::OnlineCtr);
+        stats.Stats.resize(2 * stats.BucketCount * stats.MaxLeafCount, TBucketStats{0, 0, 0, 0});
+        stats.Stats[0] = TBucketStats{1.5, 2.0, -0.25, 3.0};
+        stats.Stats[63] = TBucketStats{0, 0, 0, 1.0};
+        stats.Stats[64] = TBucketStats{-0.0, 0, 0, 0};
+        stats.Stats[stats.Stats.size() - 1] = TBucketStats{std::numeric_limits<double>::min(), 1e300, 0, 0};
+        CheckSaveLoad(stats);
+    }
+
+    Y_UNIT_TEST(Dense) {
+        TStats3D stats;
+        stats.BucketCount = 3;
+        stats.MaxLeafCount = 1;
+        for (auto i : xrange(3)) {
+            stats.Stats.push_back(TBucketStats{double(i), 1.0, 2.0, 3.0});
+        }
+        CheckSaveLoad(stats);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TBucketStatsCache) {
+    static TSplitEnsemble MakeFloatSplitEnsemble(int featureIdx) {
+        TSplitCandidate splitCandidate;
+        splitCandidate.Type = ESplitType::FloatFeature;
+        splitCandidate.FeatureIdx = featureIdx;
+        return TSplitEnsemble(std::move(splitCandidate));
+    }
+
+    Y_UNIT_TEST(GetStatsAndErase) {
+        TVector<TFold> folds(1);
+        folds[0].BodyTailArr.resize(2);
+        folds[0].BodyTailArr[0].Approx.resize(1);
+
+        const int bucketCount = 4;
+        const int depth = 2;
+        const int featureCount = 200;
+        const int statsCount = bucketCount * (1 << depth);
+
+        TBucketStatsCache cache;
+        cache.Create(folds, bucketCount, depth);
+
+        TVector<const TBucketStats*> statsData;
+        for (auto featureIdx : xrange(featureCount)) {
+            bool areStatsDirty = false;
+            auto& stats = cache.GetStats(MakeFloatSplitEnsemble(featureIdx), statsCount, &areStatsDirty);
+            UNIT_ASSERT(areStatsDirty);
+            UNIT_ASSERT_VALUES_EQUAL(stats.size(), 2 * statsCount);
+            statsData.push_back(stats.data());
+        }
+        for (auto featureIdx : xrange(featureCount)) {
+            bool areStatsDirty = true;
+            auto& stats = cache.GetStats(MakeFloatSplitEnsemble(featureIdx), statsCount, &areStatsDirty);
+            UNIT_ASSERT(!areStatsDirty);
+            UNIT_ASSERT_EQUAL(stats.data(), statsData[featureIdx]);
+        }
+
+        cache.Erase(MakeFloatSplitEnsemble(0));
+        cache.EraseIf([] (const TSplitEnsemble& splitEnsemble) { return splitEnsemble.SplitCandidate.FeatureIdx % 2; });
+        for (auto featureIdx : xrange(featureCount)) {
+            bool areStatsDirty = false;
+            cache.GetStats(MakeFloatSplitEnsemble(featureIdx), statsCount, &areStatsDirty);
+            UNIT_ASSERT_VALUES_EQUAL(areStatsDirty, (featureIdx == 0) || (featureIdx % 2 == 1));
+        }
+
+        const auto cacheStats = cache.GetCacheStats();
+        UNIT_ASSERT_VALUES_EQUAL(cacheStats.HitCount, featureCount + featureCount / 2 - 1);
+        UNIT_ASSERT_VALUES_EQUAL(cacheStats.MissCount, featureCount + featureCount / 2 + 1);
+    }
+}
@@ -126,4 +126,40 @@ Y_UNIT_TEST_SUITE(mvs) {
             }
         }
     }
+
+    Y_UNIT_TEST(mvs_GenWeights_sorted) {
+        // sorted derivatives are the worst case for a quickselect with a fixed pivot position
+        const ui32 SampleCount = 8192 * 4;
+        TFold ff;
+        ff.SampleWeights.resize(SampleCount, 1);
+
+        const int SampleCountAsInt = SafeIntegerCast<int>(SampleCount);
+
+        TFold::TBodyTail bt(0, 0, SampleCountAsInt, SampleCountAsInt, (double)SampleCountAsInt);
+
+        bt.WeightedDerivatives.resize(1, TVector<double>(SampleCount));
+        bt.Approx.resize(1, TVector<double>(SampleCount));
+
+        for (ui32 i = 0; i < SampleCount; ++i) {
+            bt.WeightedDerivatives[0][i] = 1.0 + i;
+        }
+
+        ff.BodyTailArr.emplace_back(std::move(bt));
+
+        const EBoostingType boostingType = Plain;
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(1);
+
+        const float sampleRate = 0.5;
+        TMvsSampler sampler(SampleCount, sampleRate, 0);
+
+        TRestorableFastRng64 rand(0);
+        sampler.GenSampleWeights(boostingType, {}, &rand, &executor, &ff);
+
+        ui32 sampledCount = 0;
+        for (ui32 i = 0; i < SampleCount; ++i) {
+            sampledCount += ff.SampleWeights[i] > 0;
+        }
+        UNIT_ASSERT_DOUBLES_EQUAL(sampledCount, sampleRate * SampleCount, 0.05 * SampleCount);
+    }
 }
@@ -3,6 +3,9 @@
 #include <catboost/private/libs/algo_helpers/pairwise_leaves_calculation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
 static double CalculateScore(const TVector<double>& avrg, const TVector<double>& sumDer, const TArray2D<double>& sumWeights) {
     double score = 0;
     for (int x = 0; x < sumDer.ysize(); ++x) {
@@ -192,4 +195,50 @@ Y_UNIT_TEST_SUITE(PairwiseScoringTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[1], scores2[1], 1e-6);
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[2], scores2[2], 1e-6);
     }
+
+    Y_UNIT_TEST(PairwiseScoringTestManyLeaves) {
+        const int leafCount = 16;
+        const int bucketCount = 32;
+        const int queryCount = 20;
+        const int querySize = 50;
+        const int docCount = queryCount * querySize;
+
+        TFastRng64 rng(0);
+        TVector<TIndexType> singleIdx(docCount);
+        TVector<double> ders(docCount);
+        for (int docId = 0; docId < docCount; ++docId) {
+            singleIdx[docId] = rng.Uniform(leafCount * bucketCount);
+            ders[docId] = rng.GenRandReal1() - 0.5;
+        }
+        TVector<TQueryInfo> queriesInfo;
+        for (int queryId = 0; queryId < queryCount; ++queryId) {
+            TQueryInfo& queryInfo = queriesInfo.emplace_back(queryId * querySize, (queryId + 1) * querySize);
+            queryInfo.Competitors.resize(querySize);
+            for (int pairIdx = 0; pairIdx < 2 * querySize; ++pairIdx) {
+                const ui32 winnerId = rng.Uniform(querySize);
+                const ui32 loserId = rng.Uniform(querySize);
+                if (winnerId != loserId) {
+                    queryInfo.Competitors[winnerId].push_back({loserId, float(rng.GenRandReal1())});
+                }
+            }
+        }
+        const ESplitType splitType = ESplitType::FloatFeature;
+        const float l2DiagReg = 0.3;
+        const float pairwiseNonDiagReg = 0.1;
+        const ui32 oneHotMaxSize = 2;
+
+        TVector<double> scores1, scores2;
+        {
+            TPairwiseStats pairwiseStats = CalcPairwiseStats(singleIdx, ders, queriesInfo, leafCount, bucketCount);
+            TPairwiseScoreCalcer scoreCalcer;
+            CalculatePairwiseScore(pairwiseStats, bucketCount, l2DiagReg, pairwiseNonDiagReg, oneHotMaxSize, &scoreCalcer);
+            scores1 = scoreCalcer.GetScores();
+        }
+        CalculatePairwiseScoreSimple(singleIdx, ders, queriesInfo, leafCount, bucketCount, splitType, l2DiagReg, pairwiseNonDiagReg, &scores2);
+
+        UNIT_ASSERT_VALUES_EQUAL(scores1.size(), scores2.size());
+        for (auto splitIdx : xrange(scores1.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(scores1[splitIdx], scores2[splitIdx], 1e-6);
+        }
+    }
 }
@@ -64,6 +64,16 @@ namespace {
     }
 
 
+    struct TPairWeight {
+        ui64 WinnerLoser; // winner index in high bits, loser index in low bits
+        float Weight;
+    };
+
+    inline ui64 MakePairKey(ui32 winner, ui32 loser) {
+        return (static_cast<ui64>(winner) << 32) | loser;
+    }
+
+
     class TYetiRankPairWeightsCalcer {
     public:
         struct TConfig {
@@ -120,29 +130,47 @@ namespace {
             , QuerySize(querySize)
         {}
 
-        void CalcWeights(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeights(const TVector<int>& permutation, TVector<TPairWeight>* pairWeights) {
             switch (Config.Mode) {
                 case EYetiRankWeightsMode::Classic:
-                    CalcWeightsClassic(permutation, competitorsWeights);
+                    CalcWeightsClassic(permutation, pairWeights);
                     return;
                 case EYetiRankWeightsMode::DCG:
-                    CalcWeightsDCG(permutation, competitorsWeights, 1.0);
+                    CalcWeightsDCG(permutation, pairWeights, 1.0);
                     return;
                 case EYetiRankWeightsMode::NDCG:
-                    CalcWeightsDCG(permutation, competitorsWeights, 1.0 / GetIDcg());
+                    CalcWeightsDCG(permutation, pairWeights, 1.0 / GetIDcg());
                     return;
                 case EYetiRankWeightsMode::MRR:
-                    CalcWeightsMRR(permutation, competitorsWeights);
+                    CalcWeightsMRR(permutation, pairWeights);
                     return;
                 case EYetiRankWeightsMode::ERR:
-                    CalcWeightsERR(permutation, competitorsWeights);
+                    CalcWeightsERR(permutation, pairWeights);
                     return;
                 case EYetiRankWeightsMode::MAP:
-                    CalcWeightsMAP(permutation, competitorsWeights);
+                    CalcWeightsMAP(permutation, pairWeights);
                     return;
             }
         }
 
+        // only this number of first positions of the permutation is used by CalcWeights
+        ui32 GetPermutationWindowSize() const {
+            if ((Config.Mode == EYetiRankWeightsMode::Classic) || (Config.NumNeighbors == -1)) {
+                return QuerySize;
+            }
+            const ui64 windowSize = ui64(Min(Config.TopSize, QuerySize)) + Max(Config.NumNeighbors, 0);
+            return Min<ui64>(windowSize, QuerySize);
+        }
+
+        // upper bound of the number of pair weights added by one CalcWeights call
+        ui64 GetMaxPairWeightsPerPermutation() const {
+            if ((Config.Mode == EYetiRankWeightsMode::Classic) || (QuerySize == 0)) {
+                return QuerySize ? QuerySize - 1 : 0;
+            }
+            const ui64 neighborCount = Config.NumNeighbors == -1 ? QuerySize : Max(Config.NumNeighbors, 0);
+            return ui64(Min(Config.TopSize, QuerySize)) * neighborCount;
+        }
+
         void AddNoise(TArrayRef<double> expApproxes, TFastRng64& rand) {
             switch (Config.NoiseType) {
                 case EYetiRankNoiseType::Gumbel:
@@ -182,15 +210,19 @@ namespace {
             return *IDcg;
         }
 
-        void AddWeight(int firstCandidate, int secondCandidate, float pairWeight, TVector<TVector<float>>* competitorsWeights) {
+        void AddWeight(int firstCandidate, int secondCandidate, float pairWeight, TVector<TPairWeight>* pairWeights) {
+            // zero weights do not change the sums
+            if (pairWeight == 0) {
+                return;
+            }
             if (Relevs[firstCandidate] > Relevs[secondCandidate]) {
-                (*competitorsWeights)[firstCandidate][secondCandidate] += pairWeight;
+                pairWeights->push_back({MakePairKey(firstCandidate, secondCandidate), pairWeight});
             } else if (Relevs[firstCandidate] < Relevs[secondCandidate]) {
-                (*competitorsWeights)[secondCandidate][firstCandidate] += pairWeight;
+                pairWeights->push_back({MakePairKey(secondCandidate, firstCandidate), pairWeight});
             }
         }
 
-        void CalcWeightsClassic(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsClassic(const TVector<int>& permutation, TVector<TPairWeight>* pairWeights) {
             double decayCoefficient = 1;
             for (ui32 docId = 1; docId < QuerySize; ++docId) {
                 const int firstCandidate = permutation[docId - 1];
@@ -199,7 +231,7 @@ namespace {
 
                 const float pairWeight = magicConst * decayCoefficient
                     * Abs(Relevs[firstCandidate] - Relevs[secondCandidate]);
-                AddWeight(firstCandidate, secondCandidate, pairWeight, competitorsWeights);
+                AddWeight(firstCandidate, secondCandidate, pairWeight, pairWeights);
                 decayCoefficient *= Config.Decay;
             }
         }
@@ -210,7 +242,7 @@ namespace {
             return position < Config.TopSize ? numerator / denominator : 0.0;
         }
 
-        void CalcWeightsDCG(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights, double coef) {
+        void CalcWeightsDCG(const TVector<int>& permutation, TVector<TPairWeight>* pairWeights, double coef) {
             const ui32 topSize = Min(Config.TopSize, QuerySize);
             for (ui32 docId = 1; docId <= topSize; ++docId) {
                 const ui32 bound = Config.NumNeighbors == -1 ? QuerySize : Min(QuerySize, docId + Config.NumNeighbors);
@@ -222,12 +254,12 @@ namespace {
                         + CalcDcgValue(Relevs[firstCandidate], docId - 1) + CalcDcgValue(Relevs[secondCandidate], neighborId - 1)
                         - CalcDcgValue(Relevs[firstCandidate], neighborId - 1) - CalcDcgValue(Relevs[secondCandidate], docId - 1)
                     );
-                    AddWeight(firstCandidate, secondCandidate, Abs(pairWeight), competitorsWeights);
+                    AddWeight(firstCandidate, secondCandidate, Abs(pairWeight), pairWeights);
                 }
             }
         }
 
-        void CalcWeightsMRR(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsMRR(const TVector<int>& permutation, TVector<TPairWeight>* pairWeights) {
             const ui32 topSize = Min(Config.TopSize, QuerySize);
             bool wasRelevant = false;
             for (ui32 docId = 1; docId <= topSize && !wasRelevant; ++docId) {
@@ -240,14 +272,14 @@ namespace {
 
                     if (isFirstRelevant ^ isSecondRelevant) {
                         const float pairWeight = 1.0 / docId - 1.0 / neighborId;
-                        AddWeight(firstCandidate, secondCandidate, pairWeight, competitorsWeights);
+                        AddWeight(firstCandidate, secondCandidate, pairWeight, pairWeights);
                     }
                 }
                 wasRelevant |= isFirstRelevant;
             }
         }
 
-        void CalcWeightsERR(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsERR(const TVector<int>& permutation, TVector<TPairWeight>* pairWeights) {
             const ui32 topSize = Min(Config.TopSize, QuerySize);
             double pFirstLook = 1.0;
             for (ui32 docId = 1; docId <= topSize; ++docId) {
@@ -264,7 +296,7 @@ namespace {
                     const double secondDelta = pMiddleLook * (Relevs[secondCandidate] - Relevs[firstCandidate]) / neighborId;
 
                     const float pairWeight = pFirstLook * (firstDelta + middleDelta + secondDelta);
-                    AddWeight(firstCandidate, secondCandidate, Abs(pairWeight), competitorsWeights);
+                    AddWeight(firstCandidate, secondCandidate, Abs(pairWeight), pairWeights);
 
                     middleRR += pMiddleLook * Relevs[secondCandidate] / neighborId;
                     pMiddleLook *= (1 - Relevs[secondCandidate]);
@@ -274,7 +306,7 @@ namespace {
             }
         }
 
-        void CalcWeightsMAP(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsMAP(const TVector<int>& permutation, TVector<TPairWeight>* pairWeights) {
             const ui32 topSize = Min(Config.TopSize, QuerySize);
             for (ui32 docId = 1; docId <= topSize; ++docId) {
                 const int firstCandidate = permutation[docId - 1];
@@ -289,7 +321,7 @@ namespace {
                     const float pairWeight = isFirstRelevant ^ isSecondRelevant
                         ? sumRR
                         : 0.0;
-                    AddWeight(firstCandidate, secondCandidate, pairWeight, competitorsWeights);
+                    AddWeight(firstCandidate, secondCandidate, pairWeight, pairWeights);
 
                     if (isSecondRelevant) {
                         sumRR += 1.0 / neighborId;
@@ -302,6 +334,39 @@ namespace {
 }
 
 
+namespace {
+    // buffers reused for all queries processed by one thread
+    struct TYetiRankPairsScratch {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<TPairWeight> PairWeights;
+    };
+}
+
+/* Sums weights of the same (winner, loser) pairs and sorts pairs by winner and loser.
+ * Weights are summed in the order of addition, so the sums do not depend on intermediate merges.
+ */
+static void MergePairWeights(TVector<TPairWeight>* pairWeights) {
+    StableSort(
+        *pairWeights,
+        [](const TPairWeight& lhs, const TPairWeight& rhs) {
+            return lhs.WinnerLoser < rhs.WinnerLoser;
+        }
+    );
+    size_t mergedCount = 0;
+    for (size_t runBegin = 0; runBegin < pairWeights->size();) {
+        const ui64 pairKey = (*pairWeights)[runBegin].WinnerLoser;
+        float sumWeight = 0;
+        size_t runEnd = runBegin;
+        for (; (runEnd < pairWeights->size()) && ((*pairWeights)[runEnd].WinnerLoser == pairKey); ++runEnd) {
+            sumWeight += (*pairWeights)[runEnd].Weight;
+        }
+        (*pairWeights)[mergedCount++] = {pairKey, sumWeight};
+        runBegin = runEnd;
+    }
+    pairWeights->resize(mergedCount);
+}
+
 static void GenerateYetiRankPairsForQuery(
     const double* expApproxes,
     float queryWeight,
@@ -309,37 +374,60 @@ static void GenerateYetiRankPairsForQuery(
     int permutationCount,
     ui64 randomSeed,
     TVector<TVector<TCompetitor>>* competitors,
-    TYetiRankPairWeightsCalcer* weightsCalcer
+    TYetiRankPairWeightsCalcer* weightsCalcer,
+    TYetiRankPairsScratch* scratch
 ) {
     TFastRng64 rand(randomSeed);
     TVector<TVector<TCompetitor>>& competitorsRef = *competitors;
-    competitorsRef.clear();
     competitorsRef.resize(querySize);
+    for (auto& winnerCompetitors : competitorsRef) {
+        winnerCompetitors.clear();
+    }
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    // weights calcer uses only a window of first positions, so a partial sort is enough;
+    // ties are broken by index, so the window is the same as the prefix of a stable sort
+    const ui32 windowSize = weightsCalcer->GetPermutationWindowSize();
+    TVector<int>& indices = scratch->Indices;
+    indices.yresize(querySize);
+    TVector<double>& bootstrappedApprox = scratch->BootstrappedApprox;
+    TVector<TPairWeight>& pairWeights = scratch->PairWeights;
+    pairWeights.clear();
+    // equal pairs are merged once the buffer holds more than querySize x querySize entries
+    const ui64 maxPairWeightsPerPermutation = weightsCalcer->GetMaxPairWeightsPerPermutation();
+    const ui64 mergeThreshold = Max<ui64>(ui64(querySize) * querySize, maxPairWeightsPerPermutation);
+    pairWeights.reserve(Min<ui64>(permutationCount * maxPairWeightsPerPermutation, mergeThreshold + maxPairWeightsPerPermutation));
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
+        bootstrappedApprox.assign(expApproxes, expApproxes + querySize);
         weightsCalcer->AddNoise(bootstrappedApprox, rand);
 
-        StableSort(
-            indices,
-            [&](int i, int j) {
-                return bootstrappedApprox[i] > bootstrappedApprox[j];
-            }
-        );
-        weightsCalcer->CalcWeights(indices, &competitorsWeights);
+        const auto isBetter = [&](int i, int j) {
+            return (bootstrappedApprox[i] > bootstrappedApprox[j])
+                || (!(bootstrappedApprox[j] > bootstrappedApprox[i]) && (i < j));
+        };
+        if (windowSize < querySize) {
+            std::partial_sort(indices.begin(), indices.begin() + windowSize, indices.end(), isBetter);
+        } else {
+            StableSort(
+                indices,
+                [&](int i, int j) {
+                    return bootstrappedApprox[i] > bootstrappedApprox[j];
+                }
+            );
+        }
+        weightsCalcer->CalcWeights(indices, &pairWeights);
+        if (pairWeights.size() > mergeThreshold) {
+            MergePairWeights(&pairWeights);
+        }
     }
 
-    // TODO(nikitxskv): Can be optimized
-    for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
-        for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight
-                = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
-            if (competitorsWeight != 0) {
-                competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
-            }
+    MergePairWeights(&pairWeights);
+    for (const auto& pairWeight : pairWeights) {
+        const float competitorsWeight = queryWeight * pairWeight.Weight / permutationCount;
+        if (competitorsWeight != 0) {
+            const ui32 winnerIndex = pairWeight.WinnerLoser >> 32;
+            const ui32 loserIndex = static_cast<ui32>(pairWeight.WinnerLoser);
+            competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
         }
     }
 }
@@ -369,6 +457,7 @@ void UpdatePairsForYetiRank(
         blockCount,
         [&](int blockId) {
             TFastRng64 rand(randomSeeds[blockId]);
+            TYetiRankPairsScratch scratch;
             const int from = queryBegin + blockId * blockSize;
             const int to = Min<int>(queryBegin + (blockId + 1) * blockSize, queryEnd);
             for (int queryIndex = from; queryIndex < to; ++queryIndex) {
@@ -385,7 +474,8 @@ void UpdatePairsForYetiRank(
                     permutationCount,
                     rand.GenRand(),
                     &queryInfoRef.Competitors,
-                    &weightsCalcer
+                    &weightsCalcer,
+                    &scratch
                 );
             }
         }
@@ -11,6 +11,26 @@ TVector<double> CalculatePairwiseLeafValues(
     const TVector<double>& derSums,
     float l2DiagReg,
     float pairwiseBucketWeightPriorReg
+) {
+    TVector<double> systemMatrix;
+    TVector<double> res;
+    CalculatePairwiseLeafValues(
+        pairwiseWeightSums,
+        derSums,
+        l2DiagReg,
+        pairwiseBucketWeightPriorReg,
+        &systemMatrix,
+        &res);
+    return res;
+}
+
+void CalculatePairwiseLeafValues(
+    const TArray2D<double>& pairwiseWeightSums,
+    TConstArrayRef<double> derSums,
+    float l2DiagReg,
+    float pairwiseBucketWeightPriorReg,
+    TVector<double>* systemMatrix,
+    TVector<double>* leafValues
 ) {
     Y_ASSERT(pairwiseWeightSums.GetXSize() > 1);
     Y_ASSERT(pairwiseWeightSums.GetXSize() == pairwiseWeightSums.GetYSize());
@@ -21,7 +41,7 @@ TVector<double> CalculatePairwiseLeafValues(
     const double nonDiagReg = -pairwiseBucketWeightPriorReg * cellPrior;
     const double diagReg = pairwiseBucketWeightPriorReg * (1 - cellPrior) + l2DiagReg;
 
-    TVector<double> res;
+    auto& res = *leafValues;
     if (systemSize == 2) {
        /* In case of 2x2 matrix we have the system of such form:
         *     / a11 -a11\ /x1\  --  / b1\
@@ -30,25 +50,25 @@ TVector<double> CalculatePairwiseLeafValues(
         * */
         res = {derSums[0] / (pairwiseWeightSums[0][0] + diagReg), 0.0};
         MakeZeroAverage(&res);
-        return res;
+        return;
     }
 
-    TVector<double> systemMatrix((systemSize - 1) * (systemSize - 1));
-    // Copy only upper triangular of the matrix as it is symmetric and another half is not referenced in potrf.
+    // Copy only upper triangular of the matrix as it is symmetric and another half is not referenced in potrf
+    // (so the other half of the reused buffer is left as is).
+    systemMatrix->yresize((systemSize - 1) * (systemSize - 1));
+    double* systemMatrixData = systemMatrix->data();
     for (int y = 0; y < systemSize - 1; ++y) {
         for (int x = 0; x < y; ++x) {
-            systemMatrix[y * (systemSize - 1) + x] = pairwiseWeightSums[y][x] + nonDiagReg;
+            systemMatrixData[y * (systemSize - 1) + x] = pairwiseWeightSums[y][x] + nonDiagReg;
         }
-        systemMatrix[y * (systemSize - 1) + y] = pairwiseWeightSums[y][y] + diagReg;
+        systemMatrixData[y * (systemSize - 1) + y] = pairwiseWeightSums[y][y] + diagReg;
     }
 
-    res = derSums;
-    res.pop_back();
-    SolveLinearSystemCholesky(&systemMatrix, &res);
+    res.assign(derSums.begin(), derSums.end() - 1);
+    SolveLinearSystemCholesky(systemMatrix, &res);
     res.push_back(0.0);
 
     MakeZeroAverage(&res);
-    return res;
 }
 
 TArray2D<double> ComputePairwiseWeightSums(
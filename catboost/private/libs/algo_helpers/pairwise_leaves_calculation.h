@@ -5,6 +5,7 @@
 
 #include <library/cpp/containers/2d_array/2d_array.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 
 namespace NPar {
@@ -19,6 +20,16 @@ TVector<double> CalculatePairwiseLeafValues(
     float pairwiseBucketWeightPriorReg
 );
 
+// Same as above but reuses the caller's buffers, for computing leaf values of many splits in a row
+void CalculatePairwiseLeafValues(
+    const TArray2D<double>& pairwiseWeightSums,
+    TConstArrayRef<double> derSums,
+    float l2DiagReg,
+    float pairwiseBucketWeightPriorReg,
+    TVector<double>* systemMatrix, // scratch space
+    TVector<double>* leafValues
+);
+
 TArray2D<double> ComputePairwiseWeightSums(
     const TVector<TQueryInfo>& queriesInfo,
     int leafCount,
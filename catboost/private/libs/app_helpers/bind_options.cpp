@@ -413,6 +413,11 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
             .Handler1T<TString>([plainJsonPtr](const TString& finalCtrComputationMode) {
                 (*plainJsonPtr)["final_ctr_computation_mode"] = finalCtrComputationMode;
             });
+    parser.AddLongOption("compact-ctr-tables", "Store ctr table counters in 1 or 2 bytes where they fit. Predictions don't change, but older versions refuse to load the model. Possible values: true, false")
+            .RequiredArgument("bool")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["compact_ctr_tables"] = FromString<bool>(param);
+            });
     parser.AddLongOption("allow-writing-files", "Allow writing files on disc. Possible values: true, false")
             .RequiredArgument("bool")
             .Handler1T<TString>([plainJsonPtr](const TString& param) {
@@ -70,6 +70,14 @@ void NCB::PrepareCalcModeParamsParser(
                 params.OutputColumnsIds.back().push_back(TString(typeName.Token()));
             }
         });
+    parser.AddLongOption("output-format")
+        .RequiredArgument("Output format, one of: " + GetEnumAllNames<EEvalOutputFormat>())
+        .DefaultValue(ToString(EEvalOutputFormat::Tsv))
+        .Handler1T<TString>([&](const TString& outputFormat) {
+            CB_ENSURE(
+                TryFromString<EEvalOutputFormat>(outputFormat, params.OutputFormat),
+                "Unknown output format " << outputFormat << ", should be one of: " << GetEnumAllNames<EEvalOutputFormat>());
+        });
     parser.AddLongOption("virtual-ensembles-count", "count of virtual ensembles for VirtEnsembles and TotalUncertainty predictions")
         .DefaultValue(10)
         .StoreResult(&virtualEnsemblesCount);
@@ -364,7 +372,8 @@ void NCB::CalcModelSingleHost(
                 IsFirstBlock,
                 docIdOffset,
                 std::make_pair(evalPeriod, iterationsLimit),
-                *params.BinClassLogitThreshold);
+                *params.BinClassLogitThreshold,
+                params.OutputFormat);
             docIdOffset += datasetPart->ObjectsGrouping->GetObjectCount();
             IsFirstBlock = false;
         },
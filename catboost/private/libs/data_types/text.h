@@ -1,6 +1,7 @@
 #pragma once
 
 #include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
 #include <util/generic/map.h>
 #include <util/generic/vector.h>
 #include <util/generic/ylimits.h>
@@ -153,6 +154,12 @@ namespace NCB {
         }
 
         TText(TVector<ui32>&& tokenIds) {
+            Assign(tokenIds);
+        }
+
+        // reuses already allocated storage, tokenIds are sorted inplace
+        void Assign(TArrayRef<ui32> tokenIds) {
+            TokenToCount.clear();
             Sort(tokenIds);
             for (const auto& tokenId : tokenIds) {
                 if (TokenToCount.empty() || TokenToCount.back().Token() != tokenId) {
@@ -17,7 +17,6 @@
 #include <util/string/cast.h>
 #include <util/string/split.h>
 
-#include <functional>
 #include <numeric>
 
 
@@ -43,39 +42,14 @@ static TUpdateMethod ParseUpdateMethod(const TString& updateMethod) {
 }
 
 static TDStrResult GetFinalDocumentImportances(
-    const TVector<TVector<double>>& rawImportances,
+    const TVector<TVector<double>>& preprocessedImportances, // [TestDocCount or 1][TrainDocCount]
     EDocumentStrengthType docImpMethod,
     int topSize,
     EImportanceValuesSign importanceValuesSign
 ) {
-    const ui32 trainDocCount = rawImportances.size();
-    Y_ASSERT(rawImportances.size() != 0);
-    const ui32 testDocCount = rawImportances[0].size();
-    TVector<TVector<double>> preprocessedImportances;
-    if (docImpMethod == EDocumentStrengthType::Average) {
-        preprocessedImportances = TVector<TVector<double>>(1, TVector<double>(trainDocCount));
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[0][trainDocId] += rawImportances[trainDocId][testDocId];
-            }
-        }
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            preprocessedImportances[0][trainDocId] /= testDocCount;
-        }
-
-    } else {
-        Y_ASSERT(docImpMethod == EDocumentStrengthType::PerObject || docImpMethod == EDocumentStrengthType::Raw);
-        preprocessedImportances = TVector<TVector<double>>(testDocCount, TVector<double>(trainDocCount));
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[testDocId][trainDocId] = rawImportances[trainDocId][testDocId];
-            }
-        }
-    }
-
     TDStrResult result(preprocessedImportances.size());
     for (ui32 testDocId = 0; testDocId < preprocessedImportances.size(); ++testDocId) {
-        TVector<double>& preprocessedImportancesRef = preprocessedImportances[testDocId];
+        const TVector<double>& preprocessedImportancesRef = preprocessedImportances[testDocId];
 
         const ui32 docCount = preprocessedImportancesRef.size();
         TVector<ui32> indices(docCount);
@@ -86,22 +60,12 @@ static TDStrResult GetFinalDocumentImportances(
             });
         }
 
-        std::function<bool(double)> predicate;
-        if (importanceValuesSign == EImportanceValuesSign::Positive) {
-            predicate = [](double v){return v > 0;};
-        } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
-            predicate = [](double v){return v < 0;};
-        } else {
-            Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
-            predicate = [](double){return true;};
-        }
-
         int currentSize = 0;
         for (ui32 i = 0; i < docCount; ++i) {
             if (currentSize == topSize) {
                 break;
             }
-            if (predicate(preprocessedImportancesRef[indices[i]])) {
+            if (HasImportanceValuesSign(preprocessedImportancesRef[indices[i]], importanceValuesSign)) {
                 result.Scores[testDocId].push_back(preprocessedImportancesRef[indices[i]]);
                 result.Indices[testDocId].push_back(indices[i]);
                 ++currentSize;
@@ -111,6 +75,19 @@ static TDStrResult GetFinalDocumentImportances(
     return result;
 }
 
+static TVector<TVector<double>> TransposeImportances(const TVector<TVector<double>>& rawImportances) {
+    const ui32 trainDocCount = rawImportances.size();
+    Y_ASSERT(rawImportances.size() != 0);
+    const ui32 testDocCount = rawImportances[0].size();
+    TVector<TVector<double>> preprocessedImportances(testDocCount, TVector<double>(trainDocCount));
+    for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
+        for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
+            preprocessedImportances[testDocId][trainDocId] = rawImportances[trainDocId][testDocId];
+        }
+    }
+    return preprocessedImportances;
+}
+
 TDStrResult GetDocumentImportances(
     const TFullModel& model,
     const NCB::TDataProvider& trainData,
@@ -166,7 +143,18 @@ TDStrResult GetDocumentImportances(
     ExecuteTasksInParallel(&tasks, localExecutor.Get());
 
     TDocumentImportancesEvaluator leafInfluenceEvaluator(model, *trainProcessedData, updateMethod, localExecutor, logPeriod);
+    if (dstrType == EDocumentStrengthType::Average) {
+        const TVector<TVector<double>> averageImportances = {
+            leafInfluenceEvaluator.GetAverageDocumentImportances(*testProcessedData, logPeriod)
+        };
+        return GetFinalDocumentImportances(averageImportances, dstrType, topSize, importanceValuesSign);
+    }
+    // Tops are kept per thread, use them only if they are much smaller than the full importances matrix.
+    const ui64 trainDocCount = trainData.ObjectsData->GetObjectCount();
+    if (dstrType == EDocumentStrengthType::PerObject && (ui64)topSize * (localExecutor->GetThreadCount() + 1) < trainDocCount) {
+        return leafInfluenceEvaluator.GetTopDocumentImportances(*testProcessedData, topSize, importanceValuesSign, logPeriod);
+    }
     const TVector<TVector<double>> documentImportances
         = leafInfluenceEvaluator.GetDocumentImportances(*testProcessedData, logPeriod);
-    return GetFinalDocumentImportances(documentImportances, dstrType, topSize, importanceValuesSign);
+    return GetFinalDocumentImportances(TransposeImportances(documentImportances), dstrType, topSize, importanceValuesSign);
 }
@@ -12,23 +12,64 @@
 #include <util/generic/utility.h>
 #include <util/generic/ymath.h>
 
+#include <limits>
 #include <numeric>
 
 
 using namespace NCB;
 
 
-TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
-    const TProcessedDataProvider& processedData, int logPeriod
+void TDocumentImportancesEvaluator::InitLeafOffsets() {
+    LeafOffsets.yresize(TreeCount + 1);
+    LeafOffsets[0] = 0;
+    for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
+        LeafOffsets[treeId + 1] = LeafOffsets[treeId] + TreesStatistics[treeId].LeafCount;
+    }
+}
+
+TDocumentImportancesEvaluator::TPoolLeaves TDocumentImportancesEvaluator::BuildPoolLeaves(
+    const TProcessedDataProvider& processedData
 ) {
-    TVector<TVector<ui32>> leafIndices(TreeCount);
+    TPoolLeaves poolLeaves;
+    const ui32 docCount = processedData.GetObjectCount();
+    poolLeaves.DocCount = docCount;
+    poolLeaves.LeafIndices.yresize((size_t)TreeCount * docCount);
+    poolLeaves.LeafDocs.yresize((size_t)TreeCount * docCount);
+    poolLeaves.LeafDocOffsets.yresize(LeafOffsets.back() + 1);
+    poolLeaves.LeafDocOffsets[0] = 0;
+
     auto binarizedFeatures = MakeQuantizedFeaturesForEvaluator(Model, *processedData.ObjectsData.Get());
     LocalExecutor->ExecRange([&] (int treeId) {
-        leafIndices[treeId] = BuildIndicesForBinTree(Model, binarizedFeatures.Get(), treeId);
+        const TVector<ui32> treeLeafIndices = BuildIndicesForBinTree(Model, binarizedFeatures.Get(), treeId);
+        ui32* leafIndices = poolLeaves.LeafIndices.data() + (size_t)treeId * docCount;
+        Copy(treeLeafIndices.begin(), treeLeafIndices.end(), leafIndices);
+
+        // Counting sort of docs by leaves, the begin of the first leaf is written by the previous tree.
+        const ui32 leafCount = TreesStatistics[treeId].LeafCount;
+        TVector<size_t> leafDocPositions(leafCount, 0);
+        for (ui32 docId = 0; docId < docCount; ++docId) {
+            ++leafDocPositions[leafIndices[docId]];
+        }
+        size_t leafDocsEnd = (size_t)treeId * docCount;
+        for (ui32 leafId = 0; leafId < leafCount; ++leafId) {
+            const size_t leafDocCount = leafDocPositions[leafId];
+            leafDocPositions[leafId] = leafDocsEnd;
+            leafDocsEnd += leafDocCount;
+            poolLeaves.LeafDocOffsets[LeafOffsets[treeId] + leafId + 1] = leafDocsEnd;
+        }
+        for (ui32 docId = 0; docId < docCount; ++docId) {
+            poolLeaves.LeafDocs[leafDocPositions[leafIndices[docId]]++] = docId;
+        }
     }, NPar::ILocalExecutor::TExecRangeParams(0, TreeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+    return poolLeaves;
+}
 
-    UpdateFinalFirstDerivatives(leafIndices, *processedData.TargetData->GetOneDimensionalTarget());
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
+void TDocumentImportancesEvaluator::ProcessTrainDocs(
+    const std::function<void(ui32 docId, int threadId, TTrainDocDerivatives* derivatives)>& processDoc,
+    const std::function<void()>& onBlockEnd,
+    int logPeriod
+) {
+    TVector<TTrainDocDerivatives> threadDerivatives(LocalExecutor->GetThreadCount() + 1);
     const size_t docBlockSize = 1000;
     TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
     TProfileInfo processDocumentsProfile(DocCount);
@@ -38,25 +79,173 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
         processDocumentsProfile.StartIterationBlock();
 
         LocalExecutor->ExecRange([&] (int docId) {
-            // The derivative of leaf values with respect to train doc weight.
-            TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
-            UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
+            const int threadId = LocalExecutor->GetWorkerThreadId();
+            processDoc(docId, threadId, &threadDerivatives[threadId]);
         }, NPar::ILocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+        if (onBlockEnd) {
+            onBlockEnd();
+        }
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
+    }
+}
+
+TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
+    const TProcessedDataProvider& processedData, int logPeriod
+) {
+    const TPoolLeaves poolLeaves = BuildPoolLeaves(processedData);
+    UpdateFinalFirstDerivatives(poolLeaves, *processedData.TargetData->GetOneDimensionalTarget());
+    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(poolLeaves.DocCount));
+    ProcessTrainDocs(
+        [&] (ui32 docId, int /*threadId*/, TTrainDocDerivatives* derivatives) {
+            UpdateLeavesDerivatives(docId, derivatives);
+            GetDocumentImportancesForOneTrainDoc(poolLeaves, derivatives, &documentImportances[docId]);
+        },
+        /*onBlockEnd*/ {},
+        logPeriod
+    );
+    return documentImportances;
+}
+
+TVector<double> TDocumentImportancesEvaluator::GetAverageDocumentImportances(
+    const TProcessedDataProvider& processedData, int logPeriod
+) {
+    const TPoolLeaves poolLeaves = BuildPoolLeaves(processedData);
+    UpdateFinalFirstDerivatives(poolLeaves, *processedData.TargetData->GetOneDimensionalTarget());
+
+    // The average importance is linear in leaf derivatives, so the pool is reduced to sums of first derivatives in leaves.
+    TVector<double> leafFirstDerivativeSums(LeafOffsets.back(), 0.0); // [LeafOffsets[treeId] + leafId]
+    for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
+        const ui32* leafIndices = poolLeaves.LeafIndices.data() + (size_t)treeId * poolLeaves.DocCount;
+        double* treeLeafFirstDerivativeSums = leafFirstDerivativeSums.data() + LeafOffsets[treeId];
+        for (ui32 docId = 0; docId < poolLeaves.DocCount; ++docId) {
+            treeLeafFirstDerivativeSums[leafIndices[docId]] += FinalFirstDerivatives[docId];
         }
+    }
+
+    TVector<double> documentImportances(DocCount);
+    ProcessTrainDocs(
+        [&] (ui32 docId, int /*threadId*/, TTrainDocDerivatives* derivatives) {
+            UpdateLeavesDerivatives(docId, derivatives);
+            double importance = 0;
+            for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
+                for (ui32 i = derivatives->UpdatedLeavesOffsets[treeId]; i < derivatives->UpdatedLeavesOffsets[treeId + 1]; ++i) {
+                    const ui32 leafOffset = LeafOffsets[treeId] + derivatives->UpdatedLeaves[i];
+                    importance += derivatives->TreeLeafDerivatives[leafOffset] * leafFirstDerivativeSums[leafOffset];
+                }
+            }
+            documentImportances[docId] = importance / poolLeaves.DocCount;
+        },
+        /*onBlockEnd*/ {},
+        logPeriod
+    );
     return documentImportances;
 }
 
-void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target) {
+TDStrResult TDocumentImportancesEvaluator::GetTopDocumentImportances(
+    const TProcessedDataProvider& processedData,
+    int topSize,
+    EImportanceValuesSign importanceValuesSign,
+    int logPeriod
+) {
+    const TPoolLeaves poolLeaves = BuildPoolLeaves(processedData);
+    UpdateFinalFirstDerivatives(poolLeaves, *processedData.TargetData->GetOneDimensionalTarget());
+    const ui32 poolDocCount = poolLeaves.DocCount;
+    const size_t topCount = Min<size_t>(topSize, DocCount);
+    TDStrResult result(poolDocCount);
+    if (topCount == 0) {
+        return result;
+    }
+
+    using TScoredDoc = std::pair<double, ui32>; // (importance, trainDocId)
+    // The same order as in the stable sort by absolute importance.
+    const auto isMoreImportant = [] (const TScoredDoc& lhs, const TScoredDoc& rhs) {
+        return Abs(lhs.first) > Abs(rhs.first) || (Abs(lhs.first) == Abs(rhs.first) && lhs.second < rhs.second);
+    };
+
+    // Every thread keeps its own tops as heaps with the least important doc on the top.
+    const int threadCount = LocalExecutor->GetThreadCount() + 1;
+    TVector<TVector<TVector<TScoredDoc>>> threadTops(threadCount, TVector<TVector<TScoredDoc>>(poolDocCount)); // [threadId][poolDocId]
+    // A train doc can't enter any top of the thread if the bound of its predicted derivatives is less than this value.
+    TVector<double> threadPruningBounds(threadCount, 0.0);
+    const double pruningBoundSlack = 1 - 1e-9;
+
+    ProcessTrainDocs(
+        [&] (ui32 docId, int threadId, TTrainDocDerivatives* derivatives) {
+            UpdateLeavesDerivatives(docId, derivatives);
+            double predictedDerivativesBound = 0;
+            for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
+                double maxLeafDerivative = 0;
+                for (ui32 i = derivatives->UpdatedLeavesOffsets[treeId]; i < derivatives->UpdatedLeavesOffsets[treeId + 1]; ++i) {
+                    const ui32 leafOffset = LeafOffsets[treeId] + derivatives->UpdatedLeaves[i];
+                    maxLeafDerivative = Max(maxLeafDerivative, Abs(derivatives->TreeLeafDerivatives[leafOffset]));
+                }
+                predictedDerivativesBound += maxLeafDerivative;
+            }
+            if (predictedDerivativesBound < threadPruningBounds[threadId] * pruningBoundSlack) {
+                return;
+            }
+
+            UpdatePredictedDerivatives(poolLeaves, derivatives);
+            auto& tops = threadTops[threadId];
+            for (ui32 poolDocId = 0; poolDocId < poolDocCount; ++poolDocId) {
+                const TScoredDoc scoredDoc(FinalFirstDerivatives[poolDocId] * derivatives->PredictedDerivatives[poolDocId], docId);
+                if (!HasImportanceValuesSign(scoredDoc.first, importanceValuesSign)) {
+                    continue;
+                }
+                auto& top = tops[poolDocId];
+                if (top.size() < topCount) {
+                    top.push_back(scoredDoc);
+                    PushHeap(top.begin(), top.end(), isMoreImportant);
+                } else if (isMoreImportant(scoredDoc, top.front())) {
+                    PopHeap(top.begin(), top.end(), isMoreImportant);
+                    top.back() = scoredDoc;
+                    PushHeap(top.begin(), top.end(), isMoreImportant);
+                }
+            }
+        },
+        [&] () {
+            LocalExecutor->ExecRange([&] (int threadId) {
+                double pruningBound = std::numeric_limits<double>::infinity();
+                for (ui32 poolDocId = 0; poolDocId < poolDocCount && pruningBound > 0; ++poolDocId) {
+                    const auto& top = threadTops[threadId][poolDocId];
+                    const double firstDerivative = Abs(FinalFirstDerivatives[poolDocId]);
+                    if (top.size() < topCount || top.front().first == 0) {
+                        pruningBound = 0;
+                    } else if (firstDerivative > 0) {
+                        pruningBound = Min(pruningBound, Abs(top.front().first) / firstDerivative);
+                    }
+                }
+                threadPruningBounds[threadId] = pruningBound;
+            }, NPar::ILocalExecutor::TExecRangeParams(0, threadCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+        },
+        logPeriod
+    );
+
+    LocalExecutor->ExecRange([&] (int poolDocId) {
+        TVector<TScoredDoc> scoredDocs;
+        for (const auto& tops : threadTops) {
+            scoredDocs.insert(scoredDocs.end(), tops[poolDocId].begin(), tops[poolDocId].end());
+        }
+        const size_t resultSize = Min(topCount, scoredDocs.size());
+        PartialSort(scoredDocs.begin(), scoredDocs.begin() + resultSize, scoredDocs.end(), isMoreImportant);
+        for (size_t i = 0; i < resultSize; ++i) {
+            result.Scores[poolDocId].push_back(scoredDocs[i].first);
+            result.Indices[poolDocId].push_back(scoredDocs[i].second);
+        }
+    }, NPar::ILocalExecutor::TExecRangeParams(0, poolDocCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+    return result;
+}
+
+void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TPoolLeaves& poolLeaves, TConstArrayRef<float> target) {
     const ui32 docCount = SafeIntegerCast<ui32>(target.size());
+    Y_ASSERT(docCount == poolLeaves.DocCount);
     TVector<double> finalApproxes(docCount);
 
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
-        const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
+        const ui32* leafIndicesRef = poolLeaves.LeafIndices.data() + (size_t)treeId * docCount;
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
             const TVector<double>& leafValues = TreesStatistics[treeId].LeafValues[it];
             for (ui32 docId = 0; docId < docCount; ++docId) {
@@ -69,42 +258,66 @@ void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TV
     EvaluateDerivatives(LossFunction, LeafEstimationMethod, finalApproxes, target, &FinalFirstDerivatives, nullptr, nullptr);
 }
 
-TVector<ui32> TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian) {
-    TVector<ui32> leafIdToUpdate;
-    const ui32 leafCount = 1 << Model.ModelTrees->GetModelTreeData()->GetTreeSizes()[treeId];
+void TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, TTrainDocDerivatives* derivatives) {
+    TVector<ui32>& leafIdToUpdate = derivatives->LeafIdToUpdate;
+    const ui32 leafCount = TreesStatistics[treeId].LeafCount;
 
     if (UpdateMethod.UpdateType == EUpdateType::AllPoints) {
-        leafIdToUpdate.resize(leafCount);
+        leafIdToUpdate.yresize(leafCount);
         std::iota(leafIdToUpdate.begin(), leafIdToUpdate.end(), 0);
     } else if (UpdateMethod.UpdateType == EUpdateType::TopKLeaves) {
+        // Jacobian is nonzero only for the updated docs.
         const TVector<ui32>& leafIndices = TreesStatistics[treeId].LeafIndices;
-        TVector<double> leafJacobians(leafCount);
-        for (ui32 docId = 0; docId < DocCount; ++docId) {
-            leafJacobians[leafIndices[docId]] += Abs(jacobian[docId]);
+        TVector<double>& leafJacobians = derivatives->LeafJacobians;
+        leafJacobians.assign(leafCount, 0.0);
+        for (ui32 docId : derivatives->JacobianDocs) {
+            leafJacobians[leafIndices[docId]] += Abs(derivatives->Jacobian[docId]);
         }
 
-        TVector<ui32> orderedLeafIndices(leafCount);
-        std::iota(orderedLeafIndices.begin(), orderedLeafIndices.end(), 0);
-        StableSort(orderedLeafIndices.begin(), orderedLeafIndices.end(), [&](ui32 firstDocId, ui32 secondDocId) {
+        leafIdToUpdate.yresize(leafCount);
+        std::iota(leafIdToUpdate.begin(), leafIdToUpdate.end(), 0);
+        StableSort(leafIdToUpdate.begin(), leafIdToUpdate.end(), [&](ui32 firstDocId, ui32 secondDocId) {
             return leafJacobians[firstDocId] > leafJacobians[secondDocId];
         });
-
-        leafIdToUpdate = TVector<ui32>(
-            orderedLeafIndices.begin(),
-            orderedLeafIndices.begin() + Min<ui32>(UpdateMethod.TopSize, leafCount)
-        );
+        leafIdToUpdate.resize(Min<ui32>(UpdateMethod.TopSize, leafCount));
+    } else {
+        leafIdToUpdate.clear();
     }
-
-    return leafIdToUpdate;
 }
 
-void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives) {
-    TVector<double> jacobian(DocCount);
+void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocDerivatives* derivatives) {
+    TVector<double>& jacobian = derivatives->Jacobian;
+    if (jacobian.empty()) {
+        jacobian.resize(DocCount, 0.0);
+        derivatives->IsJacobianDocUpdated.resize(DocCount, false);
+        derivatives->TreeLeafDerivatives.yresize(LeafOffsets.back());
+        derivatives->UpdatedLeavesOffsets.yresize(TreeCount + 1);
+    }
+    for (ui32 docId : derivatives->JacobianDocs) {
+        jacobian[docId] = 0;
+        derivatives->IsJacobianDocUpdated[docId] = false;
+    }
+    derivatives->JacobianDocs.clear();
+    const auto updateJacobian = [&] (ui32 docId, double leafDerivative) {
+        if (!derivatives->IsJacobianDocUpdated[docId]) {
+            derivatives->IsJacobianDocUpdated[docId] = true;
+            derivatives->JacobianDocs.push_back(docId);
+        }
+        jacobian[docId] += leafDerivative;
+    };
+
+    derivatives->UpdatedLeaves.clear();
+    derivatives->UpdatedLeavesOffsets[0] = 0;
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
         auto& treeStatistics = TreesStatistics[treeId];
+        const ui32 leafCount = treeStatistics.LeafCount;
+        TArrayRef<double> treeLeafDerivatives(derivatives->TreeLeafDerivatives.data() + LeafOffsets[treeId], leafCount);
+        Fill(treeLeafDerivatives.begin(), treeLeafDerivatives.end(), 0.0);
+        derivatives->LeafDerivatives.yresize(leafCount);
+        TArrayRef<double> leafDerivativesRef(derivatives->LeafDerivatives);
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<ui32> leafIdToUpdate = GetLeafIdToUpdate(treeId, jacobian);
-            TVector<double>& leafDerivativesRef = (*leafDerivatives)[treeId][it];
+            GetLeafIdToUpdate(treeId, derivatives);
+            const TVector<ui32>& leafIdToUpdate = derivatives->LeafIdToUpdate;
 
             // Updating Leaves Derivatives
             UpdateLeavesDerivativesForTree(
@@ -113,64 +326,95 @@ void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, T
                 jacobian,
                 treeId,
                 it,
-                &leafDerivativesRef
+                leafDerivativesRef
             );
 
             // Updating Jacobian
             bool isRemovedDocUpdated = false;
             for (ui32 leafId : leafIdToUpdate) {
                 for (ui32 docId : treeStatistics.LeavesDocId[leafId]) {
-                    jacobian[docId] += leafDerivativesRef[leafId];
+                    updateJacobian(docId, leafDerivativesRef[leafId]);
                 }
                 isRemovedDocUpdated |= (treeStatistics.LeafIndices[removedDocId] == leafId);
             }
             if (!isRemovedDocUpdated) {
                 ui32 removedDocLeafId = treeStatistics.LeafIndices[removedDocId];
-                jacobian[removedDocId] += leafDerivativesRef[removedDocLeafId];
+                updateJacobian(removedDocId, leafDerivativesRef[removedDocLeafId]);
+            }
+
+            for (ui32 leafId = 0; leafId < leafCount; ++leafId) {
+                treeLeafDerivatives[leafId] += leafDerivativesRef[leafId];
             }
         }
+
+        for (ui32 leafId = 0; leafId < leafCount; ++leafId) {
+            if (treeLeafDerivatives[leafId] != 0) {
+                derivatives->UpdatedLeaves.push_back(leafId);
+            }
+        }
+        derivatives->UpdatedLeavesOffsets[treeId + 1] = derivatives->UpdatedLeaves.size();
     }
 }
 
-void TDocumentImportancesEvaluator::GetDocumentImportancesForOneTrainDoc(
-    const TVector<TVector<TVector<double>>>& leafDerivatives,
-    const TVector<TVector<ui32>>& leafIndices,
-    TVector<double>* documentImportance
+void TDocumentImportancesEvaluator::UpdatePredictedDerivatives(
+    const TPoolLeaves& poolLeaves,
+    TTrainDocDerivatives* derivatives
 ) {
-    const ui32 docCount = documentImportance->size();
-    TVector<double> predictedDerivatives(docCount);
+    const ui32 docCount = poolLeaves.DocCount;
+    TVector<double>& predictedDerivatives = derivatives->PredictedDerivatives;
+    predictedDerivatives.assign(docCount, 0.0);
 
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
-        const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
-        for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
+        const double* treeLeafDerivatives = derivatives->TreeLeafDerivatives.data() + LeafOffsets[treeId];
+        const ui32 updatedLeavesBegin = derivatives->UpdatedLeavesOffsets[treeId];
+        const ui32 updatedLeavesEnd = derivatives->UpdatedLeavesOffsets[treeId + 1];
+        if (2 * (updatedLeavesEnd - updatedLeavesBegin) < TreesStatistics[treeId].LeafCount) {
+            // Only docs from the updated leaves are changed.
+            for (ui32 i = updatedLeavesBegin; i < updatedLeavesEnd; ++i) {
+                const ui32 leafId = derivatives->UpdatedLeaves[i];
+                const double leafDerivative = treeLeafDerivatives[leafId];
+                const size_t leafDocsBegin = poolLeaves.LeafDocOffsets[LeafOffsets[treeId] + leafId];
+                const size_t leafDocsEnd = poolLeaves.LeafDocOffsets[LeafOffsets[treeId] + leafId + 1];
+                for (size_t j = leafDocsBegin; j < leafDocsEnd; ++j) {
+                    predictedDerivatives[poolLeaves.LeafDocs[j]] += leafDerivative;
+                }
+            }
+        } else {
+            const ui32* leafIndicesRef = poolLeaves.LeafIndices.data() + (size_t)treeId * docCount;
             for (ui32 docId = 0; docId < docCount; ++docId) {
-                predictedDerivatives[docId] += leafDerivativesRef[leafIndicesRef[docId]];
+                predictedDerivatives[docId] += treeLeafDerivatives[leafIndicesRef[docId]];
             }
         }
     }
+}
 
-    for (ui32 docId = 0; docId < docCount; ++docId) {
+void TDocumentImportancesEvaluator::GetDocumentImportancesForOneTrainDoc(
+    const TPoolLeaves& poolLeaves,
+    TTrainDocDerivatives* derivatives,
+    TVector<double>* documentImportance
+) {
+    UpdatePredictedDerivatives(poolLeaves, derivatives);
+    const TVector<double>& predictedDerivatives = derivatives->PredictedDerivatives;
+    for (ui32 docId = 0; docId < poolLeaves.DocCount; ++docId) {
         (*documentImportance)[docId] = FinalFirstDerivatives[docId] * predictedDerivatives[docId];
     }
 }
 
 void TDocumentImportancesEvaluator::UpdateLeavesDerivativesForTree(
-    const TVector<ui32>& leafIdToUpdate,
+    TConstArrayRef<ui32> leafIdToUpdate,
     ui32 removedDocId,
-    const TVector<double>& jacobian,
+    TConstArrayRef<double> jacobian,
     ui32 treeId,
     ui32 leavesEstimationIteration,
-    TVector<double>* leafDerivatives
+    TArrayRef<double> leafDerivativesRef
 ) {
-    auto& leafDerivativesRef = *leafDerivatives;
     const auto& treeStatistics = TreesStatistics[treeId];
     const TVector<double>& formulaNumeratorMultiplier = treeStatistics.FormulaNumeratorMultiplier[leavesEstimationIteration];
     const TVector<double>& formulaNumeratorAdding = treeStatistics.FormulaNumeratorAdding[leavesEstimationIteration];
     const TVector<double>& formulaDenominators = treeStatistics.FormulaDenominators[leavesEstimationIteration];
     const ui32 removedDocLeafId = treeStatistics.LeafIndices[removedDocId];
 
-    leafDerivativesRef.resize(treeStatistics.LeafCount);
+    Y_ASSERT(leafDerivativesRef.size() == treeStatistics.LeafCount);
     Fill(leafDerivativesRef.begin(), leafDerivativesRef.end(), 0);
     bool isRemovedDocUpdated = false;
     for (ui32 leafId : leafIdToUpdate) {
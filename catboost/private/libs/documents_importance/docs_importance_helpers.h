@@ -1,5 +1,6 @@
 #pragma once
 
+#include "docs_importance.h"
 #include "enums.h"
 #include "tree_statistics.h"
 
@@ -12,12 +13,15 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/system/compiler.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
+#include <functional>
+
 
 /*
  * This is the implementation of the LeafInfluence algorithm from the following paper:
@@ -39,6 +43,18 @@ struct TUpdateMethod {
     int TopSize;
 };
 
+inline bool HasImportanceValuesSign(double value, EImportanceValuesSign importanceValuesSign) {
+    switch (importanceValuesSign) {
+        case EImportanceValuesSign::Positive:
+            return value > 0;
+        case EImportanceValuesSign::Negative:
+            return value < 0;
+        default:
+            Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
+            return true;
+    }
+}
+
 // The class for document importances evaluation.
 class TDocumentImportancesEvaluator {
 public:
@@ -78,37 +94,82 @@ public:
             treeStatisticsEvaluator = MakeHolder<TNewtonTreeStatisticsEvaluator>(DocCount);
         }
         TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, startingApprox, logPeriod);
+        InitLeafOffsets();
     }
 
     // Getting the importance of all train objects for all objects from pool.
     TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
+    // Getting the importance of all train objects averaged over objects from pool.
+    TVector<double> GetAverageDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
+    // Getting topSize most important train objects (by absolute value) for every object from pool.
+    // Train objects whose importance bound is below the current top are not scored at all.
+    TDStrResult GetTopDocumentImportances(
+        const NCB::TProcessedDataProvider& processedData,
+        int topSize,
+        EImportanceValuesSign importanceValuesSign,
+        int logPeriod = 0
+    );
 
 private:
+    // Leaf indices of objects from pool, objects of every leaf are also stored contiguously.
+    struct TPoolLeaves {
+        ui32 DocCount = 0;
+        TVector<ui32> LeafIndices; // [treeId * DocCount + docId]
+        TVector<size_t> LeafDocOffsets; // [LeafOffsets[treeId] + leafId + 1] // end of leaf docs in LeafDocs.
+        TVector<ui32> LeafDocs; // [treeCount * DocCount]
+    };
+
+    // Per-thread buffers reused for all train objects.
+    struct TTrainDocDerivatives {
+        TVector<double> TreeLeafDerivatives; // [LeafOffsets[treeId] + leafId] // Summed over leaves estimation iterations.
+        TVector<ui32> UpdatedLeaves; // Leaves with nonzero derivatives of tree are [UpdatedLeavesOffsets[treeId], UpdatedLeavesOffsets[treeId + 1]).
+        TVector<ui32> UpdatedLeavesOffsets; // [treeCount + 1]
+        TVector<double> LeafDerivatives; // [leafCount] // For the current tree and leaves estimation iteration.
+        TVector<double> Jacobian; // [docCount]
+        TVector<ui32> JacobianDocs; // Docs with updated jacobian.
+        TVector<bool> IsJacobianDocUpdated; // [docCount]
+        TVector<ui32> LeafIdToUpdate;
+        TVector<double> LeafJacobians; // [leafCount]
+        TVector<double> PredictedDerivatives; // [pool docCount]
+    };
+
+private:
+    void InitLeafOffsets();
+    TPoolLeaves BuildPoolLeaves(const NCB::TProcessedDataProvider& processedData);
+    // Runs processDoc for every train object in parallel, onBlockEnd is called between blocks of train objects.
+    void ProcessTrainDocs(
+        const std::function<void(ui32 docId, int threadId, TTrainDocDerivatives* derivatives)>& processDoc,
+        const std::function<void()>& onBlockEnd,
+        int logPeriod
+    );
     // Evaluate first derivatives at the final approxes
-    void UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target);
+    void UpdateFinalFirstDerivatives(const TPoolLeaves& poolLeaves, TConstArrayRef<float> target);
     // Leaves derivatives will be updated based on objects from these leaves.
-    TVector<ui32> GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian);
+    void GetLeafIdToUpdate(ui32 treeId, TTrainDocDerivatives* derivatives);
     // Algorithm 4 from paper.
-    void UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives);
+    void UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocDerivatives* derivatives);
+    // Derivatives of predictions for objects from pool with respect to the train object weight.
+    void UpdatePredictedDerivatives(const TPoolLeaves& poolLeaves, TTrainDocDerivatives* derivatives);
     // Getting the importance of one train object for all objects from pool.
     void GetDocumentImportancesForOneTrainDoc(
-        const TVector<TVector<TVector<double>>>& leafDerivatives,
-        const TVector<TVector<ui32>>& leafIndices,
+        const TPoolLeaves& poolLeaves,
+        TTrainDocDerivatives* derivatives,
         TVector<double>* documentImportance
     );
     // Evaluate leaf derivatives at a given removedDocId weight (Equation (6) from paper).
     void UpdateLeavesDerivativesForTree(
-        const TVector<ui32>& leafIdToUpdate,
+        TConstArrayRef<ui32> leafIdToUpdate,
         ui32 removedDocId,
-        const TVector<double>& jacobian,
+        TConstArrayRef<double> jacobian,
         ui32 treeId,
         ui32 leavesEstimationIteration,
-        TVector<double>* leafDerivatives
+        TArrayRef<double> leafDerivatives
     );
 
 private:
     const TFullModel& Model;
     TVector<TTreeStatistics> TreesStatistics; // [treeCount]
+    TVector<ui32> LeafOffsets; // [treeCount + 1]
     TVector<double> FinalFirstDerivatives; // [docCount]
     TUpdateMethod UpdateMethod;
     ELossFunction LossFunction;
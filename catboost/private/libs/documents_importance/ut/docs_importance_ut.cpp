@@ -0,0 +1,248 @@
+#include <catboost/private/libs/documents_importance/docs_importance.h>
+#include <catboost/private/libs/documents_importance/docs_importance_helpers.h>
+#include <catboost/private/libs/documents_importance/enums.h>
+
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+#include <numeric>
+
+
+using namespace NCB;
+
+
+static TDataProviderPtr CreateRandomPool(ui32 objectCount, bool binaryTarget, ui64 seed) {
+    const ui32 featureCount = 3;
+    TFastRng<ui64> prng(seed);
+    TVector<TVector<float>> features(featureCount, TVector<float>(objectCount));
+    TVector<float> target(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        for (auto& feature : features) {
+            feature[objectIdx] = prng.GenRandReal1();
+        }
+        const double value = features[0][objectIdx] - features[1][objectIdx] + 0.3 * prng.GenRandReal1();
+        target[objectIdx] = binaryTarget ? (value > 0.15) : value;
+    }
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.TargetType = ERawTargetType::Float;
+            metaInfo.TargetCount = 1;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                featureCount,
+                TVector<ui32>{},
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto featureIdx : xrange(featureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(std::move(features[featureIdx]))
+                );
+            }
+            visitor->AddTarget(MakeIntrusive<TTypeCastArrayHolder<float, float>>(std::move(target)));
+
+            visitor->Finish();
+        }
+    );
+}
+
+static TFullModel TrainSmallModel(TDataProviderPtr learn, const TString& lossFunction) {
+    TTempDir trainDir;
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = learn;
+    dataProviders.Test.push_back(learn);
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 10);
+    params.InsertValue("depth", 3);
+    params.InsertValue("loss_function", lossFunction);
+    params.InsertValue("boosting_type", "Plain");
+    params.InsertValue("leaf_estimation_iterations", 2);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", trainDir.Name());
+    TrainModel(
+        params,
+        nullptr,
+        {},
+        {},
+        Nothing(),
+        std::move(dataProviders),
+        /*initModel*/ Nothing(),
+        /*initLearnProgress*/ nullptr,
+        "",
+        &model,
+        {&evalResult}
+    );
+    return model;
+}
+
+namespace {
+    struct TDocumentImportancesTestData {
+        TDataProviderPtr Train;
+        TDataProviderPtr Test;
+        TFullModel Model;
+    };
+}
+
+static TDocumentImportancesTestData CreateTestData(const TString& lossFunction) {
+    const bool binaryTarget = lossFunction == "Logloss";
+    TDocumentImportancesTestData data;
+    data.Train = CreateRandomPool(/*objectCount*/ 150, binaryTarget, /*seed*/ 20240611);
+    data.Test = CreateRandomPool(/*objectCount*/ 17, binaryTarget, /*seed*/ 20240612);
+    data.Model = TrainSmallModel(data.Train, lossFunction);
+    return data;
+}
+
+// [testDocId][trainDocId], not sorted
+static TVector<TVector<double>> GetRawImportances(
+    const TDocumentImportancesTestData& data,
+    const TString& updateMethod,
+    int threadCount
+) {
+    const TDStrResult raw = GetDocumentImportances(
+        data.Model,
+        *data.Train,
+        *data.Test,
+        "Raw",
+        /*topSize*/ -1,
+        updateMethod,
+        "All",
+        threadCount
+    );
+    const ui32 trainDocCount = data.Train->GetObjectCount();
+    UNIT_ASSERT_VALUES_EQUAL(raw.Scores.size(), data.Test->GetObjectCount());
+    for (auto testDocId : xrange(raw.Scores.size())) {
+        UNIT_ASSERT_VALUES_EQUAL(raw.Scores[testDocId].size(), trainDocCount);
+        for (auto trainDocId : xrange(trainDocCount)) {
+            UNIT_ASSERT_VALUES_EQUAL(raw.Indices[testDocId][trainDocId], trainDocId);
+        }
+    }
+    return raw.Scores;
+}
+
+static void CheckTopImportances(
+    const TDocumentImportancesTestData& data,
+    const TString& updateMethod,
+    const TString& importanceValuesSign
+) {
+    const int threadCount = 4;
+    const int topSize = 5;
+    // tops are kept per thread only if they are much smaller than the train pool
+    UNIT_ASSERT(topSize * threadCount < (int)data.Train->GetObjectCount());
+
+    const auto rawImportances = GetRawImportances(data, updateMethod, threadCount);
+    const TDStrResult top = GetDocumentImportances(
+        data.Model,
+        *data.Train,
+        *data.Test,
+        "PerObject",
+        topSize,
+        updateMethod,
+        importanceValuesSign,
+        threadCount
+    );
+    const auto sign = FromString<EImportanceValuesSign>(importanceValuesSign);
+
+    UNIT_ASSERT_VALUES_EQUAL(top.Indices.size(), rawImportances.size());
+    for (auto testDocId : xrange(rawImportances.size())) {
+        const auto& importances = rawImportances[testDocId];
+        TVector<ui32> expectedIndices;
+        for (auto trainDocId : xrange<ui32>(importances.size())) {
+            if (HasImportanceValuesSign(importances[trainDocId], sign)) {
+                expectedIndices.push_back(trainDocId);
+            }
+        }
+        StableSort(expectedIndices, [&] (ui32 lhs, ui32 rhs) {
+            return Abs(importances[lhs]) > Abs(importances[rhs]);
+        });
+        expectedIndices.resize(Min<size_t>(expectedIndices.size(), topSize));
+
+        UNIT_ASSERT_VALUES_EQUAL(top.Indices[testDocId].size(), expectedIndices.size());
+        UNIT_ASSERT_VALUES_EQUAL(top.Scores[testDocId].size(), expectedIndices.size());
+        for (auto i : xrange(expectedIndices.size())) {
+            const double expectedScore = importances[expectedIndices[i]];
+            UNIT_ASSERT_DOUBLES_EQUAL(top.Scores[testDocId][i], expectedScore, 1e-12 * (1 + Abs(expectedScore)));
+            // indices of importances equal up to rounding may go in any order
+            if (top.Indices[testDocId][i] != expectedIndices[i]) {
+                UNIT_ASSERT_DOUBLES_EQUAL(
+                    importances[top.Indices[testDocId][i]],
+                    expectedScore,
+                    1e-12 * (1 + Abs(expectedScore))
+                );
+            }
+        }
+    }
+}
+
+static void CheckAverageImportances(const TDocumentImportancesTestData& data, const TString& updateMethod) {
+    const int threadCount = 4;
+    const auto rawImportances = GetRawImportances(data, updateMethod, threadCount);
+    const ui32 trainDocCount = data.Train->GetObjectCount();
+    TVector<double> expectedImportances(trainDocCount, 0.0);
+    for (const auto& importances : rawImportances) {
+        for (auto trainDocId : xrange(trainDocCount)) {
+            expectedImportances[trainDocId] += importances[trainDocId] / rawImportances.size();
+        }
+    }
+
+    const TDStrResult average = GetDocumentImportances(
+        data.Model,
+        *data.Train,
+        *data.Test,
+        "Average",
+        /*topSize*/ -1,
+        updateMethod,
+        "All",
+        threadCount
+    );
+    UNIT_ASSERT_VALUES_EQUAL(average.Indices.size(), 1);
+    UNIT_ASSERT_VALUES_EQUAL(average.Indices[0].size(), trainDocCount);
+    double maxImportance = 0;
+    for (auto importance : expectedImportances) {
+        maxImportance = Max(maxImportance, Abs(importance));
+    }
+    UNIT_ASSERT(maxImportance > 0);
+    for (auto i : xrange(trainDocCount)) {
+        const ui32 trainDocId = average.Indices[0][i];
+        UNIT_ASSERT_DOUBLES_EQUAL(average.Scores[0][i], expectedImportances[trainDocId], 1e-12 * maxImportance);
+        if (i > 0) {
+            UNIT_ASSERT(Abs(average.Scores[0][i - 1]) >= Abs(average.Scores[0][i]));
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TDocumentImportancesTest) {
+    Y_UNIT_TEST(TopImportancesMatchFullComputation) {
+        for (const TString lossFunction : {"RMSE", "Logloss"}) {
+            const auto data = CreateTestData(lossFunction);
+            for (const TString updateMethod : {"SinglePoint", "TopKLeaves:top=2", "AllPoints"}) {
+                for (const TString sign : {"All", "Positive", "Negative"}) {
+                    CheckTopImportances(data, updateMethod, sign);
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(AverageImportancesMatchFullComputation) {
+        for (const TString lossFunction : {"RMSE", "Logloss"}) {
+            const auto data = CreateTestData(lossFunction);
+            for (const TString updateMethod : {"SinglePoint", "TopKLeaves:top=2", "AllPoints"}) {
+                CheckAverageImportances(data, updateMethod);
+            }
+        }
+    }
+}
@@ -1,5 +1,7 @@
 #include "embedding_feature_calcer.h"
 
+#include <util/generic/xrange.h>
+
 namespace NCB {
     void TEmbeddingFeatureCalcer::TrimFeatures(TConstArrayRef<ui32> featureIndices) {
         const ui32 featureCount = FeatureCount();
@@ -10,6 +12,13 @@ namespace NCB {
         ActiveFeatureIndices = TVector<ui32>(featureIndices.begin(), featureIndices.end());
     }
 
+    void TEmbeddingFeatureCalcer::ComputeBlock(TConstArrayRef<TEmbeddingsArray> embeddings, TArrayRef<float> result) const {
+        const ui64 docCount = embeddings.size();
+        for (ui32 docId: xrange(docCount)) {
+            Compute(embeddings[docId], TOutputFloatIterator(result.data() + docId, docCount, result.size()));
+        }
+    }
+
     TConstArrayRef<ui32> TEmbeddingFeatureCalcer::GetActiveFeatureIndices() const {
         return MakeConstArrayRef(ActiveFeatureIndices);
     }
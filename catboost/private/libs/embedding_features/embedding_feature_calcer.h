@@ -19,6 +19,12 @@ namespace NCB {
 
         virtual void Compute(const TEmbeddingsArray& vector, TOutputFloatIterator outputFeaturesIterator) const = 0;
 
+        /* Computes features for a block of documents,
+         * result layout is the same as in Compute with step = embeddings.size():
+         * result[featureIdx * embeddings.size() + docIdx]
+         */
+        virtual void ComputeBlock(TConstArrayRef<TEmbeddingsArray> embeddings, TArrayRef<float> result) const;
+
         void Save(IOutputStream* stream) const final;
         void Load(IInputStream* stream) final;
 
@@ -34,6 +40,8 @@ namespace NCB {
         TConstArrayRef<ui32> GetActiveFeatureIndices() const;
 
     protected:
+        static constexpr ui32 APPLY_BLOCK_SIZE = 128;
+
         class TEmbeddingCalcerFbs {
         public:
             using TCalcerFbsImpl = flatbuffers::Offset<void>;
@@ -185,12 +185,7 @@ namespace NCB {
                 result.data() + calcerOffset,
                 result.data() + calcerOffset + calculatedFeaturesSize
             );
-            for (ui32 docId: xrange(docCount)) {
-                calcer->Compute(
-                    embeddingFeature[docId],
-                    TOutputFloatIterator(currentResult.data() + docId, docCount, currentResult.size())
-                );
-            }
+            calcer->ComputeBlock(embeddingFeature, currentResult);
         }
     }
 
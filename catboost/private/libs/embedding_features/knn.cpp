@@ -2,11 +2,29 @@
 
 #include <catboost/private/libs/embedding_features/flatbuffers/embedding_feature_calcers.fbs.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
 #include <util/stream/length.h>
 #include <util/system/yassert.h>
 
 namespace NCB {
 
+    void IKNNCloud::GetNearestNeighborsForBlock(
+        TConstArrayRef<TEmbeddingsArray> embeds,
+        ui32 knum,
+        TArrayRef<ui32> neighbors,
+        TArrayRef<ui32> neighborCounts
+    ) const {
+        Y_ASSERT(neighbors.size() >= embeds.size() * knum);
+        Y_ASSERT(neighborCounts.size() >= embeds.size());
+        for (size_t queryIdx : xrange(embeds.size())) {
+            const auto queryNeighbors = GetNearestNeighbors(embeds[queryIdx].data(), knum);
+            Y_ASSERT(queryNeighbors.size() <= knum);
+            Copy(queryNeighbors.begin(), queryNeighbors.end(), neighbors.begin() + queryIdx * knum);
+            neighborCounts[queryIdx] = queryNeighbors.size();
+        }
+    }
+
     TVector<ui32> TKNNUpdatableCloud::GetNearestNeighbors(const float* embed, ui32 knum) const  {
         TVector<ui32> result;
         auto neighbors = Cloud.GetNearestNeighbors(embed, knum);
@@ -17,32 +35,93 @@ namespace NCB {
     }
 
     TVector<ui32> TKNNCloud::GetNearestNeighbors(const float* embed, ui32 knum) const  {
-        TVector<ui32> result;
+        const size_t pointCount = Points.GetNumItems();
+        if (pointCount <= SEARCH_NEIGHBORHOOD_SIZE) {
+            TVector<std::pair<float, ui32>> distances;
+            TVector<ui32> result;
+            result.yresize(Min<size_t>(knum, pointCount));
+            GetExactNearestNeighbors(embed, &distances, result);
+            return result;
+        }
         auto neighbors = Cloud.GetNearestNeighbors<NOnlineHnsw::TDenseVectorExtendableItemStorage<float>,
                                                    TL2Distance>(embed,
-                                                   knum, 300, Points, Dist);
+                                                   knum, SEARCH_NEIGHBORHOOD_SIZE, Points, Dist);
+        // the same order of equidistant neighbors as in the exact search
+        SortBy(neighbors, [] (const auto& neighbor) {
+            return std::make_pair(neighbor.Dist, neighbor.Id);
+        });
+        TVector<ui32> result;
         for (size_t pos = 0; pos < neighbors.size(); ++pos) {
             result.push_back(neighbors[pos].Id);
         }
         return result;
     }
 
-    void TKNNCalcer::Compute(const TEmbeddingsArray& embed,
-                             TOutputFloatIterator iterator) const {
-        TVector<float> result(FeatureCount_, 0);
-        auto neighbors = Cloud->GetNearestNeighbors(embed.data(), CloseNum);
+    void TKNNCloud::GetExactNearestNeighbors(
+        const float* embed,
+        TVector<std::pair<float, ui32>>* distances,
+        TArrayRef<ui32> neighbors
+    ) const {
+        const size_t pointCount = Points.GetNumItems();
+        Y_ASSERT(neighbors.size() <= pointCount);
+        distances->yresize(pointCount);
+        for (ui32 pointId : xrange(pointCount)) {
+            (*distances)[pointId] = {Dist(embed, Points.GetItem(pointId)), pointId};
+        }
+        // ties are broken by point id
+        PartialSort(distances->begin(), distances->begin() + neighbors.size(), distances->end());
+        for (size_t pos : xrange(neighbors.size())) {
+            neighbors[pos] = (*distances)[pos].second;
+        }
+    }
+
+    void TKNNCloud::GetNearestNeighborsForBlock(
+        TConstArrayRef<TEmbeddingsArray> embeds,
+        ui32 knum,
+        TArrayRef<ui32> neighbors,
+        TArrayRef<ui32> neighborCounts
+    ) const {
+        const size_t pointCount = Points.GetNumItems();
+        if (pointCount > SEARCH_NEIGHBORHOOD_SIZE) {
+            IKNNCloud::GetNearestNeighborsForBlock(embeds, knum, neighbors, neighborCounts);
+            return;
+        }
+        Y_ASSERT(neighbors.size() >= embeds.size() * knum);
+        Y_ASSERT(neighborCounts.size() >= embeds.size());
+
+        const size_t neighborCount = Min<size_t>(knum, pointCount);
+        TVector<std::pair<float, ui32>> distances; // (distance, pointId)
+        for (size_t queryIdx : xrange(embeds.size())) {
+            GetExactNearestNeighbors(
+                embeds[queryIdx].data(),
+                &distances,
+                TArrayRef<ui32>(neighbors.data() + queryIdx * knum, neighborCount)
+            );
+            neighborCounts[queryIdx] = neighborCount;
+        }
+    }
+
+    void TKNNCalcer::CalcFeaturesFromNeighbors(TConstArrayRef<ui32> neighbors, TArrayRef<float> features) const {
+        Fill(features.begin(), features.end(), 0.0f);
         if (IsClassification) {
            for (size_t pos = 0; pos < neighbors.size(); ++pos) {
-                ++result[TargetClasses.at(neighbors[pos])];
+                ++features[TargetClasses.at(neighbors[pos])];
             }
         } else {
             if (neighbors.size()) {
                 for (size_t pos = 0; pos < neighbors.size(); ++pos) {
-                    result[0] += Targets.at(neighbors[pos]);
+                    features[0] += Targets.at(neighbors[pos]);
                 }
-                result[0] /= (float)neighbors.size();
+                features[0] /= (float)neighbors.size();
             }
         }
+    }
+
+    void TKNNCalcer::Compute(const TEmbeddingsArray& embed,
+                             TOutputFloatIterator iterator) const {
+        TVector<float> result(FeatureCount_, 0);
+        auto neighbors = Cloud->GetNearestNeighbors(embed.data(), CloseNum);
+        CalcFeaturesFromNeighbors(neighbors, result);
         ForEachActiveFeature(
             [&result, &iterator](ui32 featureId){
                 *iterator = result[featureId];
@@ -51,6 +130,39 @@ namespace NCB {
         );
     }
 
+    void TKNNCalcer::ComputeBlock(TConstArrayRef<TEmbeddingsArray> embeddings, TArrayRef<float> result) const {
+        const size_t docCount = embeddings.size();
+        const size_t maxBlockSize = Min<size_t>(docCount, APPLY_BLOCK_SIZE);
+        TVector<ui32> neighbors;
+        neighbors.yresize(maxBlockSize * CloseNum);
+        TVector<ui32> neighborCounts;
+        neighborCounts.yresize(maxBlockSize);
+        TVector<float> features(FeatureCount_, 0);
+        for (size_t blockStart = 0; blockStart < docCount; blockStart += APPLY_BLOCK_SIZE) {
+            const size_t blockSize = Min<size_t>(docCount - blockStart, APPLY_BLOCK_SIZE);
+            Cloud->GetNearestNeighborsForBlock(
+                embeddings.Slice(blockStart, blockSize),
+                CloseNum,
+                neighbors,
+                neighborCounts
+            );
+            for (size_t blockDocIdx : xrange(blockSize)) {
+                CalcFeaturesFromNeighbors(
+                    TConstArrayRef<ui32>(neighbors.data() + blockDocIdx * CloseNum, neighborCounts[blockDocIdx]),
+                    features
+                );
+                const size_t docId = blockStart + blockDocIdx;
+                size_t outputFeatureIdx = 0;
+                ForEachActiveFeature(
+                    [&](ui32 featureId){
+                        result[outputFeatureIdx * docCount + docId] = features[featureId];
+                        ++outputFeatureIdx;
+                    }
+                );
+            }
+        }
+    }
+
     void TKNNCalcerVisitor::Update(float target,
                 const TEmbeddingsArray& embed,
                 TEmbeddingFeatureCalcer* featureCalcer) {
@@ -22,6 +22,17 @@ namespace NCB {
     class IKNNCloud : public TThrRefBase {
     public:
         virtual TVector<ui32> GetNearestNeighbors(const float*, ui32) const = 0;
+
+        /* Nearest neighbors for a block of queries written to caller-provided buffers:
+         * neighbors of embeds[i] are in [i * knum, i * knum + neighborCounts[i]) of neighbors.
+         * Default implementation runs GetNearestNeighbors for each query.
+         */
+        virtual void GetNearestNeighborsForBlock(
+            TConstArrayRef<TEmbeddingsArray> embeds,
+            ui32 knum,
+            TArrayRef<ui32> neighbors,
+            TArrayRef<ui32> neighborCounts
+        ) const;
     };
 
     using TKNNCloudPtr = THolder<IKNNCloud>;
@@ -62,6 +73,9 @@ namespace NCB {
 
     class TKNNCloud : public IKNNCloud {
     public:
+        // search neighborhood size for HNSW queries
+        static constexpr size_t SEARCH_NEIGHBORHOOD_SIZE = 300;
+
         TKNNCloud(
             TBlob&& indexData,
             TVector<float>&& vectorData,
@@ -77,6 +91,17 @@ namespace NCB {
         }
         TVector<ui32> GetNearestNeighbors(const float* embed, ui32 knum) const override;
 
+        /* Clouds that are not larger than the search neighborhood are fully visited by HNSW anyway,
+         * so for them both single and block queries use exact brute-force search instead.
+         * Equidistant neighbors are ordered by point id in both searches.
+         */
+        void GetNearestNeighborsForBlock(
+            TConstArrayRef<TEmbeddingsArray> embeds,
+            ui32 knum,
+            TArrayRef<ui32> neighbors,
+            TArrayRef<ui32> neighborCounts
+        ) const override;
+
         const TBlob& GetIndexDataBlob() const {
             return IndexData;
         }
@@ -84,6 +109,14 @@ namespace NCB {
         const TVector<float>& GetPointsVector() const {
             return Points.GetVector();
         }
+    private:
+        // writes neighbors.size() nearest points ordered by (distance, point id)
+        void GetExactNearestNeighbors(
+            const float* embed,
+            TVector<std::pair<float, ui32>>* distances,
+            TArrayRef<ui32> neighbors
+        ) const;
+
     private:
         TBlob IndexData;
         TL2Distance Dist;
@@ -111,6 +144,7 @@ namespace NCB {
         {}
 
         void Compute(const TEmbeddingsArray& embed, TOutputFloatIterator outputFeaturesIterator) const override;
+        void ComputeBlock(TConstArrayRef<TEmbeddingsArray> embeddings, TArrayRef<float> result) const override;
 
         ui32 FeatureCount() const override {
             return FeatureCount_;
@@ -127,6 +161,10 @@ namespace NCB {
         void SaveLargeParameters(IOutputStream*) const override;
         void LoadLargeParameters(IInputStream*) override;
 
+    private:
+        // features[featureId] for all features, not only active ones
+        void CalcFeaturesFromNeighbors(TConstArrayRef<ui32> neighbors, TArrayRef<float> features) const;
+
     private:
         int TotalDimension;
         bool IsClassification;
@@ -69,12 +69,13 @@ namespace NCB {
     }
 
     void IncrementalCloud::AddVector(const TEmbeddingsArray& embed) {
-        ++AdditionalSize;
+        float* row = Buffer.data() + AdditionalSize * Dimension;
         for (int idx = 0; idx < Dimension; ++idx) {
-            Buffer.push_back(embed[idx] - BaseCenter[idx]);
-            NewShift[idx] += Buffer.back();
+            row[idx] = embed[idx] - BaseCenter[idx];
+            NewShift[idx] += row[idx];
         }
-        if (BaseSize < 128 || AdditionalSize >= 32) {
+        ++AdditionalSize;
+        if (BaseSize < MIN_BASE_SIZE_FOR_BLOCK_UPDATES || AdditionalSize >= UPDATE_BLOCK_SIZE) {
             Update();
         }
     }
@@ -87,20 +88,23 @@ namespace NCB {
             NewShift[idx] /= TotalSize();
             BaseCenter[idx] += NewShift[idx];
         }
-        cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans,
-                    Dimension, Dimension, AdditionalSize,
+        // only the lower triangle is updated, the upper one is restored below
+        cblas_ssyrk(CblasRowMajor, CblasLower, CblasTrans,
+                    Dimension, AdditionalSize,
                     1.0 / TotalSize(),
                     &Buffer[0], Dimension,
-                    &Buffer[0], Dimension,
                     BaseSize / TotalSize(),
                     &ScatterMatrix[0], Dimension);
-        Buffer.clear();
-        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans,
-               Dimension, Dimension, 1,
-               -1.0,
-               &NewShift[0], 1,
-               &NewShift[0], 1,
-               1.0, &ScatterMatrix[0], Dimension);
+        cblas_ssyr(CblasRowMajor, CblasLower,
+                   Dimension,
+                   -1.0,
+                   &NewShift[0], 1,
+                   &ScatterMatrix[0], Dimension);
+        for (int row = 0; row < Dimension; ++row) {
+            for (int column = 0; column < row; ++column) {
+                ScatterMatrix[column * Dimension + row] = ScatterMatrix[row * Dimension + column];
+            }
+        }
         BaseSize += AdditionalSize;
         AdditionalSize = 0;
         NewShift.assign(Dimension, 0);
@@ -10,13 +10,23 @@ namespace NCB {
 
     void InverseMatrix(TVector<float>* matrix, int dim);
 
+    /* Mean and scatter (covariance) matrix of a stream of vectors.
+     * Vectors are accumulated in a buffer and merged into the scatter matrix
+     * with a single symmetric rank-k update per block.
+     */
     class IncrementalCloud {
+    public:
+        // vectors are merged one by one until the cloud has this size
+        static constexpr int MIN_BASE_SIZE_FOR_BLOCK_UPDATES = 128;
+        static constexpr int UPDATE_BLOCK_SIZE = 32;
+
     public:
         IncrementalCloud(int dim)
             : Dimension(dim)
             , BaseCenter(dim, 0)
             , NewShift(dim, 0)
             , ScatterMatrix(dim * dim, 0)
+            , Buffer(UPDATE_BLOCK_SIZE * dim)
         {}
         void AddVector(const TEmbeddingsArray& embed);
         void Update();
@@ -31,7 +41,7 @@ namespace NCB {
         TVector<float> BaseCenter;
         TVector<float> NewShift;
         TVector<float> ScatterMatrix;
-        TVector<float> Buffer;
+        TVector<float> Buffer; // UPDATE_BLOCK_SIZE rows, first AdditionalSize are used
     };
 
     class TLinearDACalcer final : public TEmbeddingFeatureCalcer {
@@ -42,6 +42,39 @@ Y_UNIT_TEST_SUITE(TestCalcerCanonization) {
         UNIT_ASSERT_DOUBLES_EQUAL(ratio, 0.6065, 1e-2);
     }
 
+    Y_UNIT_TEST(TestIncrementalCloudScatter) {
+        const int dim = 5;
+        const int numSamples = 1000;
+
+        TVector<TEmbeddingsArray> dataSet;
+        for (int idx = 0; idx < numSamples; ++idx) {
+            dataSet.push_back(NormalEmbedding({1, -2, 3, 0, 5}));
+        }
+        IncrementalCloud cloud(dim);
+        for (const auto& embedding : dataSet) {
+            cloud.AddVector(embedding);
+        }
+        cloud.Update();
+
+        TVector<double> mean(dim, 0);
+        for (const auto& embedding : dataSet) {
+            for (int i = 0; i < dim; ++i) {
+                mean[i] += embedding[i] / double(numSamples);
+            }
+        }
+        for (int i = 0; i < dim; ++i) {
+            UNIT_ASSERT_DOUBLES_EQUAL(cloud.BaseCenter[i], mean[i], 1e-3);
+            for (int j = 0; j < dim; ++j) {
+                double scatter = 0;
+                for (const auto& embedding : dataSet) {
+                    scatter += (embedding[i] - mean[i]) * (embedding[j] - mean[j]) / numSamples;
+                }
+                UNIT_ASSERT_DOUBLES_EQUAL(cloud.ScatterMatrix[i * dim + j], scatter, 1e-3);
+                UNIT_ASSERT_VALUES_EQUAL(cloud.ScatterMatrix[i * dim + j], cloud.ScatterMatrix[j * dim + i]);
+            }
+        }
+    }
+
     Y_UNIT_TEST(TestLDACanonization) {
         const ui32 numSamples = 50000;
 
@@ -0,0 +1,109 @@
+#include <catboost/private/libs/embedding_features/knn.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/buffer.h>
+
+using namespace NCB;
+
+Y_UNIT_TEST_SUITE(TestKNNCalcer) {
+
+    TEmbeddingsArray MakeEmbedding(TVector<float> embedding) {
+        return TMaybeOwningArrayHolder<const float>::CreateOwning(std::move(embedding));
+    }
+
+    TVector<TEmbeddingsArray> GenerateEmbeddings(ui32 count, ui32 dim, TFastRng64* rng) {
+        TVector<TEmbeddingsArray> result;
+        for (auto i : xrange(count)) {
+            Y_UNUSED(i);
+            TVector<float> embedding(dim);
+            for (auto& coord : embedding) {
+                coord = rng->GenRandReal1();
+            }
+            result.push_back(MakeEmbedding(std::move(embedding)));
+        }
+        return result;
+    }
+
+    void CheckComputeBlock(const TEmbeddingFeatureCalcer& calcer, TConstArrayRef<TEmbeddingsArray> embeddings) {
+        const ui32 docCount = embeddings.size();
+        const ui32 featureCount = calcer.FeatureCount();
+
+        TVector<float> expected(docCount * featureCount);
+        for (auto docId : xrange(docCount)) {
+            calcer.Compute(embeddings[docId], TOutputFloatIterator(expected.data() + docId, docCount, expected.size()));
+        }
+
+        TVector<float> result(docCount * featureCount);
+        calcer.ComputeBlock(embeddings, result);
+        // both paths order equidistant neighbors by point id, so results are the same bit for bit
+        UNIT_ASSERT_VALUES_EQUAL(result, expected);
+    }
+
+    void TestComputeBlock(bool isClassification) {
+        const ui32 dim = 8;
+        const ui32 numClasses = 3;
+        const ui32 featureCount = isClassification ? numClasses : 1;
+        const ui32 learnSize = 200;
+        const ui32 testSize = 300;
+
+        TFastRng64 rng(0);
+        const auto learnEmbeddings = GenerateEmbeddings(learnSize, dim, &rng);
+        const auto testEmbeddings = GenerateEmbeddings(testSize, dim, &rng);
+
+        TKNNCalcer calcer(dim, isClassification, featureCount, /*closeNum*/ 5);
+        TKNNCalcerVisitor visitor;
+        for (auto idx : xrange(learnSize)) {
+            const float target = isClassification ? float(idx % numClasses) : rng.GenRandReal1();
+            visitor.Update(target, learnEmbeddings[idx], &calcer);
+        }
+        CheckComputeBlock(calcer, testEmbeddings);
+
+        // loaded calcer uses the static cloud
+        TBufferOutput output;
+        TEmbeddingCalcerSerializer::Save(&output, calcer);
+        TBufferInput input(output.Buffer());
+        const auto loadedCalcer = TEmbeddingCalcerSerializer::Load(&input);
+        CheckComputeBlock(*loadedCalcer, testEmbeddings);
+    }
+
+    Y_UNIT_TEST(TestComputeBlockClassification) {
+        TestComputeBlock(/*isClassification*/ true);
+    }
+
+    Y_UNIT_TEST(TestComputeBlockRegression) {
+        TestComputeBlock(/*isClassification*/ false);
+    }
+
+    Y_UNIT_TEST(TestEquidistantNeighbors) {
+        const ui32 dim = 2;
+        const ui32 numClasses = 3;
+
+        TKNNCalcer calcer(dim, /*isClassification*/ true, numClasses, /*closeNum*/ 2);
+        TKNNCalcerVisitor visitor;
+        // the same point with three different classes and a far point
+        for (auto classId : xrange(numClasses)) {
+            visitor.Update(classId, MakeEmbedding({0.0f, 0.0f}), &calcer);
+        }
+        visitor.Update(0, MakeEmbedding({10.0f, 10.0f}), &calcer);
+
+        TBufferOutput output;
+        TEmbeddingCalcerSerializer::Save(&output, calcer);
+        TBufferInput input(output.Buffer());
+        const auto loadedCalcer = TEmbeddingCalcerSerializer::Load(&input);
+
+        const TVector<TEmbeddingsArray> queries = {
+            MakeEmbedding({0.0f, 0.0f}),
+            MakeEmbedding({1.0f, -1.0f}),
+            MakeEmbedding({9.0f, 9.0f})
+        };
+        CheckComputeBlock(*loadedCalcer, queries);
+
+        // the first two of the equidistant points are taken
+        TVector<float> features(numClasses);
+        loadedCalcer->Compute(queries[0], TOutputFloatIterator(features.data(), features.size()));
+        UNIT_ASSERT_VALUES_EQUAL(features, (TVector<float>{1, 1, 0}));
+    }
+}
@@ -115,9 +115,7 @@ namespace NCB {
                 const ui64 samplesCount = currentDataset.SamplesCount();
                 TVector<float> features(featuresCount * samplesCount);
 
-                for (ui64 line = 0; line < samplesCount; ++line) {
-                    Compute(featureCalcer, currentDataset.GetVector(line), line, samplesCount, features);
-                }
+                featureCalcer.ComputeBlock(currentDataset.GetEmbedding(), features);
 
                 for (ui32 f = 0; f < featuresCount; ++f) {
                     visitors[id](
@@ -20,6 +20,7 @@ namespace NCB {
         TVector<TString> ModelFileName; // [modelIdx]
         EModelType ModelFormat = EModelType::CatboostBinary;
         NCB::TPathWithScheme OutputPath;
+        EEvalOutputFormat OutputFormat = EEvalOutputFormat::Tsv;
 
         int Verbose;
 
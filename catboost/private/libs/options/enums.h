@@ -438,4 +438,9 @@ namespace NCB {
         Individual,
         ByTags
     };
+
+    enum class EEvalOutputFormat {
+        Tsv,
+        Binary
+    };
 }
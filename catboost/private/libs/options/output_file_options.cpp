@@ -88,6 +88,7 @@ NCatboostOptions::TOutputFilesOptions::TOutputFilesOptions()
     , AllowWriteFilesFlag("allow_writing_files", true)
     , FinalCtrComputationMode("final_ctr_computation_mode", EFinalCtrComputationMode::Default)
     , FinalFeatureCalcerComputationMode("final_feature_calcer_computation_mode", EFinalFeatureCalcersComputationMode::Default)
+    , CompactCtrTablesFlag("compact_ctr_tables", false)
     , EvalFileName("eval_file_name", "")
     , FstrRegularFileName("fstr_regular_file", "")
     , FstrInternalFileName("fstr_internal_file", "")
@@ -217,6 +218,10 @@ EFinalCtrComputationMode NCatboostOptions::TOutputFilesOptions::GetFinalCtrCompu
     return FinalCtrComputationMode.Get();
 }
 
+bool NCatboostOptions::TOutputFilesOptions::CompactCtrTables() const {
+    return CompactCtrTablesFlag.Get();
+}
+
 bool NCatboostOptions::TOutputFilesOptions::SaveSnapshot() const {
     return SaveSnapshotFlag.Get();
 }
@@ -267,7 +272,7 @@ bool NCatboostOptions::TOutputFilesOptions::operator==(const TOutputFilesOptions
             TimeLeftLog, ResultModelPath, SnapshotPath, ModelFormats, SaveSnapshotFlag,
             AllowWriteFilesFlag, FinalCtrComputationMode, FinalFeatureCalcerComputationMode, UseBestModel, BestModelMinTrees,
             SnapshotSaveIntervalSeconds, EvalFileName, FstrRegularFileName, FstrInternalFileName, FstrType,
-            TrainingOptionsFileName, OutputBordersFileName, RocOutputPath
+            TrainingOptionsFileName, OutputBordersFileName, RocOutputPath, CompactCtrTablesFlag
             ) == std::tie(
                 rhs.TrainDir, rhs.Name, rhs.JsonLogPath, rhs.ProfileLogPath,
                 rhs.LearnErrorLogPath, rhs.TestErrorLogPath, rhs.TimeLeftLog, rhs.ResultModelPath,
@@ -275,7 +280,7 @@ bool NCatboostOptions::TOutputFilesOptions::operator==(const TOutputFilesOptions
                 rhs.FinalCtrComputationMode, rhs.FinalFeatureCalcerComputationMode, rhs.UseBestModel, rhs.BestModelMinTrees,
                 rhs.SnapshotSaveIntervalSeconds, rhs.EvalFileName, rhs.FstrRegularFileName,
                 rhs.FstrInternalFileName, rhs.FstrType, rhs.TrainingOptionsFileName, rhs.OutputBordersFileName,
-                rhs.RocOutputPath
+                rhs.RocOutputPath, rhs.CompactCtrTablesFlag
                 );
 }
 
@@ -291,7 +296,7 @@ void NCatboostOptions::TOutputFilesOptions::Load(const NJson::TJsonValue& option
             &SaveSnapshotFlag, &AllowWriteFilesFlag, &FinalCtrComputationMode, &FinalFeatureCalcerComputationMode,
             &UseBestModel, &BestModelMinTrees, &SnapshotSaveIntervalSeconds, &EvalFileName, &OutputColumns,
             &FstrRegularFileName, &FstrInternalFileName, &FstrType, &TrainingOptionsFileName, &MetricPeriod,
-            &VerbosePeriod, &PredictionTypes, &OutputBordersFileName, &RocOutputPath
+            &VerbosePeriod, &PredictionTypes, &OutputBordersFileName, &RocOutputPath, &CompactCtrTablesFlag
             );
     if (!VerbosePeriod.IsSet() || VerbosePeriod.Get() == 1) {
         VerbosePeriod.Set(MetricPeriod.Get());
@@ -307,7 +312,7 @@ void NCatboostOptions::TOutputFilesOptions::Save(NJson::TJsonValue* options) con
             AllowWriteFilesFlag, FinalCtrComputationMode, FinalFeatureCalcerComputationMode, UseBestModel,
             BestModelMinTrees, SnapshotSaveIntervalSeconds, EvalFileName, OutputColumns, FstrRegularFileName,
             FstrInternalFileName, FstrType, TrainingOptionsFileName, MetricPeriod, VerbosePeriod, PredictionTypes,
-            OutputBordersFileName, RocOutputPath
+            OutputBordersFileName, RocOutputPath, CompactCtrTablesFlag
             );
 }
 
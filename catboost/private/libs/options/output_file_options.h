@@ -75,6 +75,8 @@ namespace NCatboostOptions {
 
         EFinalFeatureCalcersComputationMode GetFinalFeatureCalcerComputationMode() const;
 
+        bool CompactCtrTables() const;
+
         bool SaveSnapshot() const;
 
         ui64 GetSnapshotSaveInterval() const;
@@ -153,6 +155,7 @@ namespace NCatboostOptions {
         TOption<bool> AllowWriteFilesFlag;
         TOption<EFinalCtrComputationMode> FinalCtrComputationMode;
         TOption<EFinalFeatureCalcersComputationMode> FinalFeatureCalcerComputationMode;
+        TOption<bool> CompactCtrTablesFlag;
         TOption<TString> EvalFileName;
         TOption<TString> FstrRegularFileName;
         TOption<TString> FstrInternalFileName;
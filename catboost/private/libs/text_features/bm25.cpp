@@ -82,6 +82,70 @@ void TBM25::Compute(const TText& text, TOutputFloatIterator iterator) const {
     );
 }
 
+void TBM25::PrepareForApply() {
+    TokenScores.Reset(NumClasses);
+
+    TVector<ui32> termFreqInClass(NumClasses);
+    const double meanClassLength = (double)TotalTokens / NumClasses;
+    for (const auto& classFreqTable : Frequencies) {
+        for (const auto& [token, freq] : classFreqTable) {
+            Y_UNUSED(freq);
+            if (TokenScores.HasRow(token)) {
+                continue;
+            }
+            const ui32 nonZeroCount = ExtractTermFreq(Frequencies, token, termFreqInClass);
+            auto tokenScores = TokenScores.AddRow(token);
+            for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+                tokenScores[clazz] = TruncatedInvClassFreq[nonZeroCount] * Score(termFreqInClass[clazz], K, B, meanClassLength,  ClassTotalTokens[clazz]);
+            }
+        }
+    }
+}
+
+void TBM25::ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const {
+    if (TokenScores.Empty()) {
+        TTextFeatureCalcer::ComputeBlock(texts, result);
+        return;
+    }
+
+    const ui64 docCount = texts.size();
+    const auto activeFeatureIndices = GetActiveFeatureIndices();
+
+    TVector<ui32> textOffsets;
+    TVector<const double*> tokenScores;
+    TVector<ui32> tokenCounts;
+    TVector<double> scores(NumClasses);
+    for (ui64 blockBegin = 0; blockBegin < docCount; blockBegin += APPLY_BLOCK_SIZE) {
+        const ui64 blockSize = Min<ui64>(APPLY_BLOCK_SIZE, docCount - blockBegin);
+        // tokens that are absent in all classes have zero scores
+        TokenScores.GatherRows(
+            texts.subspan(blockBegin, blockSize),
+            /*missingTokenRow*/ nullptr,
+            &textOffsets,
+            &tokenScores,
+            &tokenCounts
+        );
+
+        for (ui64 blockDocId : xrange(blockSize)) {
+            Fill(scores.begin(), scores.end(), 0.0);
+            for (ui32 tokenIdx : xrange(textOffsets[blockDocId], textOffsets[blockDocId + 1])) {
+                const double* tokenScoresRow = tokenScores[tokenIdx];
+                if (!tokenScoresRow) {
+                    continue;
+                }
+                for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+                    scores[clazz] += tokenScoresRow[clazz];
+                }
+            }
+
+            const ui64 docId = blockBegin + blockDocId;
+            for (ui32 featureIdx : xrange(activeFeatureIndices.size())) {
+                result[featureIdx * docCount + docId] = scores[activeFeatureIndices[featureIdx]];
+            }
+        }
+    }
+}
+
 TTextFeatureCalcer::TFeatureCalcerFbs TBM25::SaveParametersToFB(flatbuffers::FlatBufferBuilder& builder) const {
     using namespace NCatBoostFbs;
 
@@ -135,6 +199,10 @@ void TBM25Visitor::Update(ui32 classId, const TText& text, TTextFeatureCalcer* c
     Y_ASSERT(bm25);
 
     auto& classCounts = bm25->Frequencies[classId];
+    // scores are stale once frequencies change, the table is rebuilt on the next apply
+    if (!bm25->TokenScores.Empty()) {
+        bm25->TokenScores.Clear();
+    }
 
     for (const auto& tokenToCount : text) {
         const ui32 count = tokenToCount.Count();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "feature_calcer.h"
+#include "token_class_table.h"
 
 #include <library/cpp/containers/dense_hash/dense_hash.h>
 #include <util/system/types.h>
@@ -34,6 +35,9 @@ namespace NCB {
         }
 
         void Compute(const TText& text, TOutputFloatIterator iterator) const override;
+        void ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const override;
+
+        void PrepareForApply() override;
 
         static ui32 BaseFeatureCount(ui32 numClasses) {
             return numClasses;
@@ -50,6 +54,9 @@ namespace NCB {
         TVector<TDenseHash<TTokenId, ui32>> Frequencies;
         TVector<double> TruncatedInvClassFreq;
 
+        // [token][class] -> BM25 score term, filled by PrepareForApply
+        TTokenClassTable<double> TokenScores;
+
     protected:
         TTextFeatureCalcer::TFeatureCalcerFbs SaveParametersToFB(flatbuffers::FlatBufferBuilder& builder) const override;
         void LoadParametersFromFB(const NCatBoostFbs::TFeatureCalcer* calcerFbs) override;
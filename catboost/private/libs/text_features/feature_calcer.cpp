@@ -2,6 +2,7 @@
 
 #include <catboost/libs/helpers/serialization.h>
 
+#include <util/generic/xrange.h>
 #include <util/system/guard.h>
 
 namespace NCB {
@@ -25,6 +26,13 @@ namespace NCB {
         return calcer;
     }
 
+    void TTextFeatureCalcer::ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const {
+        const ui64 docCount = texts.size();
+        for (ui32 docId: xrange(docCount)) {
+            Compute(texts[docId], TOutputFloatIterator(result.data() + docId, docCount, result.size()));
+        }
+    }
+
     void TTextFeatureCalcer::Save(IOutputStream* stream) const {
         flatbuffers::FlatBufferBuilder builder;
         TFeatureCalcerFbs anyCalcerFbs = SaveParametersToFB(builder);
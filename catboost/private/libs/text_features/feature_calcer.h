@@ -104,6 +104,17 @@ namespace NCB {
             return result;
         }
 
+        /* Computes features for a block of texts.
+         * result is feature-major: feature i of text j is written to result[i * texts.size() + j]
+         */
+        virtual void ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const;
+
+        /* Called when calcer is a part of a model and won't be updated anymore.
+         * Calcers can precompute data for ComputeBlock here.
+         */
+        virtual void PrepareForApply() {
+        }
+
         void Save(IOutputStream* stream) const final;
         void Load(IInputStream* stream) final;
 
@@ -120,6 +131,9 @@ namespace NCB {
         }
 
     protected:
+        // number of texts processed together in ComputeBlock implementations
+        static constexpr ui32 APPLY_BLOCK_SIZE = 128;
+
         class TFeatureCalcerFbs {
         public:
             using TCalcerFbsImpl = flatbuffers::Offset<void>;
@@ -4,6 +4,8 @@
 #include <catboost/private/libs/text_features/flatbuffers/feature_calcers.fbs.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/maybe.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 
 using namespace NCB;
@@ -62,6 +64,90 @@ void TMultinomialNaiveBayes::Compute(
     );
 }
 
+void TMultinomialNaiveBayes::PrepareForApply() {
+    // the same values as computed in LogProb
+    const auto fillRow = [&] (TMaybe<TTokenId> token, TArrayRef<double> row) {
+        for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+            const auto& freqTable = Frequencies[clazz];
+            auto tokenCountPtr = token ? freqTable.find(*token) : freqTable.end();
+            double num = TokenPrior;
+            double classTokensCountIncrement = 0.0;
+            if (tokenCountPtr != freqTable.end()) {
+                num += tokenCountPtr->second;
+            } else {
+                classTokensCountIncrement = TokenPrior;
+            }
+            row[clazz] = log(num);
+            row[NumClasses + clazz] = classTokensCountIncrement;
+        }
+    };
+
+    TokenLogProbs.Reset(2 * NumClasses);
+    for (const auto& classFreqTable : Frequencies) {
+        for (const auto& [token, count] : classFreqTable) {
+            Y_UNUSED(count);
+            if (!TokenLogProbs.HasRow(token)) {
+                fillRow(token, TokenLogProbs.AddRow(token));
+            }
+        }
+    }
+    UnseenTokenLogProbs.yresize(2 * NumClasses);
+    fillRow(Nothing(), UnseenTokenLogProbs);
+}
+
+void TMultinomialNaiveBayes::ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const {
+    if (TokenLogProbs.Empty()) {
+        TTextFeatureCalcer::ComputeBlock(texts, result);
+        return;
+    }
+
+    const ui64 docCount = texts.size();
+    const auto activeFeatureIndices = GetActiveFeatureIndices();
+
+    TVector<ui32> textOffsets;
+    TVector<const double*> tokenLogProbs;
+    TVector<ui32> tokenCounts;
+    TVector<double> logProbs(NumClasses);
+    TVector<double> classTokensCounts(NumClasses);
+    for (ui64 blockBegin = 0; blockBegin < docCount; blockBegin += APPLY_BLOCK_SIZE) {
+        const ui64 blockSize = Min<ui64>(APPLY_BLOCK_SIZE, docCount - blockBegin);
+        TokenLogProbs.GatherRows(
+            texts.subspan(blockBegin, blockSize),
+            UnseenTokenLogProbs.data(),
+            &textOffsets,
+            &tokenLogProbs,
+            &tokenCounts
+        );
+
+        for (ui64 blockDocId : xrange(blockSize)) {
+            for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+                logProbs[clazz] = log(double(ClassDocs[clazz]) + ClassPrior);
+                classTokensCounts[clazz] = double(ClassTotalTokens[clazz]);
+                classTokensCounts[clazz] += TokenPrior * (NumSeenTokens + SEEN_TOKENS_PRIOR);
+            }
+            double textLen = 0;
+            for (ui32 tokenIdx : xrange(textOffsets[blockDocId], textOffsets[blockDocId + 1])) {
+                const double* row = tokenLogProbs[tokenIdx];
+                const ui32 count = tokenCounts[tokenIdx];
+                textLen += count;
+                for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+                    logProbs[clazz] += count * row[clazz];
+                    classTokensCounts[clazz] += row[NumClasses + clazz];
+                }
+            }
+            for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+                logProbs[clazz] -= textLen * log(classTokensCounts[clazz]);
+            }
+            Softmax(logProbs);
+
+            const ui64 docId = blockBegin + blockDocId;
+            for (ui32 featureIdx : xrange(activeFeatureIndices.size())) {
+                result[featureIdx * docCount + docId] = logProbs[activeFeatureIndices[featureIdx]];
+            }
+        }
+    }
+}
+
 TTextFeatureCalcer::TFeatureCalcerFbs TMultinomialNaiveBayes::SaveParametersToFB(flatbuffers::FlatBufferBuilder& builder) const {
     using namespace NCatBoostFbs;
 
@@ -121,6 +207,10 @@ void TNaiveBayesVisitor::Update(ui32 classId, const TText& text, TTextFeatureCal
     Y_ASSERT(naiveBayes);
 
     auto& classCounts = naiveBayes->Frequencies[classId];
+    // scores are stale once frequencies change, the table is rebuilt on the next apply
+    if (!naiveBayes->TokenLogProbs.Empty()) {
+        naiveBayes->TokenLogProbs.Clear();
+    }
 
     for (const auto& tokenToCount : text) {
         SeenTokens.Insert(tokenToCount.Token());
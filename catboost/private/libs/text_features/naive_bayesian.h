@@ -1,6 +1,7 @@
 #pragma once
 
 #include "feature_calcer.h"
+#include "token_class_table.h"
 
 #include <library/cpp/containers/dense_hash/dense_hash.h>
 #include <util/system/types.h>
@@ -34,6 +35,9 @@ namespace NCB {
         }
 
         void Compute(const TText& text, TOutputFloatIterator iterator) const override;
+        void ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const override;
+
+        void PrepareForApply() override;
 
         static ui32 BaseFeatureCount(ui32 numClasses) {
             return numClasses > 2 ? numClasses : 1;
@@ -72,6 +76,12 @@ namespace NCB {
         TVector<ui64> ClassTotalTokens;
         TVector<TDenseHash<TTokenId, ui32>> Frequencies;
 
+        /* Filled by PrepareForApply.
+         * [token] -> (log numerators for all classes, class tokens count increments for all classes)
+         */
+        TTokenClassTable<double> TokenLogProbs;
+        TVector<double> UnseenTokenLogProbs; // the same for tokens that are absent in all classes
+
         friend class TNaiveBayesVisitor;
     };
 
@@ -13,31 +13,11 @@
 
 namespace NCB {
     static void CalcFeatures(
-        const TVector<TTokensWithBuffer>& tokens,
-        const TDictionaryProxy& dictionary,
+        TConstArrayRef<TText> texts,
         const TTextFeatureCalcer& calcer,
         TArrayRef<float> result
     ) {
-        const ui64 docCount = tokens.size();
-        for (ui32 docId: xrange(docCount)) {
-            TText text = dictionary.Apply(tokens[docId].View);
-
-            calcer.Compute(
-                text,
-                TOutputFloatIterator(result.data() + docId, docCount, result.size())
-            );
-        }
-    }
-
-    static void TokenizeTextFeature(
-        TConstArrayRef<TStringBuf> textFeature,
-        size_t docCount,
-        TTokenizerPtr tokenizer,
-        TVector<TTokensWithBuffer>* tokens
-    ) {
-        for (ui32 docId: xrange(docCount)) {
-            tokenizer->Tokenize(textFeature[docId], &(*tokens)[docId]);
-        }
+        calcer.ComputeBlock(texts, result);
     }
 
     void TTextProcessingCollection::CalcFeatures(
@@ -51,8 +31,10 @@ namespace NCB {
             "Proposed result buffer has size less than text processing produce"
         );
 
-        TVector<TTokensWithBuffer> tokens;
-        tokens.yresize(docCount);
+        // buffers are reused for all digitizers of the feature
+        TTokenizedTextBlock tokens;
+        TVector<TText> texts;
+        TVector<ui32> tokenIdsBuffer;
         TTokenizerPtr previousTokenizer;
 
         for (ui32 digitizerId: PerFeatureDigitizers[textFeatureIdx]) {
@@ -60,10 +42,13 @@ namespace NCB {
             const ui32 tokenizedFeatureIdx = GetTokenizedFeatureId(textFeatureIdx, digitizerId);
 
             if (!previousTokenizer || Digitizers[digitizerId].Tokenizer != previousTokenizer) {
-                TokenizeTextFeature(textFeature, docCount, Digitizers[digitizerId].Tokenizer, &tokens);
+                Digitizers[digitizerId].Tokenizer->TokenizeBlock(textFeature.first(docCount), &tokens);
                 previousTokenizer = Digitizers[digitizerId].Tokenizer;
             }
 
+            // dictionary is applied once for all calcers of the tokenized feature
+            dictionary->ApplyBlock(tokens, &texts, &tokenIdsBuffer);
+
             for (ui32 calcerId: PerTokenizedFeatureCalcers[tokenizedFeatureIdx]) {
                 const auto& calcer = FeatureCalcers[calcerId];
 
@@ -74,7 +59,7 @@ namespace NCB {
                     result.data() + calcerOffset,
                     result.data() + calcerOffset + calculatedFeaturesSize
                 );
-                NCB::CalcFeatures(tokens, *dictionary, *calcer, currentResult);
+                NCB::CalcFeatures(texts, *calcer, currentResult);
             }
         }
     }
@@ -438,6 +423,10 @@ namespace NCB {
         for (ui32 calcerFlatIdx: xrange(FeatureCalcerId.size())) {
             CalcerGuidToFlatIdx[FeatureCalcerId[calcerFlatIdx]] = calcerFlatIdx;
         }
+
+        for (auto& calcer : FeatureCalcers) {
+            calcer->PrepareForApply();
+        }
     }
 
     ui32 TTextProcessingCollection::GetFirstTextFeatureCalcer(ui32 textFeatureIdx) const {
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <catboost/private/libs/data_types/text.h>
+
+#include <library/cpp/containers/dense_hash/dense_hash.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+#include <util/system/yassert.h>
+
+
+namespace NCB {
+
+    /* Rows of per-class values for tokens stored in one flat buffer:
+     * a single hash lookup per token gives a contiguous row for all classes.
+     * Used by text feature calcers to apply models without per-class lookups.
+     */
+    template <class T>
+    class TTokenClassTable {
+    public:
+        void Reset(ui32 rowSize) {
+            RowSize = rowSize;
+            TokenToRow = TDenseHash<TTokenId, ui32>();
+            Values.clear();
+        }
+
+        void Clear() {
+            Reset(0);
+        }
+
+        bool Empty() const {
+            return Values.empty();
+        }
+
+        ui32 GetRowSize() const {
+            return RowSize;
+        }
+
+        // token must not be present in the table
+        TArrayRef<T> AddRow(TTokenId token) {
+            Y_ASSERT(TokenToRow.find(token) == TokenToRow.end());
+            const ui32 rowOffset = Values.size();
+            TokenToRow.insert({token, rowOffset});
+            Values.resize(rowOffset + RowSize);
+            return TArrayRef<T>(Values.data() + rowOffset, RowSize);
+        }
+
+        // returns nullptr if there's no row for token
+        const T* FindRow(TTokenId token) const {
+            const auto rowIt = TokenToRow.find(token);
+            return rowIt != TokenToRow.end() ? Values.data() + rowIt->second : nullptr;
+        }
+
+        bool HasRow(TTokenId token) const {
+            return TokenToRow.find(token) != TokenToRow.end();
+        }
+
+        /* Gathers rows for all tokens of the texts in CSR format:
+         * tokens of text i are in [(*textOffsets)[i], (*textOffsets)[i + 1]) of rows and counts.
+         * Rows of tokens that are not in the table are set to missingTokenRow.
+         */
+        void GatherRows(
+            TConstArrayRef<TText> texts,
+            const T* missingTokenRow,
+            TVector<ui32>* textOffsets,
+            TVector<const T*>* rows,
+            TVector<ui32>* counts
+        ) const {
+            textOffsets->clear();
+            rows->clear();
+            counts->clear();
+            textOffsets->push_back(0);
+            for (const auto& text : texts) {
+                for (const auto& tokenToCount : text) {
+                    const T* row = FindRow(tokenToCount.Token());
+                    rows->push_back(row ? row : missingTokenRow);
+                    counts->push_back(tokenToCount.Count());
+                }
+                textOffsets->push_back(rows->size());
+            }
+        }
+
+    private:
+        ui32 RowSize = 0;
+        TDenseHash<TTokenId, ui32> TokenToRow;
+        TVector<T> Values;
+    };
+
+}
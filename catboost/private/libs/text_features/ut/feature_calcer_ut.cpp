@@ -242,4 +242,54 @@ Y_UNIT_TEST_SUITE(TestFeatureCalcer) {
             );
         }
     }
+
+    Y_UNIT_TEST(TestComputeBlock) {
+        const ui32 numTrainTokens = 30;
+        const ui32 numTokens = 40; // tokens >= numTrainTokens are unseen in training
+        const ui32 numSamples = 300;
+
+        TVector<TText> texts;
+        for (ui32 docId : xrange(numSamples)) {
+            TVector<ui32> tokenIds;
+            for (ui32 idx : xrange(docId % 13)) {
+                tokenIds.push_back((docId * 7 + idx * idx) % numTokens);
+            }
+            texts.emplace_back(std::move(tokenIds));
+        }
+
+        for (const ui32 numClasses : {2, 5}) {
+            TVector<std::pair<TTextFeatureCalcerPtr, TTextCalcerVisitorPtr>> calcersWithVisitors = {
+                {MakeIntrusive<TBM25>(CreateGuid(), numClasses), MakeIntrusive<TBM25Visitor>()},
+                {MakeIntrusive<TMultinomialNaiveBayes>(CreateGuid(), numClasses), MakeIntrusive<TNaiveBayesVisitor>()}
+            };
+
+            for (auto& [calcer, visitor] : calcersWithVisitors) {
+                for (ui32 docId : xrange(numSamples)) {
+                    TVector<ui32> tokenIds;
+                    for (const auto& tokenToCount : texts[docId]) {
+                        if (static_cast<ui32>(tokenToCount.Token()) < numTrainTokens) {
+                            tokenIds.push_back(tokenToCount.Token());
+                        }
+                    }
+                    visitor->Update(docId % numClasses, TText(std::move(tokenIds)), calcer.Get());
+                }
+
+                const ui32 featureCount = calcer->FeatureCount();
+                TVector<float> expectedFeatures(numSamples * featureCount);
+                for (ui32 docId : xrange(numSamples)) {
+                    calcer->Compute(
+                        texts[docId],
+                        TOutputFloatIterator(expectedFeatures.data() + docId, numSamples, expectedFeatures.size())
+                    );
+                }
+
+                calcer->PrepareForApply();
+                TVector<float> features(numSamples * featureCount);
+                calcer->ComputeBlock(texts, features);
+                for (ui32 idx : xrange(features.size())) {
+                    UNIT_ASSERT_VALUES_EQUAL(expectedFeatures[idx], features[idx]);
+                }
+            }
+        }
+    }
 }
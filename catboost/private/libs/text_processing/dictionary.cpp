@@ -1,5 +1,7 @@
 #include "dictionary.h"
 
+#include <util/generic/xrange.h>
+
 namespace NCB {
     TDictionaryProxy::TDictionaryProxy(TDictionaryPtr dictionaryImpl)
         : DictionaryImpl(std::move(dictionaryImpl))
@@ -16,6 +18,27 @@ namespace NCB {
         *text = TText{std::move(tokenIds)};
     }
 
+    void TDictionaryProxy::Apply(
+        TConstArrayRef<TStringBuf> tokens,
+        TText* text,
+        TVector<ui32>* tokenIdsBuffer
+    ) const {
+        DictionaryImpl->Apply(tokens, tokenIdsBuffer);
+        text->Assign(*tokenIdsBuffer);
+    }
+
+    void TDictionaryProxy::ApplyBlock(
+        const TTokenizedTextBlock& tokens,
+        TVector<TText>* texts,
+        TVector<ui32>* tokenIdsBuffer
+    ) const {
+        const ui32 docCount = tokens.GetDocCount();
+        texts->resize(docCount);
+        for (ui32 docIdx : xrange(docCount)) {
+            Apply(tokens.GetTokens(docIdx), &(*texts)[docIdx], tokenIdsBuffer);
+        }
+    }
+
     ui32 TDictionaryProxy::Size() const {
         return DictionaryImpl->Size();
     }
@@ -33,6 +33,16 @@ namespace NCB {
         TText Apply(TConstArrayRef<TStringBuf> tokens) const;
         void Apply(TConstArrayRef<TStringBuf> tokens, TText* text) const;
 
+        // tokenIdsBuffer is a scratch buffer reused between calls to avoid allocations
+        void Apply(TConstArrayRef<TStringBuf> tokens, TText* text, TVector<ui32>* tokenIdsBuffer) const;
+
+        // texts are resized to the block size, already allocated storage of texts is reused
+        void ApplyBlock(
+            const TTokenizedTextBlock& tokens,
+            TVector<TText>* texts,
+            TVector<ui32>* tokenIdsBuffer
+        ) const;
+
         ui32 Size() const;
 
         TTokenId GetUnknownTokenId() const;
@@ -5,9 +5,11 @@ using namespace NCB;
 
 void TTextColumnBuilder::AddText(ui32 index, const TStringBuf text) {
     CB_ENSURE_INTERNAL(index < Texts.size(), "Text index is out of range");
-    TTokensWithBuffer tokens;
-    Tokenizer->Tokenize(text, &tokens);
-    Dictionary->Apply(tokens.View, &Texts[index]);
+    const size_t threadId = LocalExecutor ? (size_t)LocalExecutor->GetWorkerThreadId() : 0;
+    CB_ENSURE_INTERNAL(threadId < ThreadBuffers.size(), "Thread id is out of range");
+    auto& threadBuffers = ThreadBuffers[threadId];
+    Tokenizer->Tokenize(text, &threadBuffers.Tokens);
+    Dictionary->Apply(threadBuffers.Tokens.View, &Texts[index], &threadBuffers.TokenIds);
 }
 
 TVector<TText> TTextColumnBuilder::Build() {
@@ -2,6 +2,9 @@
 
 #include "text_dataset.h"
 #include "tokenizer.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <array>
 #include <util/generic/fwd.h>
 
@@ -10,22 +13,42 @@ namespace NCB {
 
     class TTextColumnBuilder {
     public:
-        TTextColumnBuilder(TTokenizerPtr tokenizer, TDictionaryPtr dictionary, ui32 samplesCount)
+        /* if localExecutor is specified AddText can be called from its threads concurrently,
+         * each thread then uses its own scratch buffers
+         */
+        TTextColumnBuilder(
+            TTokenizerPtr tokenizer,
+            TDictionaryPtr dictionary,
+            ui32 samplesCount,
+            NPar::ILocalExecutor* localExecutor = nullptr
+        )
             : Tokenizer(std::move(tokenizer))
             , Dictionary(std::move(dictionary))
             , Texts(samplesCount)
+            , LocalExecutor(localExecutor)
+            // extra +1 until issues with TTbbLocalExecutor::GetWorkerThreadId are resolved
+            , ThreadBuffers(localExecutor ? localExecutor->GetThreadCount() + 2 : 1)
         {}
 
         void AddText(ui32 index, TStringBuf text);
 
         TVector<TText> Build();
 
+    private:
+        struct TThreadBuffers {
+            TTokensWithBuffer Tokens;
+            TVector<ui32> TokenIds;
+        };
+
     private:
         TTokenizerPtr Tokenizer;
         TDictionaryPtr Dictionary;
 
         TVector<TText> Texts;
 
+        NPar::ILocalExecutor* LocalExecutor;
+        TVector<TThreadBuffers> ThreadBuffers;
+
         bool WasBuilt = false;
     };
 
@@ -28,6 +28,39 @@ void NCB::TTokenizer::Tokenize(TStringBuf inputString, TTokensWithBuffer* tokens
     }
 }
 
+void NCB::TTokenizer::TokenizeBlock(TConstArrayRef<TStringBuf> inputStrings, TTokenizedTextBlock* tokens) {
+    tokens->Clear();
+    tokens->DocOffsets.reserve(inputStrings.size() + 1);
+    tokens->DocOffsets.push_back(0);
+
+    const bool needToModifyTokens = TokenizerImpl.NeedToModifyTokens();
+    for (auto inputString : inputStrings) {
+        Tokenize(inputString, &tokens->DocTokens);
+        if (needToModifyTokens) {
+            // TokensData can be reallocated, so data pointers are set after the whole block is processed
+            for (auto token : tokens->DocTokens.View) {
+                tokens->TokensData.insert(tokens->TokensData.end(), token.begin(), token.end());
+                tokens->Tokens.emplace_back(static_cast<const char*>(nullptr), token.size());
+            }
+        } else {
+            tokens->Tokens.insert(
+                tokens->Tokens.end(),
+                tokens->DocTokens.View.begin(),
+                tokens->DocTokens.View.end()
+            );
+        }
+        tokens->DocOffsets.push_back(tokens->Tokens.size());
+    }
+
+    if (needToModifyTokens) {
+        const char* tokenBegin = tokens->TokensData.data();
+        for (auto& token : tokens->Tokens) {
+            token = TStringBuf(tokenBegin, token.size());
+            tokenBegin += token.size();
+        }
+    }
+}
+
 void NCB::TTokenizer::Save(IOutputStream *stream) const {
     WriteMagic(TokenizerMagic.data(), MagicSize, Alignment, stream);
     Guid.Save(stream);
@@ -4,6 +4,9 @@
 
 #include <library/cpp/text_processing/tokenizer/tokenizer.h>
 
+#include <util/generic/array_ref.h>
+#include <util/system/yassert.h>
+
 namespace NCB {
 
     struct TTokensWithBuffer {
@@ -11,6 +14,40 @@ namespace NCB {
         TVector<TString> Data;
     };
 
+    /* Tokens of a block of documents in flat buffers that are reused between blocks.
+     * Tokens point into the source texts or into TokensData if the tokenizer modifies tokens,
+     * so source texts must outlive the block.
+     */
+    class TTokenizedTextBlock {
+    public:
+        void Clear() {
+            Tokens.clear();
+            DocOffsets.clear();
+            TokensData.clear();
+        }
+
+        ui32 GetDocCount() const {
+            return DocOffsets.empty() ? 0 : DocOffsets.size() - 1;
+        }
+
+        TConstArrayRef<TStringBuf> GetTokens(ui32 docIdx) const {
+            Y_ASSERT(docIdx + 1 < DocOffsets.size());
+            return TConstArrayRef<TStringBuf>(
+                Tokens.data() + DocOffsets[docIdx],
+                Tokens.data() + DocOffsets[docIdx + 1]
+            );
+        }
+
+    private:
+        TVector<TStringBuf> Tokens; // tokens of all documents
+        TVector<ui32> DocOffsets; // [docIdx] -> offset in Tokens, docCount + 1 elements
+        TVector<char> TokensData;
+
+        TTokensWithBuffer DocTokens; // scratch for one document
+
+        friend class TTokenizer;
+    };
+
     class TTokenizer : public TThrRefBase {
     public:
         TTokenizer() = default;
@@ -19,6 +56,7 @@ namespace NCB {
         TGuid Id() const;
         NTextProcessing::NTokenizer::TTokenizerOptions Options() const;
         void Tokenize(TStringBuf inputString, TTokensWithBuffer* tokens);
+        void TokenizeBlock(TConstArrayRef<TStringBuf> inputStrings, TTokenizedTextBlock* tokens);
 
         void Save(IOutputStream* stream) const;
         void Load(IInputStream* stream);
@@ -32,6 +32,29 @@ Y_UNIT_TEST_SUITE(TestTextDataset) {
         UNIT_ASSERT_VALUES_EQUAL(tokens.View[1], "a");
     }
 
+    Y_UNIT_TEST(TestTokenizeBlock) {
+        TVector<TStringBuf> texts = {"Hi", "", "ha HA ha", "   ", "Ho ho hO ho"};
+
+        NTextProcessing::NTokenizer::TTokenizerOptions lowercasingOptions;
+        lowercasingOptions.Lowercasing = true;
+
+        for (const auto& blockTokenizer : {tokenizer, CreateTokenizer(lowercasingOptions)}) {
+            TTokenizedTextBlock block;
+            blockTokenizer->TokenizeBlock(texts, &block);
+            UNIT_ASSERT_VALUES_EQUAL(block.GetDocCount(), texts.size());
+
+            TTokensWithBuffer tokens;
+            for (ui32 docIdx : xrange(texts.size())) {
+                blockTokenizer->Tokenize(texts[docIdx], &tokens);
+                const auto blockTokens = block.GetTokens(docIdx);
+                UNIT_ASSERT_VALUES_EQUAL(blockTokens.size(), tokens.View.size());
+                for (ui32 tokenIdx : xrange(blockTokens.size())) {
+                    UNIT_ASSERT_VALUES_EQUAL(blockTokens[tokenIdx], tokens.View[tokenIdx]);
+                }
+            }
+        }
+    }
+
     Y_UNIT_TEST(TestTextDatasetBuilder) {
         TVector<TString> text = {
             "hi",
@@ -6908,7 +6908,8 @@ def do_test_object_importances(pool, loss_function, additional_train_params):
     )
     yatest.common.execute(cmd)
 
-    return [local_canonical_file(object_importances_path)]
+    # importances are sums over trees and objects, their last digits depend on the summation order
+    return [local_canonical_file(object_importances_path, diff_tool=get_limited_precision_dsv_diff_tool(1e-9, False))]
 
 
 @pytest.mark.parametrize('loss_function', ['RMSE', 'Logloss', 'Poisson'])
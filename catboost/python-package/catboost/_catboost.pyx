@@ -947,6 +947,11 @@ cdef extern from "catboost/libs/fstr/partial_dependence.h":
         int threadCount
     ) except +ProcessException nogil
 
+    cdef TVector[ui32] GetPartialDependenceGridShape(
+        const TFullModel& model,
+        TVector[int] features
+    ) except +ProcessException nogil
+
 cdef extern from "catboost/libs/fstr/calc_fstr.h":
     cdef TVector[TVector[double]] GetFeatureImportances(
         const EFstrType type,
@@ -5708,6 +5713,13 @@ cdef class _CatBoost:
         )
         return _vector_of_double_to_np_array(fstr)
 
+    cpdef _get_partial_dependence_grid_shape(self, features):
+        cdef TVector[ui32] shape = GetPartialDependenceGridShape(
+            dereference(self.__model),
+            py_to_tvector[int](features)
+        )
+        return [size for size in shape]
+
     cpdef _calc_fstr(self, type_name, _PoolBase pool, _PoolBase reference_data, int thread_count, int verbose,
                      model_output_name, shap_mode_name, interaction_indices, shap_calc_type, int sage_n_samples,
                      int sage_batch_size, bool_t sage_detect_convergence):
@@ -18,9 +18,15 @@ cdef extern from "catboost/python-package/catboost/monoforest_helpers.h" namespa
 
 
 cdef extern from "catboost/python-package/catboost/monoforest_helpers.h" namespace "NMonoForest":
-    TString ConvertFullModelToPolynomString(const TFullModel& fullModel) except +ProcessException
-    TVector[THumanReadableMonom] ConvertFullModelToPolynom(const TFullModel& fullModel) except +ProcessException
-    TVector[TFeatureExplanation] ExplainFeatures(const TFullModel& fullModel) except +ProcessException
+    TString ConvertFullModelToPolynomString(const TFullModel& fullModel, int threadCount) except +ProcessException
+    TVector[THumanReadableMonom] ConvertFullModelToPolynom(const TFullModel& fullModel, int threadCount) except +ProcessException
+    TVector[TFeatureExplanation] ExplainFeatures(const TFullModel& fullModel, int threadCount) except +ProcessException
+    TVector[double] CalcPolynom(
+        const TFullModel& fullModel,
+        TConstArrayRef[float] features,
+        size_t featureCount,
+        int threadCount
+    ) except +ProcessException nogil
 
 
 class Split:
@@ -109,8 +115,11 @@ class FeatureExplanation:
         return borders, values
 
 
-cpdef to_polynom(model):
-    cdef TVector[THumanReadableMonom] monoms = ConvertFullModelToPolynom(dereference((<_CatBoost>model).__model))
+cpdef to_polynom(model, thread_count=-1):
+    cdef TVector[THumanReadableMonom] monoms = ConvertFullModelToPolynom(
+        dereference((<_CatBoost>model).__model),
+        UpdateThreadCount(thread_count)
+    )
     python_monoms = []
     for monom in monoms:
         python_splits = []
@@ -124,12 +133,18 @@ cpdef to_polynom(model):
     return python_monoms
 
 
-cpdef to_polynom_string(model):
-    return to_str(ConvertFullModelToPolynomString(dereference((<_CatBoost>model).__model)))
+cpdef to_polynom_string(model, thread_count=-1):
+    return to_str(ConvertFullModelToPolynomString(
+        dereference((<_CatBoost>model).__model),
+        UpdateThreadCount(thread_count)
+    ))
 
 
-cpdef explain_features(model):
-    cdef TVector[TFeatureExplanation] featuresExplanations = ExplainFeatures(dereference((<_CatBoost>model).__model))
+cpdef explain_features(model, thread_count=-1):
+    cdef TVector[TFeatureExplanation] featuresExplanations = ExplainFeatures(
+        dereference((<_CatBoost>model).__model),
+        UpdateThreadCount(thread_count)
+    )
     result = []
     for featureExpl in featuresExplanations:
         borders = []
@@ -148,3 +163,22 @@ cpdef explain_features(model):
                 array_ref_to_py(<TConstArrayRef[double]>featureExpl.ExpectedBias), borders)
         )
     return result
+
+
+cpdef calc_polynom(model, features, thread_count=-1):
+    cdef np.float32_t[:, ::1] features_view = np.ascontiguousarray(features, dtype=np.float32)
+    cdef size_t doc_count = features_view.shape[0]
+    cdef size_t feature_count = features_view.shape[1]
+    cdef TVector[double] result
+    if doc_count == 0:
+        return np.empty(0, dtype=_npfloat64)
+    result = CalcPolynom(
+        dereference((<_CatBoost>model).__model),
+        TConstArrayRef[float](&features_view[0, 0], doc_count * feature_count),
+        feature_count,
+        UpdateThreadCount(thread_count)
+    )
+    values = _vector_of_double_to_np_array(result)
+    if result.size() == doc_count:
+        return values
+    return values.reshape(doc_count, result.size() // doc_count)
@@ -4010,17 +4010,20 @@ class CatBoost(_CatBoostBase):
         To use this function, you should install plotly.
         data: numpy.ndarray or pandas.DataFrame or polars.DataFrame or catboost.Pool
         features: int, str, list<int>, tuple<int>, list<string>, tuple<string>
-            Float features to calculate partial dependence for. Number of features should be 1 or 2.
+            Float features or categorical features with one-hot splits to calculate partial dependence for.
+            Predictions can be plotted only for 1 or 2 features.
         plot: bool
-            Plot predictions.
+            Plot predictions. Ignored for more than 2 features.
         plot_file: str
-            Output file for plot predictions.
+            Output file for plot predictions. Can be set only for 1 or 2 features.
         thread_count: int
             Number of threads to use. If -1 use maximum available number of threads.
         Returns
         -------
             If number of features is one - 1d numpy array and figure with line plot.
             If number of features is two - 2d numpy array and figure with 2d heatmap.
+            Otherwise - numpy array with a dimension for each feature and None.
+            Buckets of a categorical feature are its one-hot values and the last one for all other values.
         """
 
         try:
@@ -4036,8 +4039,8 @@ class CatBoost(_CatBoostBase):
                 feature_idx = self.feature_names_.index(feature)
             else:
                 feature_idx = feature
-            assert feature_idx in self._get_borders(), "only float features indexes are supported"
-            assert len(self._get_borders()[feature_idx]) > 0, "feature with idx {} is not used in model".format(feature_idx)
+            if feature_idx in self._get_borders():
+                assert len(self._get_borders()[feature_idx]) > 0, "feature with idx {} is not used in model".format(feature_idx)
             return feature_idx
 
         def getFeatureIndices(features):
@@ -4049,20 +4052,24 @@ class CatBoost(_CatBoostBase):
                 raise CatBoostError('Unsupported type for argument \'features\'. Must be one of: int, string, list<string>, list<int>, tuple<int>, tuple<string>')
             return features_idxs
 
-        def getAxisParams(borders, feature_name=None):
+        def getAxisParams(borders, bucket_count, feature_name=None):
+            if borders is None:
+                ticktext = ['value #{}'.format(idx) for idx in range(bucket_count - 1)] + ['other']
+            else:
+                ticktext = (['(-inf, {:.4f}]'.format(borders[0])] +
+                            ['({:.4f}, {:.4f}]'.format(val_1, val_2)
+                             for val_1, val_2 in zip(borders[:-1], borders[1:])] +
+                            ['({:.4f}, +inf)'.format(borders[-1])])
             return {
                 'title': 'Bins' if feature_name is None else 'Bins of feature \'{}\''.format(feature_name),
                 'tickmode': 'array',
-                'tickvals': list(range(len(borders) + 1)),
-                'ticktext': ['(-inf, {:.4f}]'.format(borders[0])] +
-                            ['({:.4f}, {:.4f}]'.format(val_1, val_2)
-                             for val_1, val_2 in zip(borders[:-1], borders[1:])] +
-                            ['({:.4f}, +inf)'.format(borders[-1])],
+                'tickvals': list(range(bucket_count)),
+                'ticktext': ticktext,
                 'showticklabels': False}
 
         def plot2d(feature_names, borders, predictions):
-            xaxis = go.layout.XAxis(**getAxisParams(borders[1], feature_name=feature_names[1]))
-            yaxis = go.layout.YAxis(**getAxisParams(borders[0], feature_name=feature_names[0]))
+            xaxis = go.layout.XAxis(**getAxisParams(borders[1], predictions.shape[1], feature_name=feature_names[1]))
+            yaxis = go.layout.YAxis(**getAxisParams(borders[0], predictions.shape[0], feature_name=feature_names[0]))
             layout = go.Layout(
                 title='Partial dependence plot for features {}'.format('\'{}\''.format('\', \''.join(map(str, feature_names)))),
                 yaxis=yaxis,
@@ -4072,7 +4079,7 @@ class CatBoost(_CatBoostBase):
             return fig
 
         def plot1d(feature, borders, predictions):
-            xaxis = go.layout.XAxis(**getAxisParams(borders))
+            xaxis = go.layout.XAxis(**getAxisParams(borders, len(predictions)))
             yaxis = {
                 'title': 'Mean Prediction',
                 'side': 'left'
@@ -4086,21 +4093,25 @@ class CatBoost(_CatBoostBase):
             return fig
 
         features_idx = getFeatureIndices(features)
-        borders = [self._get_borders()[idx] for idx in features_idx]
-        if len(features_idx) not in [1, 2]:
-            raise CatBoostError('Number of \'features\' should be 1 or 2, got {}'.format(len(features_idx)))
-        is_2d_plot = len(features_idx) == 2
+        borders = [self._get_borders().get(idx) for idx in features_idx]
+        if len(features_idx) == 0:
+            raise CatBoostError('No \'features\' to calculate partial dependence for')
+        if len(features_idx) > 2 and plot_file:
+            raise CatBoostError('Number of \'features\' to plot should be 1 or 2, got {}'.format(len(features_idx)))
+        grid_shape = self._object._get_partial_dependence_grid_shape(features_idx)
 
         data, _ = self._process_predict_input_data(data, "plot_partial_dependence", thread_count=thread_count)
         all_predictions = np.array(self._object._calc_partial_dependence(data, features_idx, thread_count))
 
-        if is_2d_plot:
-            all_predictions = all_predictions.reshape([len(x) + 1 for x in borders])
-            fig = plot2d(features_idx, borders,  all_predictions)
-        else:
+        fig = None
+        if len(features_idx) == 1:
             fig = plot1d(features_idx[0], borders[0], all_predictions)
+        else:
+            all_predictions = all_predictions.reshape(grid_shape)
+            if len(features_idx) == 2:
+                fig = plot2d(features_idx, borders, all_predictions)
 
-        if plot:
+        if plot and fig is not None:
             try_plot_offline(fig)
 
         if plot_file:
@@ -5132,6 +5143,9 @@ class CatBoostClassifier(CatBoost):
         Possible values:
             - 'Default' - Compute final ctrs for all datasets.
             - 'Skip' - Skip final ctr computation. WARNING: model without ctrs can't be applied.
+    compact_ctr_tables : bool, [default=False]
+        Store counters of final ctr tables in 1 or 2 bytes where they fit.
+        Predictions don't change, but older versions of CatBoost refuse to load the model.
     approx_on_full_history : bool, [default=False]
         If this flag is set to True, each approximated value is calculated using all the preceeding rows in the fold (slower, more accurate).
         If this flag is set to False, each approximated value is calculated using only the beginning 1/fold_len_multiplier fraction of the fold (faster, slightly less accurate).
@@ -5479,7 +5493,8 @@ class CatBoostClassifier(CatBoost):
         embedding_features=None,
         callback=None,
         eval_fraction=None,
-        fixed_binary_splits=None
+        fixed_binary_splits=None,
+        compact_ctr_tables=None
     ):
         params = {}
         not_params = ["not_params", "self", "params", "__class__"]
@@ -6114,7 +6129,8 @@ class CatBoostRegressor(CatBoost):
         text_processing=None,
         embedding_features=None,
         eval_fraction=None,
-        fixed_binary_splits=None
+        fixed_binary_splits=None,
+        compact_ctr_tables=None
     ):
         params = {}
         not_params = ["not_params", "self", "params", "__class__"]
@@ -6525,7 +6541,8 @@ class CatBoostRanker(CatBoost):
         text_processing=None,
         embedding_features=None,
         eval_fraction=None,
-        fixed_binary_splits=None
+        fixed_binary_splits=None,
+        compact_ctr_tables=None
     ):
         params = {}
         not_params = ["not_params", "self", "params", "__class__"]
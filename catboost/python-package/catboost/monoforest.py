@@ -1,5 +1,7 @@
 import math
 
+import numpy as np
+
 from . import _catboost
 from .core import CatBoost, CatBoostError
 
@@ -13,19 +15,33 @@ def _check_model(model):
         raise CatBoostError("Model should be CatBoost")
 
 
-def to_polynom(model):
+def to_polynom(model, thread_count=-1):
+    _check_model(model)
+    return _catboost.to_polynom(model._object, thread_count)
+
+
+def to_polynom_string(model, thread_count=-1):
     _check_model(model)
-    return _catboost.to_polynom(model._object)
+    return _catboost.to_polynom_string(model._object, thread_count)
 
 
-def to_polynom_string(model):
+def explain_features(model, thread_count=-1):
     _check_model(model)
-    return _catboost.to_polynom_string(model._object)
+    return _catboost.explain_features(model._object, thread_count)
 
 
-def explain_features(model):
+def calc_polynom(model, data, thread_count=-1):
+    """
+    Calculate raw predictions of the polynom equivalent to the model.
+    data is a 2d array of numeric feature values indexed by flat feature index,
+    models with categorical features are not supported.
+    The result has shape (docs,) for single-dimensional models and (docs, dimension) otherwise.
+    """
     _check_model(model)
-    return _catboost.explain_features(model._object)
+    data = np.asarray(data, dtype=np.float32)
+    if data.ndim != 2:
+        raise CatBoostError("data should be a 2d array of feature values")
+    return _catboost.calc_polynom(model._object, data, thread_count)
 
 
 def calc_features_strength(model):
@@ -4,19 +4,22 @@
 #include <catboost/libs/monoforest/interpretation.h>
 #include <catboost/libs/monoforest/model_import.h>
 #include <catboost/libs/monoforest/polynom.h>
+#include <catboost/libs/monoforest/polynom_evaluator.h>
+
+#include <util/generic/xrange.h>
 
 namespace NMonoForest {
-    static TPolynom BuildPolynom(const TAdditiveModel<TObliviousTree>& additiveModel) {
+    static TPolynom BuildPolynom(const TAdditiveModel<TObliviousTree>& additiveModel, int threadCount) {
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(threadCount - 1);
         TPolynomBuilder polynomBuilder;
-        for (auto idx : xrange(additiveModel.Size())) {
-            polynomBuilder.AddTree(additiveModel.GetWeakModel(idx));
-        }
+        polynomBuilder.AddTrees(additiveModel, &executor);
         return polynomBuilder.Build();
     }
 
-    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel) {
+    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel, int threadCount) {
         const auto importer = MakeCatBoostImporter(fullModel);
-        const TPolynom polynom = BuildPolynom(importer->GetModel());
+        const TPolynom polynom = BuildPolynom(importer->GetModel(), threadCount);
         TVector<THumanReadableMonom> monoms;
         monoms.reserve(polynom.MonomsEnsemble.size());
         const IGrid& grid = importer->GetGrid();
@@ -36,15 +39,50 @@ namespace NMonoForest {
         return monoms;
     }
 
-    TString ConvertFullModelToPolynomString(const TFullModel& fullModel) {
+    TString ConvertFullModelToPolynomString(const TFullModel& fullModel, int threadCount) {
         const auto importer = MakeCatBoostImporter(fullModel);
-        const TPolynom polynom = BuildPolynom(importer->GetModel());
+        const TPolynom polynom = BuildPolynom(importer->GetModel(), threadCount);
         return ToHumanReadableString(polynom, importer->GetGrid());
     }
 
-    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel) {
+    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel, int threadCount) {
         const auto importer = MakeCatBoostImporter(fullModel);
-        const TPolynom polynom = BuildPolynom(importer->GetModel());
+        const TPolynom polynom = BuildPolynom(importer->GetModel(), threadCount);
         return ExplainFeatures(polynom, importer->GetGrid());
     }
+
+    TVector<double> CalcPolynom(
+        const TFullModel& fullModel,
+        TConstArrayRef<float> features,
+        size_t featureCount,
+        int threadCount)
+    {
+        CB_ENSURE(featureCount > 0 && features.size() % featureCount == 0, "Features size is not a multiple of features count");
+        const auto importer = MakeCatBoostImporter(fullModel);
+        const IGrid& grid = importer->GetGrid();
+        const size_t docCount = features.size() / featureCount;
+        TVector<TVector<ui32>> featureBins(grid.FeatureCount());
+        TVector<float> featureValues;
+        featureValues.yresize(docCount);
+        for (auto featureIdx : xrange(grid.FeatureCount())) {
+            CB_ENSURE(
+                grid.FeatureType(featureIdx) == EFeatureType::Float,
+                "Polynom calculation is supported only for models with float features"
+            );
+            const size_t flatFeatureIdx = grid.ExternalFlatFeatureIndex(featureIdx);
+            CB_ENSURE(flatFeatureIdx < featureCount, "No values for feature " << flatFeatureIdx);
+            for (auto docIdx : xrange(docCount)) {
+                featureValues[docIdx] = features[docIdx * featureCount + flatFeatureIdx];
+            }
+            featureBins[featureIdx] = BinarizeFeature(grid, featureIdx, featureValues);
+        }
+        const TVector<TConstArrayRef<ui32>> featureBinsRef(featureBins.begin(), featureBins.end());
+
+        const TPolynomEvaluator evaluator(BuildPolynom(importer->GetModel(), threadCount));
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(threadCount - 1);
+        TVector<double> result(docCount * fullModel.GetDimensionsCount());
+        evaluator.Calc(featureBinsRef, result, &executor);
+        return result;
+    }
 }
@@ -22,7 +22,14 @@ namespace NMonoForest {
     // to manage with weak support of namespaces in Cython
     using EMonoForestFeatureType = EFeatureType;
 
-    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel);
-    TString ConvertFullModelToPolynomString(const TFullModel& fullModel);
-    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel);
+    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel, int threadCount = 1);
+    TString ConvertFullModelToPolynomString(const TFullModel& fullModel, int threadCount = 1);
+    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel, int threadCount = 1);
+
+    // features is [docIdx * featureCount + flatFeatureIdx], result is [docIdx * dimension + dim]
+    TVector<double> CalcPolynom(
+        const TFullModel& fullModel,
+        TConstArrayRef<float> features,
+        size_t featureCount,
+        int threadCount = 1);
 }
@@ -5175,7 +5175,8 @@ def test_object_importances(task_type):
     oimp_path = test_output_path(OIMP_PATH)
     np.savetxt(oimp_path, scores)
 
-    return local_canonical_file(oimp_path)
+    # importances are sums over trees and objects, their last digits depend on the summation order
+    return local_canonical_file(oimp_path, diff_tool=get_limited_precision_dsv_diff_tool(1e-9, False))
 
 
 def test_positive_object_importance_per_object():
@@ -9711,6 +9712,18 @@ def test_monoforest_regression():
     assert plot, "Unexpected empty plot"
 
 
+def test_monoforest_calc_polynom():
+    prng = np.random.RandomState(seed=20240705)
+    data = np.round(prng.normal(size=(1000, 5)), decimals=3).astype(np.float32)
+    label = data[:, 0] * data[:, 1] - data[:, 2] + prng.normal(scale=0.1, size=1000)
+    model = CatBoostRegressor(loss_function='RMSE', iterations=20, depth=4, thread_count=4)
+    model.fit(data, label)
+    from catboost.monoforest import calc_polynom
+    values = calc_polynom(model, data)
+    assert values.shape == (1000,)
+    assert np.allclose(values, model.predict(data, prediction_type='RawFormulaVal'))
+
+
 def test_text_processing_tokenizer():
     from catboost.text_processing import Tokenizer
     assert Tokenizer(lowercasing=True).tokenize('Aba caba') == ['aba', 'caba']
@@ -10413,6 +10426,19 @@ def test_partial_dependence(features):
     return local_canonical_file(fimp_txt_path)
 
 
+def test_partial_dependence_of_three_features():
+    pool_file = 'higgs'
+    pool = Pool(data_file(pool_file, 'train_small'), column_description=data_file(pool_file, 'train.cd'))
+    model = CatBoostClassifier(iterations=100, border_count=8, devices='0')
+    model.fit(pool)
+    # there is no plot for more than 2 features, the grid is returned even with plot enabled
+    predictions, fig = model.plot_partial_dependence(pool, [5, 7, 8])
+    assert fig is None
+    assert predictions.shape == tuple(len(model.get_borders()[idx]) + 1 for idx in [5, 7, 8])
+    with pytest.raises(CatBoostError):
+        model.plot_partial_dependence(pool, [5, 7, 8], plot=False, plot_file=test_output_path('pd.html'))
+
+
 @pytest.mark.parametrize('grow_policy', ['SymmetricTree', 'Depthwise', 'Lossguide'])
 def test_per_object_feature_penalties_work(grow_policy):
     pool = Pool(AIRLINES_5K_TRAIN_FILE, column_description=AIRLINES_5K_CD_FILE, has_header=True)